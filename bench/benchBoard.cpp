@@ -0,0 +1,356 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "BoardServer.h"
+#include "ChessBoardImpl.h"
+#include "ChessManImpl.h"
+#include "GameRules.h"
+#include "PartitionedChessBoard.h"
+#include "RemoteChessBoard.h"
+
+using namespace board;
+
+namespace {
+
+// Counts board events per figure slot, producers spin until their answer arrives
+class EventCounter : public INotifier
+{
+public:
+    void placed(std::uint32_t id, const Coordinate &) noexcept override { signal(id); }
+    void moved(std::uint32_t id, const Coordinate &, const Coordinate &) noexcept override { signal(id); }
+    void cancelMoved(std::uint32_t id, const Coordinate &, const Coordinate &) noexcept override { signal(id); }
+    void removed(std::uint32_t id, const Coordinate &) noexcept override { signal(id); }
+    void waitingForCell(std::uint32_t id, const Coordinate &, const Coordinate &) noexcept override { signal(id); }
+    void reject(std::uint32_t id, ReasonReject) noexcept override { signal(id); }
+
+    std::uint64_t events(std::uint32_t id) const
+    {
+        return mEvents[id % sSlots].load(std::memory_order_acquire);
+    }
+
+    void waitFor(std::uint32_t id, std::uint64_t count) const
+    {
+        while (events(id) < count)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    void signal(std::uint32_t id)
+    {
+        mEvents[id % sSlots].fetch_add(1, std::memory_order_release);
+    }
+
+    static constexpr std::size_t sSlots = 4096;
+    std::array<std::atomic<std::uint64_t>, sSlots> mEvents{};
+};
+
+class NullNotifier : public INotifier
+{
+public:
+    void placed(std::uint32_t, const Coordinate &) noexcept override {}
+    void moved(std::uint32_t, const Coordinate &, const Coordinate &) noexcept override {}
+    void cancelMoved(std::uint32_t, const Coordinate &, const Coordinate &) noexcept override {}
+    void removed(std::uint32_t, const Coordinate &) noexcept override {}
+    void waitingForCell(std::uint32_t, const Coordinate &, const Coordinate &) noexcept override {}
+    void reject(std::uint32_t, ReasonReject) noexcept override {}
+};
+
+struct BenchBoard
+{
+    explicit BenchBoard(bool blockingSliders = false)
+        : mBoard(std::make_shared<ChessBoardImpl>(GameRules::sizeBoard(), blockingSliders))
+        , mCounter(std::make_shared<EventCounter>())
+    {
+        mBoard->startGame();
+        mBoard->addNotifier(mCounter);
+    }
+
+    ~BenchBoard()
+    {
+        mBoard->stopGame();
+    }
+
+    // submits through `submit` and waits for the single answer addressed to the figure
+    template<typename Submit>
+    void roundTrip(const chessman::IChessMan &figure, Submit &&submit)
+    {
+        auto expected = mCounter->events(figure.getID()) + 1;
+        submit();
+        mCounter->waitFor(figure.getID(), expected);
+    }
+
+    std::shared_ptr<ChessBoardImpl> mBoard;
+    std::shared_ptr<EventCounter> mCounter;
+};
+
+BenchBoard &sharedBoard()
+{
+    static BenchBoard board;
+    return board;
+}
+
+}
+
+// place -> move -> remove round trips, every producer owns one row of the board
+static void BM_BoardPlaceMoveRemove(benchmark::State &state)
+{
+    auto &bench = sharedBoard();
+    auto row = static_cast<Coordinate::first_type>(state.thread_index());
+    ChessManImpl figure(GameRules::generateId(), chessman::ChessmanType::rook);
+
+    for (auto _: state)
+    {
+        bench.roundTrip(figure, [&]() { bench.mBoard->placeFigure(figure, {row, 0}); });
+        figure.setCurrentCoordinate({row, 0});
+        bench.roundTrip(figure, [&]() { bench.mBoard->moveFigure(figure, {row, 1}); });
+        figure.setCurrentCoordinate({row, 1});
+        bench.roundTrip(figure, [&]() { bench.mBoard->removeFigure(figure); });
+        figure.setCurrentCoordinate(invalidCoordinate);
+    }
+    state.SetItemsProcessed(state.iterations() * 3);
+}
+BENCHMARK(BM_BoardPlaceMoveRemove)->ThreadRange(1, GameRules::sizeBoard())->UseRealTime();
+
+// a misbehaving client: moves from and places onto cells outside the board, all rejected
+static void BM_BoardInvalidCoordinate(benchmark::State &state)
+{
+    BenchBoard bench;
+    ChessManImpl figure(GameRules::generateId(), chessman::ChessmanType::rook);
+    auto outside = static_cast<Coordinate::first_type>(GameRules::sizeBoard());
+    figure.setCurrentCoordinate({outside, 0});
+
+    for (auto _: state)
+    {
+        bench.roundTrip(figure, [&]() { bench.mBoard->moveFigure(figure, {0, outside}); });
+        bench.roundTrip(figure, [&]() { bench.mBoard->placeFigure(figure, {outside, outside}); });
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_BoardInvalidCoordinate)->UseRealTime();
+
+// a queen moving back and forth along a half-filled row, range(0) enables the path check
+static void BM_BoardMoveBlocking(benchmark::State &state)
+{
+    BenchBoard bench(state.range(0));
+    std::vector<std::unique_ptr<ChessManImpl>> others;
+    for (Coordinate::second_type y = 4; y < GameRules::sizeBoard(); ++y)
+    {
+        others.push_back(std::make_unique<ChessManImpl>(GameRules::generateId(), chessman::ChessmanType::rook));
+        bench.roundTrip(*others.back(), [&]() { bench.mBoard->placeFigure(*others.back(), {0, y}); });
+    }
+    ChessManImpl queen(GameRules::generateId(), chessman::ChessmanType::queen);
+    bench.roundTrip(queen, [&]() { bench.mBoard->placeFigure(queen, {0, 0}); });
+    queen.setCurrentCoordinate({0, 0});
+
+    for (auto _: state)
+    {
+        Coordinate to{0, static_cast<Coordinate::second_type>(3 - queen.getCurrentCoordinate().second)};
+        bench.roundTrip(queen, [&]() { bench.mBoard->moveFigure(queen, to); });
+        queen.setCurrentCoordinate(to);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoardMoveBlocking)->ArgName("blocking")->Arg(0)->Arg(1)->UseRealTime();
+
+// the occupant leaves a cell with `range(0)` waiters, do_check_waiting hands it to the first one
+static void BM_BoardCheckWaiting(benchmark::State &state)
+{
+    BenchBoard bench;
+    const Coordinate cell{3, 3};
+    std::vector<std::unique_ptr<ChessManImpl>> queue;
+    auto enqueue = [&]() {
+        queue.push_back(std::make_unique<ChessManImpl>(GameRules::generateId(), chessman::ChessmanType::rook));
+        auto &figure = *queue.back();
+        bench.roundTrip(figure, [&]() { bench.mBoard->placeFigure(figure, cell); });
+    };
+
+    for (auto i = 0; i <= state.range(0); ++i)
+    {
+        enqueue();
+    }
+    queue.front()->setCurrentCoordinate(cell);
+
+    for (auto _: state)
+    {
+        auto occupant = std::move(queue.front());
+        queue.erase(queue.begin());
+        auto &next = *queue.front();
+        auto expected = bench.mCounter->events(next.getID()) + 1;
+        bench.mBoard->removeFigure(*occupant);
+        bench.mCounter->waitFor(next.getID(), expected);
+        next.setCurrentCoordinate(cell);
+
+        state.PauseTiming();
+        enqueue();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoardCheckWaiting)->RangeMultiplier(8)->Range(1, 512)->UseRealTime();
+
+// do_cancel_move scans a waiting list of `range(0)` pending placements to find the mover at its end
+static void BM_BoardCancelWaiting(benchmark::State &state)
+{
+    BenchBoard bench;
+    const Coordinate cell{0, 0}, from{0, 1};
+    std::vector<std::unique_ptr<ChessManImpl>> figures;
+    for (auto i = 0; i <= state.range(0); ++i)
+    {   // the first one occupies the cell, the others queue for it
+        figures.push_back(std::make_unique<ChessManImpl>(GameRules::generateId(), chessman::ChessmanType::rook));
+        auto &figure = *figures.back();
+        bench.roundTrip(figure, [&]() { bench.mBoard->placeFigure(figure, cell); });
+    }
+    ChessManImpl mover(GameRules::generateId(), chessman::ChessmanType::rook);
+    bench.roundTrip(mover, [&]() { bench.mBoard->placeFigure(mover, from); });
+    mover.setCurrentCoordinate(from);
+    bench.roundTrip(mover, [&]() { bench.mBoard->moveFigure(mover, cell); });
+
+    for (auto _: state)
+    {
+        bench.roundTrip(mover, [&]() { bench.mBoard->cancelMoveFigure(mover, cell); });
+
+        state.PauseTiming();
+        bench.roundTrip(mover, [&]() { bench.mBoard->moveFigure(mover, cell); });
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoardCancelWaiting)->RangeMultiplier(8)->Range(1, 512)->UseRealTime();
+
+// place + remove while `range(0)` notifiers listen to the board
+static void BM_BoardNotifyFanout(benchmark::State &state)
+{
+    BenchBoard bench;
+    std::vector<std::shared_ptr<NullNotifier>> notifiers;
+    for (auto i = 1; i < state.range(0); ++i)
+    {
+        notifiers.push_back(std::make_shared<NullNotifier>());
+        bench.mBoard->addNotifier(notifiers.back());
+    }
+    ChessManImpl figure(GameRules::generateId(), chessman::ChessmanType::rook);
+
+    for (auto _: state)
+    {
+        bench.roundTrip(figure, [&]() { bench.mBoard->placeFigure(figure, {0, 0}); });
+        figure.setCurrentCoordinate({0, 0});
+        bench.roundTrip(figure, [&]() { bench.mBoard->removeFigure(figure); });
+        figure.setCurrentCoordinate(invalidCoordinate);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+    state.counters["notifiers"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_BoardNotifyFanout)->RangeMultiplier(4)->Range(1, 256)->UseRealTime();
+
+// moves over a Unix-domain socket with up to `range(0)` of them in flight
+static void BM_RemoteBoardPipeline(benchmark::State &state)
+{
+    BenchBoard bench;
+    auto server = std::make_shared<BoardServer>("/tmp/chess_bench_" + std::to_string(::getpid()) + ".sock",
+                                                bench.mBoard);
+    server->startGame();
+    {
+        RemoteChessBoard remote(server->path());
+        auto counter = std::make_shared<EventCounter>();
+        remote.addNotifier(counter);
+        ChessManImpl figure(GameRules::generateId(), chessman::ChessmanType::rook);
+        auto id = figure.getID();
+        auto window = static_cast<std::uint64_t>(state.range(0));
+        remote.placeFigure(figure, {0, 0});
+        figure.setCurrentCoordinate({0, 0});
+        std::uint64_t sent = 1;
+
+        for (auto _: state)
+        {
+            Coordinate to{0, static_cast<Coordinate::second_type>(figure.getCurrentCoordinate().second ? 0 : 1)};
+            remote.moveFigure(figure, to);
+            figure.setCurrentCoordinate(to);
+            if (++sent - counter->events(id) >= window)
+            {
+                counter->waitFor(id, sent + 1 - window);
+            }
+        }
+        counter->waitFor(id, sent);
+        state.SetItemsProcessed(state.iterations());
+        state.counters["window"] = static_cast<double>(window);
+    }
+    server->stopGame();
+}
+BENCHMARK(BM_RemoteBoardPipeline)->RangeMultiplier(16)->Range(1, 4096)->UseRealTime();
+
+// 32 figures on a 16x16 board served by range(0) partitions, every figure with one move in
+// flight; with range(1) every move crosses to another partition and takes the hand-off
+static void BM_PartitionedBoard(benchmark::State &state)
+{
+    static constexpr std::uint8_t sizeBoard = 16;
+    static constexpr std::size_t countFigures = 32;
+    auto partitions = static_cast<std::uint8_t>(state.range(0));
+    auto paths = board::partitionPaths("/tmp/chess_bench_" + std::to_string(::getpid()), partitions);
+    std::vector<std::shared_ptr<ChessBoardImpl>> boards;
+    std::vector<std::shared_ptr<BoardServer>> servers;
+    for (std::uint8_t partition = 0; partition < partitions; ++partition)
+    {
+        boards.push_back(std::make_shared<ChessBoardImpl>(sizeBoard));
+        servers.push_back(std::make_shared<BoardServer>(paths, partition, boards.back()));
+    }
+    for (std::size_t partition = 0; partition < partitions; ++partition)
+    {
+        boards[partition]->startGame();
+        servers[partition]->startGame();
+    }
+    {
+        PartitionedChessBoard client(paths);
+        auto counter = std::make_shared<EventCounter>();
+        client.addNotifier(counter);
+        std::vector<std::unique_ptr<ChessManImpl>> figures;
+        std::vector<std::pair<Coordinate, Coordinate>> cells; // home and away
+        std::vector<std::uint64_t> expected(countFigures, 1);
+        for (std::size_t i = 0; i < countFigures; ++i)
+        {
+            auto row = static_cast<Coordinate::first_type>(i % sizeBoard);
+            auto column = static_cast<Coordinate::second_type>(i / sizeBoard);
+            Coordinate home(row, column);
+            Coordinate away(static_cast<Coordinate::first_type>(state.range(1) ? (row + sizeBoard / 2) % sizeBoard : row),
+                            static_cast<Coordinate::second_type>(column + 2));
+            figures.push_back(std::make_unique<ChessManImpl>(GameRules::generateId(), chessman::ChessmanType::rook));
+            cells.emplace_back(home, away);
+            client.placeFigure(*figures.back(), home);
+            figures.back()->setCurrentCoordinate(home);
+        }
+        std::size_t next = 0;
+
+        for (auto _: state)
+        {
+            auto &figure = *figures[next];
+            counter->waitFor(figure.getID(), expected[next]);
+            auto to = figure.getCurrentCoordinate() == cells[next].first ? cells[next].second : cells[next].first;
+            client.moveFigure(figure, to);
+            figure.setCurrentCoordinate(to);
+            ++expected[next];
+            next = (next + 1) % countFigures;
+        }
+        for (std::size_t i = 0; i < countFigures; ++i)
+        {
+            counter->waitFor(figures[i]->getID(), expected[i]);
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+    for (auto &server: servers)
+    {
+        server->stopGame();
+    }
+    for (auto &board: boards)
+    {
+        board->stopGame();
+    }
+}
+BENCHMARK(BM_PartitionedBoard)->ArgNames({"partitions", "crossing"})->ArgsProduct({{1, 2, 4}, {0, 1}})->UseRealTime();
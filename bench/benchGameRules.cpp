@@ -0,0 +1,227 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "ChessManImpl.h"
+#include "FastRandom.h"
+#include "GameRules.h"
+#include "Occupancy.h"
+#include "SlidingAttacks.h"
+
+// the argument picks the RandomEngine
+static void useEngine(const benchmark::State &state)
+{
+    GameRules::Settings settings;
+    settings.mRandomEngine = static_cast<RandomEngine>(state.range(0));
+    GameRules::configure(settings);
+}
+
+static void engineArguments(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->ArgName("engine");
+    for (auto engine: {RandomEngine::mt19937, RandomEngine::xoshiro256, RandomEngine::pcg32})
+    {
+        benchmark->Arg(static_cast<int64_t>(engine));
+    }
+}
+
+static void BM_GenerateStep(benchmark::State &state)
+{
+    useEngine(state);
+    ChessManImpl figure(1, chessman::ChessmanType::rook);
+    figure.setCurrentCoordinate({3, 4});
+    for (auto _: state)
+    {
+        auto step = GameRules::generateStep(figure);
+        benchmark::DoNotOptimize(step);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenerateStep)->Apply(engineArguments);
+
+static void BM_GenerateFirstStep(benchmark::State &state)
+{
+    useEngine(state);
+    for (auto _: state)
+    {
+        auto step = GameRules::generateFirstStep();
+        benchmark::DoNotOptimize(step);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenerateFirstStep)->Apply(engineArguments);
+
+static void BM_GenerateDelay(benchmark::State &state)
+{
+    useEngine(state);
+    for (auto _: state)
+    {
+        auto delay = GameRules::generateDelayWaitNextStep();
+        benchmark::DoNotOptimize(delay);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenerateDelay)->Apply(engineArguments);
+
+static void BM_GenerateStepStd(benchmark::State &state)
+{   // the former implementation, for comparison
+    std::mt19937 generator(1);
+    board::Coordinate coordinate{3, 4};
+    for (auto _: state)
+    {
+        board::Coordinate result;
+        std::uniform_int_distribution direction(0, 1);
+        if (direction(generator))
+        {
+            std::uniform_int_distribution<> step(0 - coordinate.first, GameRules::sizeBoard() - 1 - coordinate.first);
+            int delta;
+            do {
+                delta = step(generator);
+            } while (!delta);
+            result = {static_cast<board::Coordinate::first_type>(coordinate.first + delta), coordinate.second};
+        } else {
+            std::uniform_int_distribution<> step(0 - coordinate.second, GameRules::sizeBoard() - 1 - coordinate.second);
+            int delta;
+            do {
+                delta = step(generator);
+            } while (!delta);
+            result = {coordinate.first, static_cast<board::Coordinate::second_type>(coordinate.second + delta)};
+        }
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenerateStepStd);
+
+static void pieceArguments(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->ArgName("piece");
+    for (auto type: {chessman::ChessmanType::rook, chessman::ChessmanType::bishop, chessman::ChessmanType::queen,
+                     chessman::ChessmanType::knight, chessman::ChessmanType::king})
+    {
+        benchmark->Arg(static_cast<int64_t>(type));
+    }
+}
+
+// validates every target from one square, half of them legal for a rook
+static void BM_CheckStep(benchmark::State &state)
+{
+    GameRules::configure({});
+    auto type = static_cast<chessman::ChessmanType>(state.range(0));
+    board::Coordinate from{3, 4};
+    for (auto _: state)
+    {
+        for (std::int8_t x = 0; x < 8; ++x)
+        {
+            for (std::int8_t y = 0; y < 8; ++y)
+            {
+                benchmark::DoNotOptimize(GameRules::checkStep(type, from, {x, y}));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_CheckStep)->Apply(pieceArguments);
+
+static void BM_CheckStepRookArithmetic(benchmark::State &state)
+{   // the former rook-only check, for comparison
+    board::Coordinate from{3, 4};
+    for (auto _: state)
+    {
+        for (std::int8_t x = 0; x < 8; ++x)
+        {
+            for (std::int8_t y = 0; y < 8; ++y)
+            {
+                board::Coordinate to{x, y};
+                benchmark::DoNotOptimize(from != to && to >= 0 && to <= GameRules::sizeBoard()
+                                         && (from.first == to.first || from.second == to.second));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_CheckStepRookArithmetic);
+
+static void BM_GenerateStepPiece(benchmark::State &state)
+{
+    GameRules::configure({});
+    ChessManImpl figure(1, static_cast<chessman::ChessmanType>(state.range(0)));
+    figure.setCurrentCoordinate({3, 4});
+    for (auto _: state)
+    {
+        auto step = GameRules::generateStep(figure);
+        benchmark::DoNotOptimize(step);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenerateStepPiece)->Apply(pieceArguments);
+
+// random rook paths on a quarter-filled board, range(0) is the size: up to 8 a magic bitboard, above line masks
+static void BM_PathClear(benchmark::State &state)
+{
+    auto size = static_cast<std::int32_t>(state.range(0));
+    Occupancy occupancy(size);
+    Xoshiro256 random(5);
+    for (std::int32_t i = 0; i < size * size / 4; ++i)
+    {
+        occupancy.set({static_cast<std::int8_t>(boundedRandom(random, size)), static_cast<std::int8_t>(boundedRandom(random, size))});
+    }
+    std::vector<std::pair<board::Coordinate, board::Coordinate>> paths(1024);
+    for (auto &[from, to]: paths)
+    {
+        from = {static_cast<std::int8_t>(boundedRandom(random, size)), static_cast<std::int8_t>(boundedRandom(random, size))};
+        to = {from.first, static_cast<std::int8_t>((from.second + 1 + boundedRandom(random, size - 1)) % size)};
+    }
+    std::size_t i = 0;
+    for (auto _: state)
+    {
+        auto &[from, to] = paths[i++ & 1023];
+        benchmark::DoNotOptimize(occupancy.pathClear(chessman::ChessmanType::rook, from, to));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PathClear)->ArgName("size")->Arg(8)->Arg(32)->Arg(127);
+
+static void BM_SlidingAttacks(benchmark::State &state)
+{   // range(0): 0 magic lookup, 1 ray walk
+    Xoshiro256 random(5);
+    std::vector<std::uint64_t> occupancies(1024);
+    for (auto &occupancy: occupancies)
+    {
+        occupancy = random() & random();
+    }
+    std::size_t i = 0;
+    for (auto _: state)
+    {
+        auto square = static_cast<std::int32_t>(i & 63);
+        auto occupancy = occupancies[i++ & 1023];
+        benchmark::DoNotOptimize(state.range(0) ? chessman::slowRookAttacks(square, occupancy)
+                                                : chessman::rookAttacks(square, occupancy));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SlidingAttacks)->ArgName("walk")->Arg(0)->Arg(1);
+
+static void BM_Destinations(benchmark::State &state)
+{   // a queen among a quarter of occupied cells, the list a participant would choose from
+    auto size = static_cast<std::int32_t>(state.range(0));
+    Occupancy occupancy(size);
+    Xoshiro256 random(5);
+    for (std::int32_t i = 0; i < size * size / 4; ++i)
+    {
+        occupancy.set({static_cast<std::int8_t>(boundedRandom(random, size)), static_cast<std::int8_t>(boundedRandom(random, size))});
+    }
+    std::vector<board::Coordinate> from(1024), destinations;
+    for (auto &coordinate: from)
+    {
+        coordinate = {static_cast<std::int8_t>(boundedRandom(random, size)), static_cast<std::int8_t>(boundedRandom(random, size))};
+    }
+    std::size_t i = 0;
+    for (auto _: state)
+    {
+        occupancy.destinations(chessman::ChessmanType::queen, from[i++ & 1023], true, destinations);
+        benchmark::DoNotOptimize(destinations.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Destinations)->ArgName("size")->Arg(8)->Arg(32)->Arg(127);
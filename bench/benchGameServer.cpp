@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "BatchSimulator.h"
+#include "ChessBoardImpl.h"
+#include "Game.h"
+#include "GameServer.h"
+
+static GameRules::Settings smallGameRules()
+{
+    GameRules::Settings rules;
+    rules.mDelayNextStepMin = std::chrono::milliseconds(0);
+    rules.mDelayNextStepMax = std::chrono::milliseconds(0);
+    rules.mDelayWaitForCell = std::chrono::milliseconds(2);
+    return rules;
+}
+
+// `range(0)` games of 4 participants and 20 steps hosted on `range(1)` executor threads
+static void BM_HostedGames(benchmark::State &state)
+{
+    auto games = static_cast<std::size_t>(state.range(0));
+    double moves = 0;
+    for (auto _: state)
+    {
+        GameServerSettings settings;
+        settings.mRules = smallGameRules();
+        settings.mThreads = static_cast<std::size_t>(state.range(1));
+        settings.mMaxGames = games;
+        GameServer server(std::move(settings));
+        for (std::size_t i = 0; i < games; ++i)
+        {
+            server.startGame(4, 20);
+        }
+        server.waitIdle();
+        moves += static_cast<double>(server.statistic().outcomeTime(BoardStatistic::Outcome::moved).count());
+    }
+    GameRules::configure({});
+    state.counters["moves/s"] = benchmark::Counter(moves, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_HostedGames)->ArgNames({"games", "threads"})->ArgsProduct({{100, 1000}, {1, 2}})
+        ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// the same games as Game objects, a thread per board, logger-less, and participant
+static void BM_ThreadedGames(benchmark::State &state)
+{
+    auto games = static_cast<std::size_t>(state.range(0));
+    double moves = 0;
+    for (auto _: state)
+    {
+        GameSettings settings;
+        settings.mRules = smallGameRules();
+        settings.mLogEnabled = false;
+        settings.mDumpStatistic = false;
+        std::vector<std::unique_ptr<Game>> running;
+        for (std::size_t i = 0; i < games; ++i)
+        {
+            running.push_back(std::make_unique<Game>(4, 20, settings));
+            running.back()->startGame();
+        }
+        for (auto &game: running)
+        {
+            game->waitEnd();
+            moves += static_cast<double>(game->board()->statistic().outcomeTime(BoardStatistic::Outcome::moved).count());
+        }
+    }
+    GameRules::configure({});
+    state.counters["moves/s"] = benchmark::Counter(moves, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ThreadedGames)->ArgName("games")->Arg(100)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// the same games without boards or timers, `range(0)` games in lockstep blocks on `range(1)` threads
+static void BM_BatchGames(benchmark::State &state)
+{
+    double games = 0;
+    double moves = 0;
+    for (auto _: state)
+    {
+        BatchSettings settings;
+        settings.mGames = static_cast<std::size_t>(state.range(0));
+        settings.mParticipants = 4;
+        settings.mSteps = 20;
+        settings.mThreads = static_cast<std::size_t>(state.range(1));
+        auto report = BatchSimulator(settings).run();
+        games += static_cast<double>(report.mGames);
+        moves += static_cast<double>(report.mMoves);
+    }
+    state.counters["games/s"] = benchmark::Counter(games, benchmark::Counter::kIsRate);
+    state.counters["moves/s"] = benchmark::Counter(moves, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_BatchGames)->ArgNames({"games", "threads"})->ArgsProduct({{100000}, {1, 2, 4}})
+        ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// `range(1)` short games back to back, each on a new Game or, with `range(0)`, on one reusable Game
+static void BM_BackToBackGames(benchmark::State &state)
+{
+    auto reusable = state.range(0) != 0;
+    auto games = static_cast<std::size_t>(state.range(1));
+    GameSettings settings;
+    settings.mRules = smallGameRules();
+    settings.mLogEnabled = false;
+    settings.mDumpStatistic = false;
+    settings.mReusable = reusable;
+    double played = 0;
+    for (auto _: state)
+    {
+        if (reusable)
+        {
+            Game game(4, 5, settings);
+            for (std::size_t i = 0; i < games; ++i)
+            {
+                game.startGame();
+                game.waitEnd();
+            }
+            game.stopGame();
+        } else {
+            for (std::size_t i = 0; i < games; ++i)
+            {
+                Game game(4, 5, settings);
+                game.startGame();
+                game.waitEnd();
+            }
+        }
+        played += static_cast<double>(games);
+    }
+    GameRules::configure({});
+    state.counters["games/s"] = benchmark::Counter(played, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_BackToBackGames)->ArgNames({"reusable", "games"})->ArgsProduct({{0, 1}, {200}})
+        ->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+
+#include "ScenarioRunner.h"
+
+static constexpr const char *sHotspots[] = {"uniform", "zipf:1.2", "cell:3,3", "row:0", "free"};
+
+// closed-loop games with skewed targets, `range(0)` picks the hotspot, `range(1)` participants
+static void BM_HotspotGame(benchmark::State &state)
+{
+    Scenario scenario;
+    scenario.mParticipants = {static_cast<std::size_t>(state.range(1))};
+    scenario.mSizeBoards = {8};
+    scenario.mSteps = 50;
+    scenario.mHotspot = sHotspots[state.range(0)];
+    scenario.mGame.mLogEnabled = false;
+    scenario.mGame.mDumpStatistic = false;
+    scenario.mGame.mRules.mDelayNextStepMin = std::chrono::milliseconds(0);
+    scenario.mGame.mRules.mDelayNextStepMax = std::chrono::milliseconds(0);
+    scenario.mGame.mRules.mDelayWaitForCell = std::chrono::milliseconds(2);
+
+    double moves = 0, seconds = 0, depth = 0, depth99 = 0, wait99 = 0, cancel = 0, utilisation = 0;
+    for (auto _: state)
+    {
+        std::ostringstream report;
+        auto result = ScenarioRunner(scenario).run(report).front();
+        moves += static_cast<double>(result.mMoves);
+        seconds += std::chrono::duration<double>(result.mWallTime).count();
+        depth = std::max(depth, static_cast<double>(result.mWaitDepth.mMax));
+        depth99 += static_cast<double>(result.mWaitDepth.mP99);
+        wait99 += static_cast<double>(result.mWaitTime.mP99) / 1e3;
+        cancel += result.cancelRatio();
+        utilisation += result.boardUtilisation();
+    }
+    GameRules::configure({});
+
+    auto iterations = static_cast<double>(state.iterations());
+    state.SetLabel(sHotspots[state.range(0)]);
+    state.counters["moves/s"] = seconds > 0 ? moves / seconds : 0;
+    state.counters["depth_max"] = depth;
+    state.counters["depth_p99"] = depth99 / iterations;
+    state.counters["wait_p99_us"] = wait99 / iterations;
+    state.counters["cancel"] = cancel / iterations;
+    state.counters["util"] = utilisation / iterations;
+}
+BENCHMARK(BM_HotspotGame)->ArgsProduct({{0, 1, 2, 3, 4}, {8, 32}})->Iterations(3)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -7,6 +7,46 @@ namespace board
 {
 using Coordinate = std::pair<std::int8_t /* x */, std::int8_t /* y */>;
 inline constexpr Coordinate invalidCoordinate{-1, -1};
+
+// a cell of a board as one linear index x * sizeBoard + y; a coordinate is checked against the
+// board size once, when it becomes an index, cells outside the board get the invalid index
+class CellIndex
+{
+public:
+    using value_type = std::uint16_t; // 127 * 127 cells at most
+
+    constexpr CellIndex() noexcept = default;
+    constexpr explicit CellIndex(value_type value) noexcept
+        : mValue(value)
+    {
+
+    }
+
+    static constexpr CellIndex fromCoordinate(const Coordinate &coordinate, std::uint8_t sizeBoard) noexcept
+    {
+        auto x = static_cast<std::uint8_t>(coordinate.first), y = static_cast<std::uint8_t>(coordinate.second);
+        // a negative component wraps around above any board size
+        return x < sizeBoard && y < sizeBoard ? CellIndex(static_cast<value_type>(x * sizeBoard + y)) : CellIndex();
+    }
+
+    constexpr Coordinate toCoordinate(std::uint8_t sizeBoard) const noexcept
+    {
+        return valid() ? Coordinate(static_cast<Coordinate::first_type>(mValue / sizeBoard),
+                                    static_cast<Coordinate::second_type>(mValue % sizeBoard))
+                       : invalidCoordinate;
+    }
+
+    constexpr bool valid() const noexcept { return mValue != sInvalid; }
+    constexpr value_type value() const noexcept { return mValue; }
+
+    constexpr bool operator==(CellIndex other) const noexcept { return mValue == other.mValue; }
+    constexpr bool operator!=(CellIndex other) const noexcept { return mValue != other.mValue; }
+
+    static constexpr value_type sInvalid = 0xFFFF;
+
+private:
+    value_type mValue = sInvalid;
+};
 }
 
 template <class N, typename = std::enable_if_t< std::is_integral_v<N> >>
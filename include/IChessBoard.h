@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "RemoveCopyMove.h"
 #include "Coordinate.h"
@@ -19,13 +21,37 @@ enum class ReasonReject
     idMismatch,
     incorrectId,
     duplicateId,
-    waiterNotFound
+    waiterNotFound,
+    pathBlocked,     // a sliding piece would pass over an occupied cell
+    overloaded       // the command queue of the board is full, the command was not queued
+};
+
+/*
+ * One notification as a value, for notifiers that take a batch at once. The kinds are in the order
+ * of BoardStatistic::Outcome; coordinates a notification does not carry are invalidCoordinate.
+ */
+struct BoardEvent
+{
+    enum class Type : std::uint8_t
+    {
+        placed, moved, cancelMoved, removed, waitingForCell, reject
+    };
+
+    std::uint32_t mId;
+    Type mType;
+    ReasonReject mReason; // reject only
+    Coordinate mFrom;     // moved, cancelMoved, removed, waitingForCell of a move
+    Coordinate mTo;       // placed, moved, cancelMoved, waitingForCell
 };
 
 class INotifier: public virtual RemoveCopyMove
 {
 public:
     ~INotifier() override = default;
+    // the notifications of one drained batch of commands, in the order the board produced them;
+    // by default every event goes to its single handler below. A notifier that overrides it can
+    // take one lock and wake its thread once per batch
+    virtual void onEvents(const BoardEvent *events, std::size_t count) noexcept;
     virtual void placed(std::uint32_t id, const Coordinate &to) noexcept = 0;
     virtual void moved(std::uint32_t id, const Coordinate &from, const Coordinate &to) noexcept = 0;
     virtual void cancelMoved(std::uint32_t id, const Coordinate &from, const Coordinate &to) noexcept = 0;
@@ -46,9 +72,42 @@ public:
     virtual void cancelMoveFigure(const chessman::IChessMan &figure, const Coordinate &to) = 0;
     virtual void removeFigure(const chessman::IChessMan &figure) = 0;
     virtual std::uint8_t sizeBoard() const noexcept = 0;
+    // free cells the figure may move to from its current coordinate under the rules of the board,
+    // a snapshot that may be stale by the time a move arrives; replaces the content of `destinations`
+    virtual void legalDestinations(const chessman::IChessMan &figure, std::vector<Coordinate> &destinations) const = 0;
+    // one of the legalDestinations, `random` is a uniform 32-bit draw scaled to their count;
+    // false when no cell is free
+    virtual bool sampleDestination(const chessman::IChessMan &figure, std::uint32_t random, Coordinate &to) const = 0;
 
     static constexpr std::uint32_t sEmptyCell = 0;
 };
 
+inline void INotifier::onEvents(const BoardEvent *events, std::size_t count) noexcept
+{
+    for (auto event = events; event != events + count; ++event)
+    {
+        switch (event->mType) {
+            case BoardEvent::Type::placed:
+                placed(event->mId, event->mTo);
+                break;
+            case BoardEvent::Type::moved:
+                moved(event->mId, event->mFrom, event->mTo);
+                break;
+            case BoardEvent::Type::cancelMoved:
+                cancelMoved(event->mId, event->mFrom, event->mTo);
+                break;
+            case BoardEvent::Type::removed:
+                removed(event->mId, event->mFrom);
+                break;
+            case BoardEvent::Type::waitingForCell:
+                waitingForCell(event->mId, event->mFrom, event->mTo);
+                break;
+            case BoardEvent::Type::reject:
+                reject(event->mId, event->mReason);
+                break;
+        }
+    }
+}
+
 
 } // board
\ No newline at end of file
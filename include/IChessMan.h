@@ -7,7 +7,7 @@
 namespace chessman {
 
 enum class ChessmanType : std::uint8_t {
-    rook
+    rook, bishop, queen, knight, king
 };
 
 class IChessMan {
@@ -0,0 +1,382 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+
+#include "BatchSimulator.h"
+#include "Executor.h"
+#include "GameRules.h"
+#include "MoveTable.h"
+#include "SlidingAttacks.h"
+
+using chessman::ChessmanType;
+
+static constexpr std::size_t sCountPieces = 5;
+static constexpr std::int8_t sOffBoard = -1;
+
+// the phase of a figure, one byte per figure and game
+enum Phase : std::uint8_t
+{
+    placing, idle, waiting, done
+};
+
+// splitmix64 finalizer, a counter run through it is a random stream
+static std::uint64_t mix(std::uint64_t z) noexcept
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// the top 32 bits of random scaled to [0, count), as Occupancy::sampleDestination draws
+static std::uint32_t scale(std::uint64_t random, std::uint32_t count) noexcept
+{
+    return static_cast<std::uint32_t>(((random >> 32) * count) >> 32);
+}
+
+static bool slider(ChessmanType type) noexcept
+{
+    return type == ChessmanType::rook || type == ChessmanType::bishop || type == ChessmanType::queen;
+}
+
+/*
+ * A fixed number of lanes, each holding one game at a time. Fields of figure p of lane g are at
+ * p * lanes + g, so the round kernel walks each field array of one figure front to back.
+ */
+class BatchSimulator::Block
+{
+public:
+    Block(const BatchSimulator &simulator, std::atomic<std::uint64_t> &nextGame)
+        : mSimulator(simulator)
+        , mNextGame(nextGame)
+        , mLanes(simulator.mSettings.mLanes)
+        , mFigures(simulator.mSettings.mParticipants)
+        , mSquare(mLanes * mFigures, sOffBoard)
+        , mTarget(mLanes * mFigures, sOffBoard)
+        , mPhase(mLanes * mFigures, Phase::done)
+        , mWaitLeft(mLanes * mFigures, 0)
+        , mMovesLeft(mLanes * mFigures, 0)
+        , mOccupancy(mLanes, 0)
+        , mRandomKey(mLanes, 0)
+        , mRandomCounter(mLanes, 0)
+        , mRounds(mLanes, 0)
+        , mWaits(mLanes, 0)
+        , mCancels(mLanes, 0)
+        , mRunning(mLanes, 0)
+        , mMoves(0)
+        , mPathBlocked(0)
+        , mGames(0)
+        , mRoundsPerGame()
+        , mWaitsPerGame()
+        , mCancelsPerGame()
+    {
+
+    }
+
+    void run()
+    {
+        std::size_t active = 0;
+        for (std::size_t lane = 0; lane < mLanes; ++lane)
+        {
+            active += refill(lane);
+        }
+        while (active)
+        {
+            for (std::size_t lane = 0; lane < mLanes; ++lane)
+            {
+                mRounds[lane] += mRunning[lane] != 0;
+            }
+            for (std::size_t figure = 0; figure < mFigures; ++figure)
+            {
+                round(figure);
+            }
+            for (std::size_t lane = 0; lane < mLanes; ++lane)
+            {   // an exhausted lane has neither running figures nor rounds
+                if (!mRunning[lane] && mRounds[lane])
+                {
+                    finish(lane);
+                    if (!refill(lane))
+                    {
+                        --active;
+                    }
+                }
+            }
+        }
+    }
+
+    void report(BatchSimulator &simulator, std::uint64_t &moves, std::uint64_t &pathBlocked,
+                std::uint64_t &games) const
+    {
+        moves += mMoves;
+        pathBlocked += mPathBlocked;
+        games += mGames;
+        simulator.mRounds.merge(mRoundsPerGame);
+        simulator.mWaitsPerGame.merge(mWaitsPerGame);
+        simulator.mCancelsPerGame.merge(mCancelsPerGame);
+    }
+
+private:
+    // starts the next game of the batch in lane, false when the batch is exhausted
+    bool refill(std::size_t lane)
+    {
+        auto game = mNextGame.fetch_add(1, std::memory_order_relaxed);
+        mRounds[lane] = 0;
+        if (game >= mSimulator.mSettings.mGames)
+        {
+            return false;
+        }
+        mOccupancy[lane] = 0;
+        mRandomKey[lane] = mix(mSimulator.mSettings.mSeed ^ mix(game + 1));
+        mRandomCounter[lane] = 0;
+        mWaits[lane] = 0;
+        mCancels[lane] = 0;
+        mRunning[lane] = static_cast<std::uint32_t>(mFigures);
+        auto size = static_cast<std::uint32_t>(mSimulator.mSizeBoard);
+        for (std::size_t figure = 0; figure < mFigures; ++figure)
+        {   // the first step of GameRules::generateFirstStep, uniform over the whole board
+            auto index = figure * mLanes + lane;
+            auto cell = scale(draw(lane), size * size);
+            mSquare[index] = sOffBoard;
+            mTarget[index] = static_cast<std::int8_t>(cell / size * chessman::sBitboardSide + cell % size);
+            mPhase[index] = Phase::placing;
+            mWaitLeft[index] = 0;
+            mMovesLeft[index] = static_cast<std::uint32_t>(mSimulator.mSettings.mSteps);
+        }
+        return true;
+    }
+
+    void finish(std::size_t lane)
+    {
+        ++mGames;
+        mRoundsPerGame.record(mRounds[lane]);
+        mWaitsPerGame.record(mWaits[lane]);
+        mCancelsPerGame.record(mCancels[lane]);
+    }
+
+    std::uint64_t draw(std::size_t lane) noexcept
+    {
+        return mix(mRandomKey[lane] + 0x9e3779b97f4a7c15ull * ++mRandomCounter[lane]);
+    }
+
+    // one round of one figure in every lane
+    void round(std::size_t figure)
+    {
+        auto &simulator = mSimulator;
+        auto type = simulator.mPieces[figure];
+        auto blocking = simulator.mBlockingSliders && slider(type);
+        auto piece = static_cast<std::size_t>(type) * sSquares;
+        auto waitRounds = simulator.mSettings.mWaitRounds;
+        auto *square = mSquare.data() + figure * mLanes;
+        auto *target = mTarget.data() + figure * mLanes;
+        auto *phase = mPhase.data() + figure * mLanes;
+        auto *waitLeft = mWaitLeft.data() + figure * mLanes;
+        auto *movesLeft = mMovesLeft.data() + figure * mLanes;
+        for (std::size_t lane = 0; lane < mLanes; ++lane)
+        {
+            auto &occupancy = mOccupancy[lane];
+            switch (phase[lane]) {
+                case Phase::done:
+                    continue;
+                case Phase::placing:
+                    // a placement waits for its cell without a timeout, it is counted once
+                    if (occupancy & chessman::squareBit(target[lane]))
+                    {
+                        mWaits[lane] += !waitLeft[lane];
+                        waitLeft[lane] = 1;
+                        continue;
+                    }
+                    occupancy |= chessman::squareBit(target[lane]);
+                    square[lane] = target[lane];
+                    phase[lane] = Phase::idle;
+                    continue;
+                case Phase::idle:
+                {
+                    auto from = static_cast<std::size_t>(square[lane]);
+                    auto count = simulator.mTargetCounts[piece + from];
+                    if (!count)
+                    {   // a knight on a small board may have no move at all, the board would
+                        // reject the invalid coordinate and the figure leaves the game
+                        occupancy &= ~chessman::squareBit(square[lane]);
+                        square[lane] = sOffBoard;
+                        phase[lane] = Phase::done;
+                        --mRunning[lane];
+                        continue;
+                    }
+                    target[lane] = static_cast<std::int8_t>(
+                            simulator.mTargets[(piece + from) * sMaxTargets + scale(draw(lane), count)]);
+                    if (blocking && !pathClear(type, square[lane], target[lane], occupancy))
+                    {   // the board rejects the move, the figure draws another one next round
+                        ++mPathBlocked;
+                        continue;
+                    }
+                    if (occupancy & chessman::squareBit(target[lane]))
+                    {
+                        ++mWaits[lane];
+                        waitLeft[lane] = waitRounds;
+                        phase[lane] = Phase::waiting;
+                        continue;
+                    }
+                    break;
+                }
+                case Phase::waiting:
+                    if (occupancy & chessman::squareBit(target[lane]))
+                    {
+                        if (!--waitLeft[lane])
+                        {
+                            ++mCancels[lane];
+                            phase[lane] = Phase::idle;
+                        }
+                        continue;
+                    }
+                    if (blocking && !pathClear(type, square[lane], target[lane], occupancy))
+                    {   // the cell was freed but the path filled up while waiting
+                        ++mPathBlocked;
+                        phase[lane] = Phase::idle;
+                        continue;
+                    }
+                    break;
+            }
+            // the move, a figure with its last step leaves the board
+            ++mMoves;
+            occupancy &= ~chessman::squareBit(square[lane]);
+            auto last = !--movesLeft[lane];
+            occupancy |= last ? 0 : chessman::squareBit(target[lane]);
+            square[lane] = last ? sOffBoard : target[lane];
+            phase[lane] = last ? Phase::done : Phase::idle;
+            mRunning[lane] -= last;
+        }
+    }
+
+    static bool pathClear(ChessmanType type, std::int32_t from, std::int32_t to, std::uint64_t occupancy) noexcept
+    {
+        auto straight = from / chessman::sBitboardSide == to / chessman::sBitboardSide
+                        || from % chessman::sBitboardSide == to % chessman::sBitboardSide;
+        if (type == ChessmanType::queen ? straight : type == ChessmanType::rook)
+        {
+            return chessman::rookAttacks(from, occupancy) & chessman::squareBit(to);
+        }
+        return chessman::bishopAttacks(from, occupancy) & chessman::squareBit(to);
+    }
+
+    const BatchSimulator &mSimulator;
+    std::atomic<std::uint64_t> &mNextGame;
+    const std::size_t mLanes;
+    const std::size_t mFigures;
+
+    // per figure and lane
+    std::vector<std::int8_t> mSquare;
+    std::vector<std::int8_t> mTarget;
+    std::vector<Phase> mPhase;
+    std::vector<std::uint32_t> mWaitLeft;
+    std::vector<std::uint32_t> mMovesLeft;
+    // per lane
+    std::vector<std::uint64_t> mOccupancy;
+    std::vector<std::uint64_t> mRandomKey;
+    std::vector<std::uint64_t> mRandomCounter;
+    std::vector<std::uint32_t> mRounds;
+    std::vector<std::uint32_t> mWaits;
+    std::vector<std::uint32_t> mCancels;
+    std::vector<std::uint32_t> mRunning;
+
+    std::uint64_t mMoves;
+    std::uint64_t mPathBlocked;
+    std::uint64_t mGames;
+    LatencyHistogram mRoundsPerGame;
+    LatencyHistogram mWaitsPerGame;
+    LatencyHistogram mCancelsPerGame;
+};
+
+BatchSimulator::BatchSimulator(BatchSettings settings)
+    : mSettings(settings)
+    , mSizeBoard(GameRules::sizeBoard())
+    , mBlockingSliders(GameRules::settings().mBlockingSliders)
+    , mPieces()
+    , mTargets(sCountPieces * sSquares * sMaxTargets, 0)
+    , mTargetCounts(sCountPieces * sSquares, 0)
+    , mRounds()
+    , mWaitsPerGame()
+    , mCancelsPerGame()
+{
+    if (mSizeBoard > sMaxSizeBoard)
+    {
+        throw std::invalid_argument("The batch simulator keeps a board in one bitboard, 8x8 at most");
+    }
+    if (!mSettings.mParticipants || mSettings.mParticipants >= static_cast<std::size_t>(mSizeBoard * mSizeBoard)
+        || !mSettings.mSteps || !mSettings.mLanes || !mSettings.mWaitRounds)
+    {
+        throw std::invalid_argument("A batch needs participants, a free cell, steps, lanes and wait rounds");
+    }
+    auto &pieces = GameRules::settings().mPieces;
+    for (std::size_t figure = 0; figure < mSettings.mParticipants; ++figure)
+    {
+        mPieces.push_back(pieces[figure % pieces.size()]);
+    }
+    for (std::size_t piece = 0; piece < sCountPieces; ++piece)
+    {
+        auto type = static_cast<ChessmanType>(piece);
+        for (std::int32_t x = 0; x < mSizeBoard; ++x)
+        {
+            for (std::int32_t y = 0; y < mSizeBoard; ++y)
+            {
+                auto from = piece * sSquares + static_cast<std::size_t>(x * chessman::sBitboardSide + y);
+                for (std::int32_t toX = 0; toX < mSizeBoard; ++toX)
+                {
+                    for (std::int32_t toY = 0; toY < mSizeBoard; ++toY)
+                    {
+                        if (chessman::canMove(type, toX - x, toY - y))
+                        {
+                            mTargets[from * sMaxTargets + mTargetCounts[from]++] =
+                                    static_cast<std::uint8_t>(toX * chessman::sBitboardSide + toY);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    // warms the slider tables outside the measured run
+    chessman::rookAttacks(0, 0);
+    chessman::bishopAttacks(0, 0);
+}
+
+BatchReport BatchSimulator::run()
+{
+    mRounds.reset();
+    mWaitsPerGame.reset();
+    mCancelsPerGame.reset();
+    std::atomic<std::uint64_t> nextGame(0);
+    std::uint64_t moves = 0;
+    std::uint64_t pathBlocked = 0;
+    std::uint64_t games = 0;
+    auto started = std::chrono::steady_clock::now();
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::size_t running = 0;
+    {
+        Executor executor(mSettings.mThreads);
+        // no more blocks than a lane each, a small batch stays on few threads
+        auto blocks = std::min(executor.threads(), (mSettings.mGames + mSettings.mLanes - 1) / mSettings.mLanes);
+        running = blocks;
+        for (std::size_t i = 0; i < blocks; ++i)
+        {
+            executor.post([&]() {
+                Block block(*this, nextGame);
+                block.run();
+                std::lock_guard lock(mutex);
+                block.report(*this, moves, pathBlocked, games);
+                if (!--running)
+                {
+                    finished.notify_all();
+                }
+            });
+        }
+        std::unique_lock lock(mutex);
+        finished.wait(lock, [&running]() {
+            return !running;
+        });
+    }
+    auto waits = mWaitsPerGame.sum();
+    auto cancels = mCancelsPerGame.sum();
+    return {games, moves, waits, cancels, pathBlocked, std::chrono::steady_clock::now() - started,
+            mRounds.snapshot(), mWaitsPerGame.snapshot(), mCancelsPerGame.snapshot()};
+}
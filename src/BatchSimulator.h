@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "IChessMan.h"
+#include "LatencyHistogram.h"
+
+struct BatchSettings
+{
+    std::size_t mGames = 100000;
+    std::size_t mParticipants = 4;
+    std::size_t mSteps = 30;
+    // rounds a figure waits for an occupied cell before it cancels, the counterpart of
+    // GameRules::Settings::mDelayWaitForCell
+    std::uint32_t mWaitRounds = 8;
+    // games advanced together by one kernel, a block of lanes per worker
+    std::size_t mLanes = 256;
+    // executor threads, 0: one per core
+    std::size_t mThreads = 0;
+    std::uint64_t mSeed = 1;
+};
+
+struct BatchReport
+{
+    std::uint64_t mGames;
+    std::uint64_t mMoves;
+    std::uint64_t mWaits;
+    std::uint64_t mCancels;
+    std::uint64_t mPathBlocked;
+    std::chrono::nanoseconds mWallTime;
+    // per game; histograms of counts rather than of nanoseconds
+    LatencyHistogram::Snapshot mRounds;
+    LatencyHistogram::Snapshot mWaitsPerGame;
+    LatencyHistogram::Snapshot mCancelsPerGame;
+};
+
+/*
+ * Plays complete games without boards, threads or notifiers, for distributions over millions of
+ * games. Time advances in rounds: in every round each figure of a game either tries a step drawn
+ * like GameRules::generateUniformStep, keeps waiting for its target or cancels the wait after
+ * mWaitRounds. Placement onto an occupied cell waits without a timeout, a finished figure leaves
+ * the board, as with the real board. Figures of one game act in a fixed order within a round,
+ * which stands in for the order of the board's wait queue.
+ *
+ * The state is a struct of arrays, one array per field with the games of a block side by side,
+ * a 64-bit occupancy per game and a counter-based random stream per game, so that the round
+ * kernel is one loop over the games of a block per figure. Blocks refill their lanes with new
+ * games and run on an Executor, one per thread. Boards are limited to 8x8, one bitboard each,
+ * and the pieces, board size and blocking sliders come from GameRules::settings().
+ */
+class BatchSimulator
+{
+public:
+    // throws std::invalid_argument for boards above 8x8, no free cell or an empty batch
+    explicit BatchSimulator(BatchSettings settings);
+
+    BatchReport run();
+
+    static constexpr std::int32_t sMaxSizeBoard = 8;
+
+private:
+    class Block;
+
+    const BatchSettings mSettings;
+    const std::int32_t mSizeBoard;
+    const bool mBlockingSliders;
+    std::vector<chessman::ChessmanType> mPieces; // per figure index
+    // legal targets per piece and square, uniform like GameRules::generateUniformStep
+    std::vector<std::uint8_t> mTargets;          // [piece][square][sMaxTargets]
+    std::vector<std::uint8_t> mTargetCounts;     // [piece][square]
+
+    LatencyHistogram mRounds;
+    LatencyHistogram mWaitsPerGame;
+    LatencyHistogram mCancelsPerGame;
+
+    static constexpr std::size_t sSquares = 64;
+    static constexpr std::size_t sMaxTargets = 28; // a queen in the middle of 8x8 has 27
+};
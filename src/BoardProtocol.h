@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Binary protocol of BoardServer and RemoteChessBoard over a Unix domain stream socket. Both
+ * sides are on one host, so the frames are in native byte order and layout.
+ *
+ * The client sends 24-byte Requests and may pipeline any number of them. Commands (place, move,
+ * cancelMove, remove) get no reply of their own: the board answers them with events, like it
+ * answers a local notifier. Hello and the queries get exactly one Reply with the request id of
+ * the request. The first request of a connection must be hello.
+ *
+ * The server sends 24-byte Replies, a legalDestinations reply followed by mLength bytes of x, y
+ * pairs. Events carry request id 0 and go to the connection that placed the figure, and to
+ * every connection that subscribed to all events.
+ *
+ * The partitions of a board (Partition.h) connect to each other as partition links and send
+ * handOff requests, which get no reply either; a server closes any other connection that sends
+ * one. The connections of one client to all partitions say hello with the same client token, so
+ * that the partition taking over a figure knows its connection.
+ *
+ * A server closes the connection of a request it cannot decode: an unknown op, subscription,
+ * piece or hand-off type.
+ */
+namespace wire {
+
+enum class Op : std::uint8_t
+{
+    hello,             // mArgument: Subscription, mFigureId: client token or 0; reply mValue: board size
+    place,
+    move,
+    cancelMove,
+    remove,
+    legalDestinations, // reply payload: the cells
+    sampleDestination, // mArgument: the random draw; reply mValue: 1 and mTo when a cell is free
+    handOff,           // partition links only; mArgument: client token of the figure for a prepare
+};
+
+enum class Subscription : std::uint32_t
+{
+    ownFigures, // events of the figures placed through this connection
+    allEvents,  // every event of the board
+    partitionLink // another partition of the board, mFigureId: its index; gets no events
+};
+
+enum class Kind : std::uint8_t
+{
+    event, reply
+};
+
+struct Request
+{
+    std::uint32_t mRequestId;
+    std::uint32_t mFigureId;
+    std::uint32_t mArgument;
+    Op mOp;
+    std::uint8_t mPiece;      // chessman::ChessmanType
+    std::int8_t mFrom[2];     // current coordinate of the figure
+    std::int8_t mTo[2];
+    std::uint8_t mHandOff;    // board::HandOff::Type
+    std::uint8_t mFound;
+    std::uint8_t mReserved[4];
+};
+
+struct Reply
+{
+    std::uint32_t mRequestId; // 0 for an event
+    std::uint32_t mFigureId;
+    std::uint32_t mLength;    // payload bytes after the frame
+    std::uint32_t mValue;
+    Kind mKind;
+    std::uint8_t mType;       // event: board::BoardEvent::Type
+    std::uint8_t mReason;     // event: board::ReasonReject
+    std::int8_t mFrom[2];
+    std::int8_t mTo[2];
+    std::uint8_t mReserved;
+};
+
+static_assert(sizeof(Request) == 24 && sizeof(Reply) == 24, "fixed frames");
+
+} // wire
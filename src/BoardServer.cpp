@@ -0,0 +1,745 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "BoardServer.h"
+#include "ChessManImpl.h"
+#include "Tracer.h"
+
+using namespace board;
+
+struct BoardServer::Connection
+{
+    explicit Connection(int fd)
+        : mFd(fd)
+        , mHello(false)
+        , mAllEvents(false)
+        , mClient(0)
+        , mPeer(-1)
+        , mLink(false)
+        , mIn()
+        , mOut()
+        , mSent(0)
+        , mDirty(false)
+        , mWantWrite(false)
+    {
+
+    }
+
+    int mFd;
+    bool mHello;
+    bool mAllEvents;
+    std::uint32_t mClient;   // client token, 0 for none
+    int mPeer;               // the partition of a link to another partition, -1 for a client
+    bool mLink;              // a link from another partition, may send hand-offs
+    std::vector<char> mIn;   // an incomplete request
+    std::vector<char> mOut;
+    std::size_t mSent;
+    bool mDirty;
+    bool mWantWrite;         // EPOLLOUT armed
+};
+
+static void toWire(const Coordinate &coordinate, std::int8_t (&wire)[2])
+{
+    wire[0] = coordinate.first;
+    wire[1] = coordinate.second;
+}
+
+static Coordinate fromWire(const std::int8_t (&wire)[2])
+{
+    return {wire[0], wire[1]};
+}
+
+BoardServer::BoardServer(std::string path, std::shared_ptr<ChessBoardImpl> board)
+    : BoardServer(std::vector<std::string>{std::move(path)}, 0, std::move(board))
+{
+
+}
+
+BoardServer::BoardServer(const std::vector<std::string> &partitionPaths, std::uint8_t partition,
+                         std::shared_ptr<ChessBoardImpl> board)
+    : TreadBase("BoardServer")
+    , mPath(partition < partitionPaths.size() ? partitionPaths[partition] : std::string())
+    , mBoard(std::move(board))
+    , mPartition{partition, static_cast<std::uint8_t>(partitionPaths.size()), mBoard->sizeBoard()}
+    , mPeerPaths(partitionPaths)
+    , mListen(-1)
+    , mEpoll(-1)
+    , mWake(-1)
+    , mStop(false)
+    , mMutexOutbox()
+    , mOutbox()
+    , mDelivering()
+    , mHandOffs()
+    , mForwarding()
+    , mConnections()
+    , mFigures()
+    , mClients()
+    , mPeers(partitionPaths.size(), nullptr)
+    , mBacklog(partitionPaths.size())
+    , mDirty()
+    , mDestinations()
+    , mScratch(64u << 10u)
+    , mConnectionCount(0)
+{
+    if (partition >= partitionPaths.size() || partitionPaths.size() > mBoard->sizeBoard())
+    {
+        throw std::invalid_argument("BoardServer: partition " + std::to_string(partition) + " of "
+                                    + std::to_string(partitionPaths.size()) + " on a board of "
+                                    + std::to_string(mBoard->sizeBoard()) + " rows");
+    }
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    for (auto &path: mPeerPaths)
+    {
+        if (path.empty() || path.size() >= sizeof(address.sun_path))
+        {
+            throw std::invalid_argument("BoardServer: socket path must have 1.."
+                                        + std::to_string(sizeof(address.sun_path) - 1) + " characters");
+        }
+    }
+    std::memcpy(address.sun_path, mPath.c_str(), mPath.size() + 1);
+    auto fail = [this](const char *what) {
+        auto error = errno;
+        for (auto fd: {mListen, mEpoll, mWake})
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+        throw std::system_error(error, std::generic_category(), what + (" " + mPath));
+    };
+    mListen = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (mListen < 0)
+    {
+        fail("socket");
+    }
+    ::unlink(mPath.c_str());
+    if (::bind(mListen, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+    {
+        fail("bind");
+    }
+    if (::listen(mListen, SOMAXCONN) < 0)
+    {
+        fail("listen");
+    }
+    mEpoll = ::epoll_create1(EPOLL_CLOEXEC);
+    mWake = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (mEpoll < 0 || mWake < 0)
+    {
+        fail("epoll");
+    }
+    for (auto fd: {mListen, mWake})
+    {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (::epoll_ctl(mEpoll, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            fail("epoll_ctl");
+        }
+    }
+}
+
+BoardServer::~BoardServer()
+{
+    mStop.store(true, std::memory_order_relaxed);
+    wake();
+    TreadBase::join();
+    ::close(mListen);
+    ::close(mEpoll);
+    ::close(mWake);
+    ::unlink(mPath.c_str());
+}
+
+/* ************************************************************
+ * IMPL IGameElement
+ * ************************************************************/
+void BoardServer::startGame()
+{
+    if (mPartition.mCount > 1)
+    {
+        mBoard->setPartition(mPartition, shared_from_this());
+    }
+    mBoard->addNotifier(shared_from_this());
+    TreadBase::start();
+}
+
+void BoardServer::stopGame()
+{
+    mStop.store(true, std::memory_order_relaxed);
+    wake();
+    TreadBase::join();
+    mBoard->removeNotifier(shared_from_this());
+    if (mPartition.mCount > 1)
+    {   // the board must not keep the server alive
+        mBoard->setPartition({0, 1, mPartition.mSizeBoard}, nullptr);
+    }
+}
+
+const std::string &BoardServer::path() const noexcept
+{
+    return mPath;
+}
+
+std::size_t BoardServer::connections() const noexcept
+{
+    return mConnectionCount.load(std::memory_order_relaxed);
+}
+
+/* ************************************************************
+ * IMPL board::INotifier
+ * ************************************************************/
+void BoardServer::placed(std::uint32_t id, const Coordinate &to) noexcept
+{
+    BoardEvent event{id, BoardEvent::Type::placed, ReasonReject::empty, invalidCoordinate, to};
+    onEvents(&event, 1);
+}
+
+void BoardServer::moved(std::uint32_t id, const Coordinate &from, const Coordinate &to) noexcept
+{
+    BoardEvent event{id, BoardEvent::Type::moved, ReasonReject::empty, from, to};
+    onEvents(&event, 1);
+}
+
+void BoardServer::cancelMoved(std::uint32_t id, const Coordinate &from, const Coordinate &to) noexcept
+{
+    BoardEvent event{id, BoardEvent::Type::cancelMoved, ReasonReject::empty, from, to};
+    onEvents(&event, 1);
+}
+
+void BoardServer::removed(std::uint32_t id, const Coordinate &from) noexcept
+{
+    BoardEvent event{id, BoardEvent::Type::removed, ReasonReject::empty, from, invalidCoordinate};
+    onEvents(&event, 1);
+}
+
+void BoardServer::waitingForCell(std::uint32_t id, const Coordinate &from, const Coordinate &to) noexcept
+{
+    BoardEvent event{id, BoardEvent::Type::waitingForCell, ReasonReject::empty, from, to};
+    onEvents(&event, 1);
+}
+
+void BoardServer::reject(std::uint32_t id, ReasonReject reason) noexcept
+{
+    BoardEvent event{id, BoardEvent::Type::reject, reason, invalidCoordinate, invalidCoordinate};
+    onEvents(&event, 1);
+}
+
+void BoardServer::onEvents(const BoardEvent *events, std::size_t count) noexcept
+{   // on the board thread: queue the batch, the loop routes it
+    bool idle;
+    {
+        std::lock_guard lock(mMutexOutbox);
+        idle = mOutbox.empty() && mHandOffs.empty();
+        mOutbox.insert(mOutbox.end(), events, events + count);
+    }
+    if (idle)
+    {
+        wake();
+    }
+}
+
+/* ************************************************************
+ * IMPL board::IHandOffPeer
+ * ************************************************************/
+void BoardServer::handOff(const HandOff &message) noexcept
+{   // on the board thread, like onEvents
+    bool idle;
+    {
+        std::lock_guard lock(mMutexOutbox);
+        idle = mOutbox.empty() && mHandOffs.empty();
+        mHandOffs.push_back(message);
+    }
+    if (idle)
+    {
+        wake();
+    }
+}
+
+/* ************************************************************
+ * IMPL TreadBase
+ * ************************************************************/
+void BoardServer::loop()
+{
+    epoll_event events[64];
+    while (!mStop.load(std::memory_order_relaxed))
+    {
+        auto ready = ::epoll_wait(mEpoll, events, 64, connectPeers() ? -1 : 50);
+        if (ready < 0 && errno != EINTR)
+        {
+            break;
+        }
+        for (int i = 0; i < ready; ++i)
+        {
+            auto fd = events[i].data.fd;
+            if (fd == mListen)
+            {
+                accept();
+            } else if (fd == mWake) {
+                std::uint64_t value;
+                auto drained = ::read(mWake, &value, sizeof(value));
+                static_cast<void>(drained);
+                deliver();
+            } else if (auto it = mConnections.find(fd); it != mConnections.end()) {
+                if (events[i].events & EPOLLOUT)
+                {
+                    flush(*it->second);
+                }
+                // the flush may have closed the connection
+                if (it = mConnections.find(fd); it != mConnections.end()
+                    && events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+                {
+                    read(*it->second);
+                }
+            }
+        }
+        for (auto connection: mDirty)
+        {
+            connection->mDirty = false;
+            flush(*connection);
+        }
+        mDirty.clear();
+    }
+}
+
+void BoardServer::onStop()
+{
+    while (!mConnections.empty())
+    {
+        close(*mConnections.begin()->second);
+    }
+    mDirty.clear();
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+void BoardServer::accept()
+{
+    while (true)
+    {
+        auto fd = ::accept4(mListen, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            return;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (::epoll_ctl(mEpoll, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            ::close(fd);
+            continue;
+        }
+        mConnections.emplace(fd, std::make_unique<Connection>(fd));
+        mConnectionCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void BoardServer::read(Connection &connection)
+{   // a bounded number of reads per wake-up, so that one busy client does not starve the others
+    for (int reads = 0; reads < 16; ++reads)
+    {
+        auto carry = connection.mIn.size();
+        std::memcpy(mScratch.data(), connection.mIn.data(), carry);
+        auto received = ::recv(connection.mFd, mScratch.data() + carry, mScratch.size() - carry, 0);
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return;
+        }
+        if (received <= 0)
+        {
+            close(connection);
+            return;
+        }
+        if (connection.mPeer >= 0)
+        {   // a link to another partition only gets the reply to its hello
+            continue;
+        }
+        auto size = carry + static_cast<std::size_t>(received);
+        std::size_t offset = 0;
+        Tracer::Scope scope("BoardServer::read");
+        for (; offset + sizeof(wire::Request) <= size; offset += sizeof(wire::Request))
+        {
+            wire::Request request;
+            std::memcpy(&request, mScratch.data() + offset, sizeof(request));
+            if (!handle(connection, request))
+            {
+                close(connection);
+                return;
+            }
+        }
+        connection.mIn.assign(mScratch.data() + offset, mScratch.data() + size);
+        if (size < mScratch.size())
+        {
+            return;
+        }
+    }
+}
+
+bool BoardServer::handle(Connection &connection, const wire::Request &request)
+{
+    if ((!connection.mHello && request.mOp != wire::Op::hello)
+        || request.mPiece > static_cast<std::uint8_t>(chessman::ChessmanType::king))
+    {   // the piece indexes move tables and bit masks
+        return false;
+    }
+    auto piece = static_cast<chessman::ChessmanType>(request.mPiece);
+    ChessManImpl figure(request.mFigureId, piece);
+    figure.setCurrentCoordinate(fromWire(request.mFrom));
+    wire::Reply reply{};
+    reply.mRequestId = request.mRequestId;
+    reply.mFigureId = request.mFigureId;
+    reply.mKind = wire::Kind::reply;
+    switch (request.mOp) {
+        case wire::Op::hello:
+        {
+            auto subscription = static_cast<wire::Subscription>(request.mArgument);
+            if (connection.mHello || subscription > wire::Subscription::partitionLink)
+            {
+                return false;
+            }
+            connection.mHello = true;
+            if (subscription == wire::Subscription::partitionLink)
+            {   // only the other partitions of a partitioned board
+                if (mPartition.mCount == 1 || request.mFigureId >= mPartition.mCount
+                    || request.mFigureId == mPartition.mIndex)
+                {
+                    return false;
+                }
+                connection.mLink = true;
+            } else {
+                connection.mAllEvents = subscription == wire::Subscription::allEvents;
+                connection.mClient = request.mFigureId;
+                if (connection.mClient)
+                {
+                    mClients[connection.mClient] = &connection;
+                }
+            }
+            reply.mValue = mBoard->sizeBoard();
+            write(connection, reply);
+            return true;
+        }
+        case wire::Op::place:
+            if (auto it = mFigures.find(request.mFigureId); it == mFigures.end() || !it->second.mOwner)
+            {   // events are routed before the board has them, so the owner is known first
+                mFigures[request.mFigureId] = Figure{&connection, piece, invalidCoordinate};
+            }
+            mBoard->placeFigure(figure, fromWire(request.mTo));
+            return true;
+        case wire::Op::move:
+            mBoard->moveFigure(figure, fromWire(request.mTo));
+            return true;
+        case wire::Op::cancelMove:
+            mBoard->cancelMoveFigure(figure, fromWire(request.mTo));
+            return true;
+        case wire::Op::remove:
+            mBoard->removeFigure(figure);
+            return true;
+        case wire::Op::legalDestinations:
+        {
+            mBoard->legalDestinations(figure, mDestinations);
+            std::vector<std::int8_t> cells;
+            cells.reserve(mDestinations.size() * 2);
+            for (auto &cell: mDestinations)
+            {
+                cells.push_back(cell.first);
+                cells.push_back(cell.second);
+            }
+            reply.mLength = static_cast<std::uint32_t>(cells.size());
+            reply.mValue = static_cast<std::uint32_t>(mDestinations.size());
+            write(connection, reply, cells.data());
+            return true;
+        }
+        case wire::Op::sampleDestination:
+        {
+            Coordinate to = invalidCoordinate;
+            reply.mValue = mBoard->sampleDestination(figure, request.mArgument, to) ? 1 : 0;
+            toWire(to, reply.mTo);
+            write(connection, reply);
+            return true;
+        }
+        case wire::Op::handOff:
+        {
+            if (!connection.mLink || request.mHandOff > static_cast<std::uint8_t>(HandOff::Type::cancelled))
+            {
+                return false;
+            }
+            HandOff message{request.mFigureId, static_cast<HandOff::Type>(request.mHandOff), piece,
+                            request.mFound != 0, fromWire(request.mFrom), fromWire(request.mTo)};
+            auto it = mFigures.find(message.mId);
+            if (message.mType == HandOff::Type::prepare && (it == mFigures.end() || !it->second.mOwner))
+            {   // the figure may come over, its events go to the same client here
+                auto client = mClients.find(request.mArgument);
+                mFigures[message.mId] = Figure{client != mClients.end() ? client->second : nullptr, piece,
+                                               invalidCoordinate};
+            } else if (message.mType == HandOff::Type::abort && it != mFigures.end() && it->second.mAt == message.mTo) {
+                mFigures.erase(it);
+            }
+            mBoard->handOff(message);
+            return true;
+        }
+    }
+    return false;
+}
+
+void BoardServer::deliver()
+{
+    {
+        std::lock_guard lock(mMutexOutbox);
+        mDelivering.swap(mOutbox);
+        mForwarding.swap(mHandOffs);
+    }
+    Tracer::Scope scope("BoardServer::deliver");
+    for (auto &event: mDelivering)
+    {
+        route(event);
+    }
+    mDelivering.clear();
+    for (auto &message: mForwarding)
+    {
+        forward(message);
+    }
+    mForwarding.clear();
+}
+
+void BoardServer::route(const BoardEvent &event)
+{
+    Connection *owner = nullptr;
+    auto left = event.mType == BoardEvent::Type::moved && !mPartition.owns(event.mTo);
+    if (auto it = mFigures.find(event.mId); it != mFigures.end())
+    {
+        auto &figure = it->second;
+        owner = figure.mOwner;
+        switch (event.mType) {
+            case BoardEvent::Type::placed:
+            case BoardEvent::Type::moved:
+                figure.mAt = event.mTo;
+                if (!owner && !left)
+                {   // a cell granted after its client left
+                    removeFigure(event.mId, figure);
+                }
+                break;
+            case BoardEvent::Type::removed:
+                mFigures.erase(it);
+                break;
+            default:
+                break;
+        }
+    }
+    wire::Reply reply{};
+    reply.mFigureId = event.mId;
+    reply.mKind = wire::Kind::event;
+    reply.mType = static_cast<std::uint8_t>(event.mType);
+    reply.mReason = static_cast<std::uint8_t>(event.mReason);
+    toWire(event.mFrom, reply.mFrom);
+    toWire(event.mTo, reply.mTo);
+    if (owner)
+    {
+        write(*owner, reply);
+    }
+    for (auto &[fd, connection]: mConnections)
+    {
+        if (connection->mAllEvents && connection.get() != owner)
+        {
+            write(*connection, reply);
+        }
+    }
+    if (left)
+    {   // the partition of the cell routes the figure from now on
+        mFigures.erase(event.mId);
+    }
+}
+
+void BoardServer::forward(const HandOff &message)
+{
+    wire::Request request{};
+    request.mOp = wire::Op::handOff;
+    request.mFigureId = message.mId;
+    request.mPiece = static_cast<std::uint8_t>(message.mPiece);
+    request.mHandOff = static_cast<std::uint8_t>(message.mType);
+    request.mFound = message.mFound ? 1 : 0;
+    toWire(message.mFrom, request.mFrom);
+    toWire(message.mTo, request.mTo);
+    if (auto it = mFigures.find(message.mId); it != mFigures.end())
+    {
+        auto &figure = it->second;
+        if (message.mType == HandOff::Type::prepare && figure.mOwner)
+        {
+            request.mArgument = figure.mOwner->mClient;
+        } else if (message.mType == HandOff::Type::granted) {
+            figure.mAt = message.mTo;  // reserved, removed with its client from now on
+        } else if (message.mType == HandOff::Type::cancelled && message.mFound && figure.mAt == invalidCoordinate) {
+            mFigures.erase(it);
+        }
+    }
+    auto partition = mPartition.owner(message.toTarget() ? message.mTo : message.mFrom);
+    if (auto peer = mPeers[partition])
+    {
+        queue(*peer, &request, sizeof(request));
+    } else {
+        mBacklog[partition].push_back(request);
+    }
+}
+
+bool BoardServer::connectPeers()
+{
+    auto connected = true;
+    for (std::uint8_t partition = 0; partition < mPartition.mCount; ++partition)
+    {
+        if (partition == mPartition.mIndex || mPeers[partition])
+        {
+            continue;
+        }
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        auto &path = mPeerPaths[partition];
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        auto fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0
+            || ::epoll_ctl(mEpoll, EPOLL_CTL_ADD, fd, &event) < 0)
+        {   // not listening yet
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            connected = false;
+            continue;
+        }
+        auto &peer = *mConnections.emplace(fd, std::make_unique<Connection>(fd)).first->second;
+        mConnectionCount.fetch_add(1, std::memory_order_relaxed);
+        peer.mHello = true;
+        peer.mPeer = partition;
+        mPeers[partition] = &peer;
+        wire::Request hello{};
+        hello.mOp = wire::Op::hello;
+        hello.mArgument = static_cast<std::uint32_t>(wire::Subscription::partitionLink);
+        hello.mFigureId = mPartition.mIndex;
+        queue(peer, &hello, sizeof(hello));
+        auto &backlog = mBacklog[partition];
+        queue(peer, backlog.data(), backlog.size() * sizeof(wire::Request));
+        backlog.clear();
+    }
+    return connected;
+}
+
+void BoardServer::write(Connection &connection, const wire::Reply &reply, const void *payload)
+{
+    queue(connection, &reply, sizeof(reply));
+    if (reply.mLength)
+    {
+        queue(connection, payload, reply.mLength);
+    }
+}
+
+void BoardServer::queue(Connection &connection, const void *data, std::size_t size)
+{
+    auto bytes = static_cast<const char *>(data);
+    connection.mOut.insert(connection.mOut.end(), bytes, bytes + size);
+    if (!connection.mDirty)
+    {
+        connection.mDirty = true;
+        mDirty.push_back(&connection);
+    }
+}
+
+void BoardServer::flush(Connection &connection)
+{
+    while (connection.mSent < connection.mOut.size())
+    {
+        auto sent = ::send(connection.mFd, connection.mOut.data() + connection.mSent,
+                           connection.mOut.size() - connection.mSent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            if (connection.mOut.size() - connection.mSent > sMaxOutput)
+            {
+                close(connection);
+                return;
+            }
+            if (!connection.mWantWrite)
+            {
+                epoll_event event{};
+                event.events = EPOLLIN | EPOLLRDHUP | EPOLLOUT;
+                event.data.fd = connection.mFd;
+                ::epoll_ctl(mEpoll, EPOLL_CTL_MOD, connection.mFd, &event);
+                connection.mWantWrite = true;
+            }
+            return;
+        }
+        if (sent < 0)
+        {
+            close(connection);
+            return;
+        }
+        connection.mSent += static_cast<std::size_t>(sent);
+    }
+    connection.mOut.clear();
+    connection.mSent = 0;
+    if (connection.mWantWrite)
+    {
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = connection.mFd;
+        ::epoll_ctl(mEpoll, EPOLL_CTL_MOD, connection.mFd, &event);
+        connection.mWantWrite = false;
+    }
+}
+
+void BoardServer::close(Connection &connection)
+{
+    for (auto &[id, figure]: mFigures)
+    {
+        if (figure.mOwner == &connection)
+        {
+            figure.mOwner = nullptr;
+            if (figure.mAt != invalidCoordinate)
+            {
+                removeFigure(id, figure);
+            }
+        }
+    }
+    if (connection.mDirty)
+    {
+        mDirty.erase(std::find(mDirty.begin(), mDirty.end(), &connection));
+    }
+    if (auto it = mClients.find(connection.mClient); it != mClients.end() && it->second == &connection)
+    {
+        mClients.erase(it);
+    }
+    if (connection.mPeer >= 0)
+    {   // connected again by the loop, the hand-offs meanwhile wait in the backlog
+        mPeers[connection.mPeer] = nullptr;
+    }
+    ::epoll_ctl(mEpoll, EPOLL_CTL_DEL, connection.mFd, nullptr);
+    ::close(connection.mFd);
+    mConnectionCount.fetch_sub(1, std::memory_order_relaxed);
+    mConnections.erase(connection.mFd);
+}
+
+void BoardServer::removeFigure(std::uint32_t id, const Figure &figure)
+{
+    ChessManImpl chessMan(id, figure.mPiece);
+    chessMan.setCurrentCoordinate(figure.mAt);
+    mBoard->removeFigure(chessMan);
+}
+
+void BoardServer::wake() noexcept
+{
+    std::uint64_t one = 1;
+    auto written = ::write(mWake, &one, sizeof(one));
+    static_cast<void>(written);
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BoardProtocol.h"
+#include "ChessBoardImpl.h"
+#include "IGameElement.h"
+#include "Partition.h"
+#include "TreadBase.h"
+
+/*
+ * Front-end of a ChessBoardImpl for participants in other processes, see BoardProtocol.h. One
+ * thread runs an epoll loop over the listening socket, the connections and an eventfd: requests
+ * are read in bulk and submitted to the board from this thread, the events of the board come
+ * back through onEvents on the board thread and are routed here, one eventfd wake-up per batch.
+ *
+ * Figure ids must be unique among the clients of a server. When a connection closes, its
+ * figures are removed from the board, also the ones that get a cell later.
+ *
+ * A partition of a larger board (Partition.h) also connects to the servers of the other
+ * partitions and forwards the hand-offs of its board there, retrying the ones that do not listen
+ * yet; the messages wait meanwhile. A figure that moved to another partition is routed by it from
+ * then on.
+ */
+class BoardServer
+        : public TreadBase
+        , public board::INotifier
+        , public board::IHandOffPeer
+        , public IGameElement
+        , public std::enable_shared_from_this<BoardServer>
+{
+public:
+    // listens on `path`, replacing a stale socket file; throws std::system_error when it cannot.
+    // The board is started and stopped by its owner
+    BoardServer(std::string path, std::shared_ptr<ChessBoardImpl> board);
+    // serves partition `partition` of the board on partitionPaths[partition], the others are
+    // served on the other paths; throws std::invalid_argument for more partitions than rows
+    BoardServer(const std::vector<std::string> &partitionPaths, std::uint8_t partition,
+                std::shared_ptr<ChessBoardImpl> board);
+    ~BoardServer() override;
+
+    // subscribes to the board, partitions it and starts the loop; must be owned by a shared_ptr
+    void startGame() override;
+    // closes every connection and waits for the loop
+    void stopGame() override;
+
+    const std::string &path() const noexcept;
+    std::size_t connections() const noexcept;
+
+    // a client that lets this much of its replies pile up is disconnected
+    static constexpr std::size_t sMaxOutput = 16u << 20u;
+
+    void placed(std::uint32_t id, const board::Coordinate &to) noexcept override;
+    void moved(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
+    void cancelMoved(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
+    void removed(std::uint32_t id, const board::Coordinate &from) noexcept override;
+    void waitingForCell(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
+    void reject(std::uint32_t id, board::ReasonReject reason) noexcept override;
+    void onEvents(const board::BoardEvent *events, std::size_t count) noexcept override;
+
+    void handOff(const board::HandOff &message) noexcept override;
+
+protected:
+    void loop() override;
+    void onStop() override;
+
+private:
+    struct Connection;
+    struct Figure;
+
+    void accept();
+    void read(Connection &connection);
+    bool handle(Connection &connection, const wire::Request &request);
+    void deliver();
+    void route(const board::BoardEvent &event);
+    void forward(const board::HandOff &message);
+    // true once every other partition is connected
+    bool connectPeers();
+    void write(Connection &connection, const wire::Reply &reply, const void *payload = nullptr);
+    void queue(Connection &connection, const void *data, std::size_t size);
+    void flush(Connection &connection);
+    void close(Connection &connection);
+    void removeFigure(std::uint32_t id, const Figure &figure);
+    void wake() noexcept;
+
+    const std::string mPath;
+    const std::shared_ptr<ChessBoardImpl> mBoard;
+    const board::Partition mPartition;
+    const std::vector<std::string> mPeerPaths;
+    int mListen;
+    int mEpoll;
+    int mWake;
+    std::atomic<bool> mStop;
+
+    std::mutex mMutexOutbox;
+    std::vector<board::BoardEvent> mOutbox;     // from the board thread
+    std::vector<board::BoardEvent> mDelivering; // swapped with mOutbox by the loop
+    std::vector<board::HandOff> mHandOffs;      // from the board thread
+    std::vector<board::HandOff> mForwarding;    // swapped with mHandOffs by the loop
+
+    // loop thread only
+    std::unordered_map<int, std::unique_ptr<Connection>> mConnections;
+    std::unordered_map<std::uint32_t, Figure> mFigures;
+    std::unordered_map<std::uint32_t, Connection *> mClients;  // by client token
+    std::vector<Connection *> mPeers;           // links to the other partitions, null until connected
+    std::vector<std::vector<wire::Request>> mBacklog; // hand-offs for a partition not connected yet
+    std::vector<Connection *> mDirty;           // connections with unsent replies
+    std::vector<board::Coordinate> mDestinations;
+    std::vector<char> mScratch;
+    std::atomic<std::size_t> mConnectionCount;
+};
+
+struct BoardServer::Figure
+{
+    Connection *mOwner;       // null once the connection closed
+    chessman::ChessmanType mPiece;
+    board::Coordinate mAt;    // invalidCoordinate until placed
+};
@@ -0,0 +1,232 @@
+#include <iomanip>
+
+#include "BoardStatistic.h"
+
+static const char *operationName(std::size_t operation)
+{
+    static constexpr const char *names[BoardStatistic::sCountOperations] = {
+        "place", "move", "cancelMove", "remove"
+    };
+    return names[operation];
+}
+
+static const char *outcomeName(std::size_t outcome)
+{
+    static constexpr const char *names[BoardStatistic::sCountOutcomes] = {
+        "placed", "moved", "cancelMoved", "removed", "waitingForCell", "reject"
+    };
+    return names[outcome];
+}
+
+static const char *reasonName(board::ReasonReject reason)
+{
+    switch (reason) {
+        case board::ReasonReject::empty:
+            return "empty";
+        case board::ReasonReject::boardStopped:
+            return "boardStopped";
+        case board::ReasonReject::incorrectCoordinate:
+            return "incorrectCoordinate";
+        case board::ReasonReject::idMismatch:
+            return "idMismatch";
+        case board::ReasonReject::incorrectId:
+            return "incorrectId";
+        case board::ReasonReject::duplicateId:
+            return "duplicateId";
+        case board::ReasonReject::waiterNotFound:
+            return "waiterNotFound";
+        case board::ReasonReject::pathBlocked:
+            return "pathBlocked";
+        case board::ReasonReject::overloaded:
+            return "overloaded";
+    }
+    return "unknown";
+}
+
+static void printRow(std::ostream &os, const char *stage, const char *name, const LatencyHistogram &histogram)
+{
+    auto snapshot = histogram.snapshot();
+    if (!snapshot.mCount)
+    {
+        return;
+    }
+    auto us = [](std::uint64_t ns) {
+        return static_cast<double>(ns) / 1000.0;
+    };
+    os << std::left << std::setw(9) << stage << std::setw(21) << name << std::right
+       << std::setw(10) << snapshot.mCount
+       << std::fixed << std::setprecision(1)
+       << std::setw(11) << us(snapshot.mMean)
+       << std::setw(11) << us(snapshot.mP50)
+       << std::setw(11) << us(snapshot.mP99)
+       << std::setw(11) << us(snapshot.mP999)
+       << std::setw(11) << us(snapshot.mMax) << '\n';
+}
+
+void BoardStatistic::recordQueue(Operation operation, std::chrono::nanoseconds duration) noexcept
+{
+    mQueue[static_cast<std::size_t>(operation)].record(duration);
+}
+
+void BoardStatistic::recordService(Operation operation, std::chrono::nanoseconds duration) noexcept
+{
+    mService[static_cast<std::size_t>(operation)].record(duration);
+}
+
+void BoardStatistic::recordOutcome(Outcome outcome, board::ReasonReject reason, std::chrono::nanoseconds duration) noexcept
+{
+    mOutcome[static_cast<std::size_t>(outcome)].record(duration);
+    if (outcome == Outcome::reject && static_cast<std::size_t>(reason) < sMaxReasons)
+    {
+        mReject[static_cast<std::size_t>(reason)].record(duration);
+    }
+}
+
+void BoardStatistic::recordWaitDepth(std::size_t depth) noexcept
+{
+    mWaitDepth.record(static_cast<std::uint64_t>(depth));
+}
+
+void BoardStatistic::recordQueueDepth(std::size_t depth) noexcept
+{
+    mQueueDepth.record(static_cast<std::uint64_t>(depth));
+}
+
+void BoardStatistic::recordCoalesced(std::size_t count) noexcept
+{
+    mCoalesced.fetch_add(count, std::memory_order_relaxed);
+}
+
+void BoardStatistic::recordWaitGranted(std::chrono::nanoseconds duration) noexcept
+{
+    mWaitGranted.record(duration);
+}
+
+void BoardStatistic::recordWaitCancelled(std::chrono::nanoseconds duration) noexcept
+{
+    mWaitCancelled.record(duration);
+}
+
+const LatencyHistogram &BoardStatistic::queueTime(Operation operation) const noexcept
+{
+    return mQueue[static_cast<std::size_t>(operation)];
+}
+
+const LatencyHistogram &BoardStatistic::serviceTime(Operation operation) const noexcept
+{
+    return mService[static_cast<std::size_t>(operation)];
+}
+
+const LatencyHistogram &BoardStatistic::outcomeTime(Outcome outcome) const noexcept
+{
+    return mOutcome[static_cast<std::size_t>(outcome)];
+}
+
+const LatencyHistogram &BoardStatistic::rejectTime(board::ReasonReject reason) const noexcept
+{
+    return mReject[static_cast<std::size_t>(reason) % sMaxReasons];
+}
+
+const LatencyHistogram &BoardStatistic::waitDepth() const noexcept
+{
+    return mWaitDepth;
+}
+
+const LatencyHistogram &BoardStatistic::queueDepth() const noexcept
+{
+    return mQueueDepth;
+}
+
+std::uint64_t BoardStatistic::coalesced() const noexcept
+{
+    return mCoalesced.load(std::memory_order_relaxed);
+}
+
+const LatencyHistogram &BoardStatistic::waitGranted() const noexcept
+{
+    return mWaitGranted;
+}
+
+const LatencyHistogram &BoardStatistic::waitCancelled() const noexcept
+{
+    return mWaitCancelled;
+}
+
+std::chrono::nanoseconds BoardStatistic::busyTime() const noexcept
+{
+    std::uint64_t busy = 0;
+    for (auto &histogram: mService)
+    {
+        busy += histogram.sum();
+    }
+    return std::chrono::nanoseconds(busy);
+}
+
+void BoardStatistic::reset() noexcept
+{
+    for (auto &histogram: mQueue)
+    {
+        histogram.reset();
+    }
+    for (auto &histogram: mService)
+    {
+        histogram.reset();
+    }
+    for (auto &histogram: mOutcome)
+    {
+        histogram.reset();
+    }
+    for (auto &histogram: mReject)
+    {
+        histogram.reset();
+    }
+    mWaitDepth.reset();
+    mQueueDepth.reset();
+    mCoalesced.store(0, std::memory_order_relaxed);
+    mWaitGranted.reset();
+    mWaitCancelled.reset();
+}
+
+void BoardStatistic::dump(std::ostream &os) const
+{
+    auto flags = os.flags();
+    auto precision = os.precision();
+    os << std::left << std::setw(30) << "Board latency, us" << std::right
+       << std::setw(10) << "count" << std::setw(11) << "mean" << std::setw(11) << "p50"
+       << std::setw(11) << "p99" << std::setw(11) << "p999" << std::setw(11) << "max" << '\n';
+    for (std::size_t i = 0; i < sCountOperations; ++i)
+    {
+        printRow(os, "queue", operationName(i), mQueue[i]);
+    }
+    for (std::size_t i = 0; i < sCountOperations; ++i)
+    {
+        printRow(os, "service", operationName(i), mService[i]);
+    }
+    for (std::size_t i = 0; i < sCountOutcomes; ++i)
+    {
+        printRow(os, "outcome", outcomeName(i), mOutcome[i]);
+    }
+    for (std::size_t i = 0; i < sMaxReasons; ++i)
+    {
+        printRow(os, "reject", reasonName(static_cast<board::ReasonReject>(i)), mReject[i]);
+    }
+    printRow(os, "wait", "granted", mWaitGranted);
+    printRow(os, "wait", "cancelled", mWaitCancelled);
+    if (auto depth = mWaitDepth.snapshot(); depth.mCount)
+    {
+        os << "Wait queue depth: mean " << depth.mMean << ", p50 " << depth.mP50 << ", p99 " << depth.mP99
+           << ", max " << depth.mMax << '\n';
+    }
+    if (auto depth = mQueueDepth.snapshot(); depth.mCount)
+    {
+        os << "Command queue depth: mean " << depth.mMean << ", p50 " << depth.mP50 << ", p99 " << depth.mP99
+           << ", high-water " << depth.mMax << '\n';
+    }
+    if (auto coalesced = BoardStatistic::coalesced())
+    {
+        os << "Coalesced commands: " << coalesced << '\n';
+    }
+    os.flags(flags);
+    os.precision(precision);
+    os.flush();
+}
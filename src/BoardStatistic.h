@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <ostream>
+
+#include "IChessBoard.h"
+#include "LatencyHistogram.h"
+
+/*
+ * Latency of board commands, written by the board thread and readable from any thread.
+ *  queue   - submit (placeFigure/moveFigure/...) to the start of do_task
+ *  service - start to end of do_task; its notifications are queued and go out with the batch
+ *  outcome - submit to the delivery of the batch holding a notification, per notification kind
+ *            and reject reason
+ *  wait    - time a figure spent in the waiting list of a cell until it got the cell or cancelled,
+ *            and the length of that list right after the figure joined it
+ *  depth   - length of the command queue right after a command joined it
+ *  coalesced - queued commands the board dropped because a later command of the figure made them moot
+ */
+class BoardStatistic
+{
+public:
+    enum class Operation : std::uint8_t;
+    enum class Outcome : std::uint8_t;
+
+    BoardStatistic() = default;
+    BoardStatistic(const BoardStatistic &) = delete;
+    BoardStatistic &operator=(const BoardStatistic &) = delete;
+
+    void recordQueue(Operation operation, std::chrono::nanoseconds duration) noexcept;
+    void recordService(Operation operation, std::chrono::nanoseconds duration) noexcept;
+    void recordOutcome(Outcome outcome, board::ReasonReject reason, std::chrono::nanoseconds duration) noexcept;
+    void recordWaitDepth(std::size_t depth) noexcept;
+    void recordQueueDepth(std::size_t depth) noexcept;
+    void recordCoalesced(std::size_t count) noexcept;
+    void recordWaitGranted(std::chrono::nanoseconds duration) noexcept;
+    void recordWaitCancelled(std::chrono::nanoseconds duration) noexcept;
+
+    const LatencyHistogram &queueTime(Operation operation) const noexcept;
+    const LatencyHistogram &serviceTime(Operation operation) const noexcept;
+    const LatencyHistogram &outcomeTime(Outcome outcome) const noexcept;
+    const LatencyHistogram &rejectTime(board::ReasonReject reason) const noexcept;
+    const LatencyHistogram &waitDepth() const noexcept;
+    const LatencyHistogram &queueDepth() const noexcept;
+    std::uint64_t coalesced() const noexcept;
+    const LatencyHistogram &waitGranted() const noexcept;
+    const LatencyHistogram &waitCancelled() const noexcept;
+    // total service time, the board thread is busy for that long
+    std::chrono::nanoseconds busyTime() const noexcept;
+
+    void reset() noexcept;
+    void dump(std::ostream &os) const;
+
+    static constexpr std::size_t sCountOperations = 4;
+    static constexpr std::size_t sCountOutcomes = 6;
+    static constexpr std::size_t sMaxReasons = 16;
+
+private:
+    std::array<LatencyHistogram, sCountOperations> mQueue;
+    std::array<LatencyHistogram, sCountOperations> mService;
+    std::array<LatencyHistogram, sCountOutcomes> mOutcome;
+    std::array<LatencyHistogram, sMaxReasons> mReject;
+    LatencyHistogram mWaitDepth;
+    LatencyHistogram mQueueDepth;
+    LatencyHistogram mWaitGranted;
+    LatencyHistogram mWaitCancelled;
+    std::atomic<std::uint64_t> mCoalesced{0};
+};
+
+enum class BoardStatistic::Operation : std::uint8_t
+{
+    place, move, cancelMove, remove
+};
+
+enum class BoardStatistic::Outcome : std::uint8_t
+{
+    placed, moved, cancelMoved, removed, waitingForCell, reject
+};
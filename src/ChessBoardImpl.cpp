@@ -1,33 +1,116 @@
 #include <iostream>
 #include <functional>
+#include <stdexcept>
 #include "ChessBoardImpl.h"
 #include "Coordinate.h"
+#include "Executor.h"
 #include "IChessMan.h"
-#include "GameRules.h"
+#include "MoveTable.h"
+#include "Tracer.h"
 
 using namespace board;
 
-ChessBoardImpl::ChessBoardImpl(std::uint8_t sizeBoard)
+using CellEvent = void (INotifier::*)(std::uint32_t, const Coordinate &) noexcept;
+using MoveEvent = void (INotifier::*)(std::uint32_t, const Coordinate &, const Coordinate &) noexcept;
+using RejectEvent = void (INotifier::*)(std::uint32_t, ReasonReject) noexcept;
+
+static BoardEvent toEvent(CellEvent event, std::uint32_t id, const Coordinate &cell)
+{
+    if (event == &INotifier::placed)
+    {
+        return {id, BoardEvent::Type::placed, ReasonReject::empty, invalidCoordinate, cell};
+    }
+    return {id, BoardEvent::Type::removed, ReasonReject::empty, cell, invalidCoordinate};
+}
+
+static BoardEvent toEvent(MoveEvent event, std::uint32_t id, const Coordinate &from, const Coordinate &to)
+{
+    auto type = BoardEvent::Type::waitingForCell;
+    if (event == &INotifier::moved)
+    {
+        type = BoardEvent::Type::moved;
+    } else if (event == &INotifier::cancelMoved) {
+        type = BoardEvent::Type::cancelMoved;
+    }
+    return {id, type, ReasonReject::empty, from, to};
+}
+
+static BoardEvent toEvent(RejectEvent, std::uint32_t id, ReasonReject reason)
+{
+    return {id, BoardEvent::Type::reject, reason, invalidCoordinate, invalidCoordinate};
+}
+
+ChessBoardImpl::ChessBoardImpl(std::uint8_t sizeBoard, bool blockingSliders)
+    : ChessBoardImpl(sizeBoard, blockingSliders, sUnbounded, OverloadPolicy::block)
+{
+
+}
+
+ChessBoardImpl::ChessBoardImpl(std::uint8_t sizeBoard, bool blockingSliders, std::size_t capacity,
+                               OverloadPolicy policy)
+    : ChessBoardImpl(sizeBoard, blockingSliders, capacity, policy, nullptr, std::make_shared<BoardStatistic>())
+{
+
+}
+
+ChessBoardImpl::ChessBoardImpl(std::uint8_t sizeBoard, bool blockingSliders, std::shared_ptr<Strand> strand,
+                               std::shared_ptr<BoardStatistic> statistic)
+    : ChessBoardImpl(sizeBoard, blockingSliders, sUnbounded, OverloadPolicy::block, std::move(strand),
+                     std::move(statistic))
+{
+
+}
+
+ChessBoardImpl::ChessBoardImpl(std::uint8_t sizeBoard, bool blockingSliders, std::size_t capacity,
+                               OverloadPolicy policy, std::shared_ptr<Strand> strand,
+                               std::shared_ptr<BoardStatistic> statistic)
     : IChessBoard()
     , TreadBase("ChessBoardImpl")
     , mMutexTasks()
     , mWait()
+    , mWaitSpace()
     , mReasonWeakUp(ReasonWeakUp::do_work)
     , mTaskList()
+    , mUrgentList()
+    , mDrainPolicy(DrainPolicy::fifo)
+    , mUrgentWeight(sDefaultUrgentWeight)
+    , mUrgentRun(0)
+    , mResetPending(false)
+    , mCapacity(capacity)
+    , mPolicy(policy)
+    , mHighWater(0)
     , mMutexNotifier()
     , mListNotifiers()
-    , mBoard(sizeBoard, Row_t(sizeBoard, {sEmptyCell, {}}))
+    , mOverloadNotifiers()
+    , mSizeBoard(sizeBoard)
+    , mBoard(static_cast<std::size_t>(sizeBoard) * sizeBoard, {sEmptyCell, {}})
     , mIds()
+    , mOccupancy(sizeBoard)
+    , mOccupied()
+    , mBlockingSliders(blockingSliders)
+    , mPartition{0, 1, sizeBoard}
+    , mPeer()
+    , mStrand(std::move(strand))
+    , mDrainPosted(false)
+    , mStatistic(std::move(statistic))
+    , mCurrentTask(nullptr)
+    , mEvents()
+    , mEventsSubmitted()
 {
-
+    static_assert(sizeof(Task) <= 24, "the piece type must not grow a task");
+    static_assert(static_cast<std::size_t>(BoardEvent::Type::reject) + 1 == BoardStatistic::sCountOutcomes
+                  && static_cast<std::size_t>(BoardEvent::Type::reject)
+                     == static_cast<std::size_t>(BoardStatistic::Outcome::reject),
+                  "an event kind converts to its outcome");
+    mEvents.reserve(sMaxBatchEvents);
+    mEventsSubmitted.reserve(sMaxBatchEvents);
 }
 
 ChessBoardImpl::~ChessBoardImpl()
 {
     {
         std::unique_lock lock(mMutexTasks);
-        mReasonWeakUp = ReasonWeakUp::exit;
-        mWait.notify_all();
+        wakeUp(ReasonWeakUp::exit);
     }
     TreadBase::join();
 }
@@ -37,14 +120,36 @@ ChessBoardImpl::~ChessBoardImpl()
  * ************************************************************/
 void ChessBoardImpl::startGame()
 {
-    TreadBase::start();
+    if (!mStrand)
+    {
+        TreadBase::start();
+    }
 }
 
 void ChessBoardImpl::stopGame()
 {
     std::unique_lock lock(mMutexTasks);
-    mReasonWeakUp = ReasonWeakUp::stop;
-    mWait.notify_all();
+    wakeUp(ReasonWeakUp::stop);
+    if (mStrand)
+    {
+        mStrand->post([board = shared_from_this()]() {
+            board->do_stop();
+        });
+    }
+}
+
+void ChessBoardImpl::reset()
+{
+    std::unique_lock lock(mMutexTasks);
+    if (mStrand || mReasonWeakUp == ReasonWeakUp::stop || mReasonWeakUp == ReasonWeakUp::exit)
+    {
+        throw std::logic_error("Only a running board with a thread of its own can be reset");
+    }
+    mResetPending = true;
+    wakeUp(ReasonWeakUp::do_work);
+    mWait.wait(lock, [this]() {
+        return !mResetPending;
+    });
 }
 
 /* ************************************************************
@@ -54,6 +159,11 @@ void ChessBoardImpl::addNotifier(std::shared_ptr<board::INotifier> notifier)
 {
     std::lock_guard lock(mMutexNotifier);
     mListNotifiers.emplace_back(std::move(notifier));
+    if (mCapacity != sUnbounded)
+    {
+        std::atomic_store(&mOverloadNotifiers,
+                          std::make_shared<const std::vector<std::shared_ptr<INotifier>>>(mListNotifiers));
+    }
 }
 
 void ChessBoardImpl::removeNotifier(std::shared_ptr<board::INotifier> notifier)
@@ -61,41 +171,45 @@ void ChessBoardImpl::removeNotifier(std::shared_ptr<board::INotifier> notifier)
     std::lock_guard lock(mMutexNotifier);
     auto it = std::remove(mListNotifiers.begin(), mListNotifiers.end(), notifier);
     mListNotifiers.erase(it, mListNotifiers.end());
+    if (mCapacity != sUnbounded)
+    {
+        std::atomic_store(&mOverloadNotifiers,
+                          std::make_shared<const std::vector<std::shared_ptr<INotifier>>>(mListNotifiers));
+    }
 }
 
 void ChessBoardImpl::placeFigure(const chessman::IChessMan &figure, const Coordinate &to)
 {
-    std::lock_guard lock(mMutexTasks);
-    mTaskList.emplace_back(Task::Type::place, figure.getID(), Coordinate(), to);
-    mReasonWeakUp = ReasonWeakUp::do_work;
-    mWait.notify_all();
+    submit(Task(Task::Type::place, figure.getID(), CellIndex(), toIndex(to)), false);
 }
 
 void ChessBoardImpl::moveFigure(const chessman::IChessMan &figure,
                                 const Coordinate &to)
 {
-    auto &from_coordinate = figure.getCurrentCoordinate();
-    std::lock_guard lock(mMutexTasks);
-    mTaskList.emplace_back(Task::Type::move, figure.getID(), from_coordinate, to);
-    mReasonWeakUp = ReasonWeakUp::do_work;
-    mWait.notify_all();
+    submit(Task(Task::Type::move, figure.getID(), toIndex(figure.getCurrentCoordinate()), toIndex(to), figure.getType()),
+           false);
 }
 
 void ChessBoardImpl::removeFigure(const chessman::IChessMan &figure)
 {
-    std::lock_guard lock(mMutexTasks);
-    mTaskList.emplace_back(Task::Type::remove, figure.getID(), figure.getCurrentCoordinate(), Coordinate());
-    mReasonWeakUp = ReasonWeakUp::do_work;
-    mWait.notify_all();
+    submit(Task(Task::Type::remove, figure.getID(), toIndex(figure.getCurrentCoordinate()), CellIndex()), false);
 }
 
 void ChessBoardImpl::cancelMoveFigure(const chessman::IChessMan &figure, const Coordinate &to)
 {
-    auto &from_coordinate = figure.getCurrentCoordinate();
-    std::lock_guard lock(mMutexTasks);
-    mTaskList.emplace_back(Task::Type::cancelMove, figure.getID(), from_coordinate, to);
-    mReasonWeakUp = ReasonWeakUp::do_work;
-    mWait.notify_all();
+    submit(Task(Task::Type::cancelMove, figure.getID(), toIndex(figure.getCurrentCoordinate()), toIndex(to),
+                figure.getType()), false);
+}
+
+bool ChessBoardImpl::tryPlaceFigure(const chessman::IChessMan &figure, const Coordinate &to)
+{
+    return submit(Task(Task::Type::place, figure.getID(), CellIndex(), toIndex(to)), true);
+}
+
+bool ChessBoardImpl::tryMoveFigure(const chessman::IChessMan &figure, const Coordinate &to)
+{
+    return submit(Task(Task::Type::move, figure.getID(), toIndex(figure.getCurrentCoordinate()), toIndex(to),
+                       figure.getType()), true);
 }
 
 /* ************************************************************
@@ -106,17 +220,42 @@ void ChessBoardImpl::loop()
     std::unique_lock lock(mMutexTasks);
     while (mReasonWeakUp != ReasonWeakUp::stop && mReasonWeakUp != ReasonWeakUp::exit)
     {
-        while (!mTaskList.empty())
+        while (auto lane = nextLane())
         {
-            auto task = std::move(mTaskList.front());
-            mTaskList.pop_front();
+            auto task = std::move(lane->front());
+            lane->pop_front();
+            if (lane == &mTaskList && mCapacity != sUnbounded)
+            {
+                mWaitSpace.notify_one();
+            }
             lock.unlock();
             do_task(task);
+            if (mEvents.size() >= sMaxBatchEvents)
+            {
+                flushEvents();
+            }
+            lock.lock();
+        }
+        if (!mEvents.empty())
+        {   // the batch is drained, its notifications go out before the board waits; the notifiers
+            // may have queued more commands meanwhile
+            lock.unlock();
+            flushEvents();
             lock.lock();
+            continue;
+        }
+        if (mResetPending)
+        {
+            do_reset();
+            mResetPending = false;
+            mWait.notify_all();
+        }
+        if (mReasonWeakUp == ReasonWeakUp::do_work)
+        {
+            mReasonWeakUp = ReasonWeakUp::fake;
         }
-        mReasonWeakUp = ReasonWeakUp::fake;
         mWait.wait(lock, [this]() {
-            return mReasonWeakUp != ReasonWeakUp::fake;
+            return mReasonWeakUp != ReasonWeakUp::fake || mResetPending;
         });
     }
 }
@@ -124,176 +263,377 @@ void ChessBoardImpl::loop()
 void ChessBoardImpl::onStop()
 {
     auto notify = [this](std::uint32_t id) {
-        notifyAll(&board::INotifier::reject, id, board::ReasonReject::boardStopped);
+        queueEvent(&board::INotifier::reject, id, board::ReasonReject::boardStopped);
     };
     std::for_each(mIds.begin(), mIds.end(), notify);
+    flushEvents();
 
     std::unique_lock lock(mMutexTasks);
     mTaskList.clear();
+    mUrgentList.clear();
     while (mReasonWeakUp != ReasonWeakUp::exit)
     {
-        while (!mTaskList.empty())
+        while (auto lane = nextLane())
         {
-            auto &task = mTaskList.front();
-            mTaskList.pop_front();
+            auto id = lane->front().mId;
+            lane->pop_front();
             lock.unlock();
-            notify(task.mId);
+            notify(id);
             lock.lock();
         }
-        mReasonWeakUp = ReasonWeakUp::fake;
+        lock.unlock();
+        flushEvents();
+        lock.lock();
         mWait.wait(lock, [this]() {
-            return mReasonWeakUp != ReasonWeakUp::fake;
+            return mReasonWeakUp == ReasonWeakUp::exit || !mTaskList.empty() || !mUrgentList.empty();
         });
     }
     mTaskList.clear();
+    mUrgentList.clear();
     TreadBase::onStop();
 }
 
 uint8_t ChessBoardImpl::sizeBoard() const noexcept
 {
-    return GameRules::sizeBoard();
+    return mSizeBoard;
+}
+
+void ChessBoardImpl::legalDestinations(const chessman::IChessMan &figure, std::vector<Coordinate> &destinations) const
+{
+    auto &from = figure.getCurrentCoordinate();
+    if (!toIndex(from).valid())
+    {
+        destinations.clear();
+        return;
+    }
+    mOccupancy.destinations(figure.getType(), from, mBlockingSliders, destinations);
+}
+
+bool ChessBoardImpl::sampleDestination(const chessman::IChessMan &figure, std::uint32_t random, Coordinate &to) const
+{
+    auto &from = figure.getCurrentCoordinate();
+    if (!toIndex(from).valid())
+    {
+        return false;
+    }
+    return mOccupancy.sampleDestination(figure.getType(), from, mBlockingSliders, random, to);
+}
+
+const BoardStatistic &ChessBoardImpl::statistic() const noexcept
+{
+    return *mStatistic;
+}
+
+void ChessBoardImpl::setDrainPolicy(DrainPolicy policy, std::size_t urgentWeight)
+{
+    if (policy == DrainPolicy::weighted && !urgentWeight)
+    {
+        throw std::invalid_argument("A weighted drain needs a positive weight");
+    }
+    std::lock_guard lock(mMutexTasks);
+    if (policy == DrainPolicy::fifo)
+    {   // the lane of urgent tasks goes first once, then everything shares one lane again
+        mTaskList.splice(mTaskList.begin(), mUrgentList);
+    }
+    mDrainPolicy = policy;
+    mUrgentWeight = urgentWeight;
+    mUrgentRun = 0;
+}
+
+std::size_t ChessBoardImpl::queueHighWater() const noexcept
+{
+    return mHighWater.load(std::memory_order_relaxed);
+}
+
+void ChessBoardImpl::setPartition(const Partition &partition, std::shared_ptr<IHandOffPeer> peer)
+{
+    if (!partition.mCount || partition.mIndex >= partition.mCount || partition.mCount > mSizeBoard
+        || partition.mSizeBoard != mSizeBoard)
+    {
+        throw std::invalid_argument("Partition " + std::to_string(partition.mIndex) + " of "
+                                    + std::to_string(partition.mCount) + " does not fit a board of "
+                                    + std::to_string(mSizeBoard));
+    }
+    if (partition.mCount > 1 && (mBlockingSliders || !peer))
+    {
+        throw std::invalid_argument("A partitioned board needs a peer and figures that jump over occupied cells");
+    }
+    // the board thread reads both after taking mMutexTasks for its next task
+    std::lock_guard lock(mMutexTasks);
+    mPartition = partition;
+    mPeer = std::move(peer);
+}
+
+void ChessBoardImpl::handOff(const HandOff &message)
+{
+    static constexpr Task::Type types[] = {
+        Task::Type::prepare, Task::Type::waiting, Task::Type::granted, Task::Type::abort,
+        Task::Type::cancelHandOff, Task::Type::cancelled
+    };
+    auto type = types[static_cast<std::size_t>(message.mType)];
+    if (type == Task::Type::cancelled && !message.mFound)
+    {
+        type = Task::Type::notCancelled;
+    }
+    submit(Task(type, message.mId, toIndex(message.mFrom), toIndex(message.mTo), message.mPiece), false);
 }
 
 
 /* ************************************************************
  * private
  * ************************************************************/
+bool ChessBoardImpl::submit(const Task &task, bool tryOnly)
+{
+    std::unique_lock lock(mMutexTasks);
+    auto bounded = task.mTypeTask == Task::Type::place || task.mTypeTask == Task::Type::move;
+    if (bounded && mCapacity != sUnbounded && mTaskList.size() >= mCapacity)
+    {
+        if (tryOnly)
+        {
+            return false;
+        }
+        if (mPolicy == OverloadPolicy::reject)
+        {
+            lock.unlock();
+            notifyOverloaded(task.mId);
+            return false;
+        }
+        // a stopping board takes the command anyway and answers it with boardStopped
+        mWaitSpace.wait(lock, [this]() {
+            return mTaskList.size() < mCapacity
+                || mReasonWeakUp == ReasonWeakUp::stop
+                || mReasonWeakUp == ReasonWeakUp::exit;
+        });
+    }
+    auto queued = task;
+    if (!bounded)
+    {
+        coalesce(queued);
+    }
+    if (!bounded && mDrainPolicy != DrainPolicy::fifo)
+    {
+        mUrgentList.push_back(queued);
+    } else {
+        mTaskList.push_back(queued);
+    }
+    auto depth = mTaskList.size() + mUrgentList.size();
+    if (depth > mHighWater.load(std::memory_order_relaxed))
+    {   // written under mMutexTasks only
+        mHighWater.store(depth, std::memory_order_relaxed);
+    }
+    mStatistic->recordQueueDepth(depth);
+    wakeUp(ReasonWeakUp::do_work);
+    return true;
+}
+
+void ChessBoardImpl::notifyOverloaded(std::uint32_t id)
+{   // on the producer thread, which must not wait for the board thread to finish a notification,
+    // and there is no current task to time the answer against
+    if (auto notifiers = std::atomic_load(&mOverloadNotifiers))
+    {
+        for (auto &notifier: *notifiers)
+        {
+            notifier->reject(id, ReasonReject::overloaded);
+        }
+    }
+    mStatistic->recordOutcome(BoardStatistic::Outcome::reject, ReasonReject::overloaded,
+                              std::chrono::nanoseconds::zero());
+}
+
 void ChessBoardImpl::do_task(const ChessBoardImpl::Task &task)
 {
+    static constexpr const char *spanNames[BoardStatistic::sCountOperations] = {
+        "do_task place", "do_task move", "do_task cancelMove", "do_task remove"
+    };
+    // a hand-off message is a step of a move or cancel that its source partition records once
+    auto handOff = task.mTypeTask >= Task::Type::prepare;
+    auto operation = toOperation(task);
+    Tracer::Scope scope(handOff ? "do_task handOff" : spanNames[static_cast<std::size_t>(operation)]);
+    auto started = Clock::now();
+    if (!handOff)
+    {
+        mStatistic->recordQueue(operation, started - task.mSubmitted);
+    }
+    mCurrentTask = &task;
+
     if (task.mId != sEmptyCell)
     {
         switch (task.mTypeTask) {
             case Task::Type::place:
-                do_place(task.mId, task.mToCoordinate);
+                do_place(task.mId, task.mTo);
                 break;
             case Task::Type::move:
-                do_move(task.mId, task.mFromCoordinate, task.mToCoordinate);
+                do_move(task.mId, task.mPiece, task.mFrom, task.mTo);
                 break;
             case Task::Type::remove:
-                do_remove(task.mId, task.mFromCoordinate);
+                do_remove(task.mId, task.mFrom);
                 break;
             case Task::Type::cancelMove:
-                do_cancel_move(task.mId, task.mFromCoordinate, task.mToCoordinate);
+                do_cancel_move(task.mId, task.mPiece, task.mFrom, task.mTo);
+                break;
+            case Task::Type::cancelQueued:
+                queueEvent(&board::INotifier::cancelMoved, task.mId, toCoordinate(task.mFrom), toCoordinate(task.mTo));
+                break;
+            default:
+                do_hand_off(task);
                 break;
         }
     } else {
-        notifyAll(&board::INotifier::reject, task.mId, board::ReasonReject::incorrectId);
+        queueEvent(&board::INotifier::reject, task.mId, board::ReasonReject::incorrectId);
+    }
+
+    mCurrentTask = nullptr;
+    if (!handOff)
+    {
+        mStatistic->recordService(operation, Clock::now() - started);
     }
 }
 
-void ChessBoardImpl::do_place(std::uint32_t id, const Coordinate &to_coordinate)
+void ChessBoardImpl::do_place(std::uint32_t id, CellIndex to_index)
 {
     using namespace board;
 
-    if (mIds.find(id) == mIds.end())
+    if (mIds.find(id) != mIds.end())
     {
-        try {
-            auto &to_cell = getCell(to_coordinate);
-            if (to_cell.first == sEmptyCell) {
-                to_cell.first = id;
-                mIds.insert(id);
-                notifyAll(&INotifier::placed, id, to_coordinate);
-            } else {
-                to_cell.second.emplace_back(id, invalidCoordinate);
-                mIds.insert(id);
-                notifyAll(&INotifier::waitingForCell, id, invalidCoordinate, to_coordinate);
-            }
-        } catch (std::out_of_range &) {
-            notifyAll(&INotifier::reject, id, board::ReasonReject::incorrectCoordinate);
-        }
+        queueEvent(&INotifier::reject, id, board::ReasonReject::duplicateId);
+    } else if (!to_index.valid() || !owns(to_index)) {
+        queueEvent(&INotifier::reject, id, board::ReasonReject::incorrectCoordinate);
     } else {
-        notifyAll(&INotifier::reject, id, board::ReasonReject::duplicateId);
+        auto &to_cell = getCell(to_index);
+        auto to_coordinate = toCoordinate(to_index);
+        if (to_cell.first == sEmptyCell) {
+            to_cell.first = id;
+            mOccupancy.set(to_coordinate);
+            mIds.insert(id);
+            queueEvent(&INotifier::placed, id, to_coordinate);
+        } else {
+            to_cell.second.emplace_back(id, CellIndex());
+            mStatistic->recordWaitDepth(to_cell.second.size());
+            mIds.insert(id);
+            queueEvent(&INotifier::waitingForCell, id, invalidCoordinate, to_coordinate);
+        }
     }
 }
 
-void ChessBoardImpl::do_move(std::uint32_t id, const Coordinate &from_coordinate, const Coordinate &to_coordinate)
+void ChessBoardImpl::do_move(std::uint32_t id, chessman::ChessmanType piece, CellIndex from_index, CellIndex to_index)
 {
     using namespace board;
 
-    try {
-        auto &from_cell = getCell(from_coordinate);
-        auto &to_cell = getCell(to_coordinate);
-        if (from_cell.first == id) {
-            if (to_cell.first == sEmptyCell) {
-                from_cell.first = sEmptyCell;
-                to_cell.first = id;
-                notifyAll(&INotifier::moved, id, from_coordinate, to_coordinate);
-                do_check_waiting(from_coordinate);
-            } else {
-                to_cell.second.emplace_back(id, from_coordinate);
-                notifyAll(&INotifier::waitingForCell, id, from_coordinate, to_coordinate);
-            }
-        } else {
-            notifyAll(&INotifier::reject, id, board::ReasonReject::idMismatch);
-        }
-    } catch (std::out_of_range &)  {
-        notifyAll(&INotifier::reject, id, board::ReasonReject::incorrectCoordinate);
+    if (!from_index.valid() || !to_index.valid())
+    {
+        queueEvent(&INotifier::reject, id, board::ReasonReject::incorrectCoordinate);
+        return;
+    }
+    auto &from_cell = getCell(from_index);
+    auto &to_cell = getCell(to_index);
+    auto from_coordinate = toCoordinate(from_index);
+    auto to_coordinate = toCoordinate(to_index);
+    if (from_cell.first != id) {
+        queueEvent(&INotifier::reject, id, board::ReasonReject::idMismatch);
+    } else if (mBlockingSliders && !chessman::canMove(piece, to_coordinate.first - from_coordinate.first,
+                                                      to_coordinate.second - from_coordinate.second)) {
+        queueEvent(&INotifier::reject, id, board::ReasonReject::incorrectCoordinate);
+    } else if (mBlockingSliders && !mOccupancy.pathClear(piece, from_coordinate, to_coordinate)) {
+        queueEvent(&INotifier::reject, id, board::ReasonReject::pathBlocked);
+    } else if (!owns(to_index)) {
+        // the partition of the cell reserves it or queues the figure, the answer comes back as a task
+        mPeer->handOff({id, HandOff::Type::prepare, piece, false, from_coordinate, to_coordinate});
+    } else if (to_cell.first == sEmptyCell) {
+        from_cell.first = sEmptyCell;
+        to_cell.first = id;
+        mOccupancy.move(from_coordinate, to_coordinate);
+        queueEvent(&INotifier::moved, id, from_coordinate, to_coordinate);
+        do_check_waiting(from_index);
+    } else {
+        to_cell.second.emplace_back(id, from_index, piece);
+        mStatistic->recordWaitDepth(to_cell.second.size());
+        queueEvent(&INotifier::waitingForCell, id, from_coordinate, to_coordinate);
     }
 }
 
-void ChessBoardImpl::do_cancel_move(std::uint32_t id, const Coordinate &from_coordinate, const Coordinate &to_coordinate)
+void ChessBoardImpl::do_cancel_move(std::uint32_t id, chessman::ChessmanType piece, CellIndex from_index,
+                                    CellIndex to_index)
 {
     using namespace board;
-    try {
-        auto &from_cell = getCell(from_coordinate);
-        auto &to_cell = getCell(to_coordinate);
-        if (from_cell.first == id) {
-            auto &wait_list = to_cell.second;
-            auto it = std::find_if(wait_list.begin(), wait_list.end(), [&](auto &item) {
-                return item.first == id && item.second == from_coordinate;
-            });
-            if (it != wait_list.end())
-            {
-                wait_list.erase(it);
-                notifyAll(&INotifier::cancelMoved, id, from_coordinate, to_coordinate);
-            } else {
-                notifyAll(&INotifier::reject, id, board::ReasonReject::waiterNotFound);
-            }
+
+    if (!from_index.valid() || !to_index.valid())
+    {
+        queueEvent(&INotifier::reject, id, board::ReasonReject::incorrectCoordinate);
+        return;
+    }
+    if (getCell(from_index).first == id && !owns(to_index)) {
+        mPeer->handOff({id, HandOff::Type::cancel, piece, false, toCoordinate(from_index), toCoordinate(to_index)});
+    } else if (getCell(from_index).first == id) {
+        auto &wait_list = getCell(to_index).second;
+        auto it = std::find_if(wait_list.begin(), wait_list.end(), [&](auto &item) {
+            return item.mId == id && item.mFrom == from_index;
+        });
+        if (it != wait_list.end())
+        {
+            mStatistic->recordWaitCancelled(Clock::now() - it->mSince);
+            wait_list.erase(it);
+            queueEvent(&INotifier::cancelMoved, id, toCoordinate(from_index), toCoordinate(to_index));
         } else {
-            notifyAll(&INotifier::reject, id, board::ReasonReject::idMismatch);
+            queueEvent(&INotifier::reject, id, board::ReasonReject::waiterNotFound);
         }
-    } catch (std::out_of_range &)  {
-        notifyAll(&INotifier::reject, id, board::ReasonReject::incorrectCoordinate);
+    } else {
+        queueEvent(&INotifier::reject, id, board::ReasonReject::idMismatch);
     }
 }
 
-void ChessBoardImpl::do_remove(std::uint32_t id, const Coordinate &from_coordinate)
+void ChessBoardImpl::do_remove(std::uint32_t id, CellIndex from_index)
 {
     using namespace board;
 
-    try {
-        auto &from_cell = getCell(from_coordinate);
-        if (from_cell.first == id) {
-            from_cell.first = sEmptyCell;
-            mIds.erase(id);
-            notifyAll(&INotifier::removed, id, from_coordinate);
-            do_check_waiting(from_coordinate);
-        } else {
-            notifyAll(&INotifier::reject, id, board::ReasonReject::idMismatch);
-        }
-    } catch (std::out_of_range &) {
-        notifyAll(&INotifier::reject, id, board::ReasonReject::incorrectCoordinate);
+    if (!from_index.valid())
+    {
+        queueEvent(&INotifier::reject, id, board::ReasonReject::incorrectCoordinate);
+        return;
+    }
+    auto &from_cell = getCell(from_index);
+    if (from_cell.first == id) {
+        auto from_coordinate = toCoordinate(from_index);
+        from_cell.first = sEmptyCell;
+        mOccupancy.reset(from_coordinate);
+        mIds.erase(id);
+        queueEvent(&INotifier::removed, id, from_coordinate);
+        do_check_waiting(from_index);
+    } else {
+        queueEvent(&INotifier::reject, id, board::ReasonReject::idMismatch);
     }
 }
 
-void ChessBoardImpl::do_check_waiting(const Coordinate &current_coordinate)
+void ChessBoardImpl::do_check_waiting(CellIndex current_index)
 {
-    auto &to_cell = getCell(current_coordinate);
+    auto &to_cell = getCell(current_index);
     auto &waiting_list = to_cell.second;
 
     bool flag = true;
     while (!waiting_list.empty() && flag)
     {
         auto &wait_element = waiting_list.front();
-        if (mIds.find(wait_element.first) != mIds.end())
-        {
-            if (wait_element.second != invalidCoordinate)
+        if (wait_element.mFrom.valid() && !owns(wait_element.mFrom))
+        {   // a figure of another partition: the cell is reserved until its source commits the move
+            mStatistic->recordWaitGranted(Clock::now() - wait_element.mSince);
+            auto current_coordinate = toCoordinate(current_index);
+            to_cell.first = wait_element.mId;
+            mOccupancy.set(current_coordinate);
+            mIds.insert(wait_element.mId);
+            mPeer->handOff({wait_element.mId, HandOff::Type::granted, wait_element.mPiece, false,
+                            toCoordinate(wait_element.mFrom), current_coordinate});
+            flag = false;
+        } else if (mIds.find(wait_element.mId) != mIds.end()) {
+            mStatistic->recordWaitGranted(Clock::now() - wait_element.mSince);
+            if (wait_element.mFrom.valid())
             {
-                flag = false;
-                do_move(wait_element.first, wait_element.second, current_coordinate);
+                do_move(wait_element.mId, wait_element.mPiece, wait_element.mFrom, current_index);
+                // a blocked path leaves the cell to the next waiter
+                flag = to_cell.first == sEmptyCell;
             } else {
-                to_cell.first = wait_element.first;
-                notifyAll(&INotifier::placed, wait_element.first, current_coordinate);
+                auto current_coordinate = toCoordinate(current_index);
+                to_cell.first = wait_element.mId;
+                mOccupancy.set(current_coordinate);
+                queueEvent(&INotifier::placed, wait_element.mId, current_coordinate);
                 flag = false;
             }
         }
@@ -301,11 +641,262 @@ void ChessBoardImpl::do_check_waiting(const Coordinate &current_coordinate)
     }
 }
 
-template<typename Func, typename... Args>
-void ChessBoardImpl::notifyAll(Func &&func, Args&&... args) const
+void ChessBoardImpl::do_hand_off(const Task &task)
+{   // mFrom is a cell of the source partition, mTo one of the target
+    using namespace board;
+
+    if (!task.mFrom.valid() || !task.mTo.valid() || !mPeer)
+    {
+        return;
+    }
+    auto id = task.mId;
+    auto &from_cell = getCell(task.mFrom);
+    auto &to_cell = getCell(task.mTo);
+    auto from_coordinate = toCoordinate(task.mFrom);
+    auto to_coordinate = toCoordinate(task.mTo);
+    switch (task.mTypeTask) {
+        case Task::Type::prepare:
+            if (to_cell.first == sEmptyCell) {
+                to_cell.first = id;
+                mOccupancy.set(to_coordinate);
+                mIds.insert(id);
+                mPeer->handOff({id, HandOff::Type::granted, task.mPiece, false, from_coordinate, to_coordinate});
+            } else {
+                to_cell.second.emplace_back(id, task.mFrom, task.mPiece);
+                mStatistic->recordWaitDepth(to_cell.second.size());
+                mPeer->handOff({id, HandOff::Type::waiting, task.mPiece, false, from_coordinate, to_coordinate});
+            }
+            break;
+        case Task::Type::waiting:
+            if (from_cell.first == id)
+            {
+                queueEvent(&INotifier::waitingForCell, id, from_coordinate, to_coordinate);
+            }
+            break;
+        case Task::Type::granted:
+            if (from_cell.first == id) {
+                from_cell.first = sEmptyCell;
+                mOccupancy.reset(from_coordinate);
+                mIds.erase(id);
+                queueEvent(&INotifier::moved, id, from_coordinate, to_coordinate);
+                do_check_waiting(task.mFrom);
+            } else {
+                // removed or moved on while it waited, nobody takes the reservation
+                mPeer->handOff({id, HandOff::Type::abort, task.mPiece, false, from_coordinate, to_coordinate});
+            }
+            break;
+        case Task::Type::abort:
+            if (to_cell.first == id)
+            {
+                to_cell.first = sEmptyCell;
+                mOccupancy.reset(to_coordinate);
+                mIds.erase(id);
+                do_check_waiting(task.mTo);
+            }
+            break;
+        case Task::Type::cancelHandOff:
+        {
+            auto &wait_list = to_cell.second;
+            auto it = std::find_if(wait_list.begin(), wait_list.end(), [&](auto &item) {
+                return item.mId == id && item.mFrom == task.mFrom;
+            });
+            auto found = it != wait_list.end();
+            if (found)
+            {
+                mStatistic->recordWaitCancelled(Clock::now() - it->mSince);
+                wait_list.erase(it);
+            }
+            mPeer->handOff({id, HandOff::Type::cancelled, task.mPiece, found, from_coordinate, to_coordinate});
+            break;
+        }
+        case Task::Type::cancelled:
+            queueEvent(&INotifier::cancelMoved, id, from_coordinate, to_coordinate);
+            break;
+        case Task::Type::notCancelled:
+            queueEvent(&INotifier::reject, id, board::ReasonReject::waiterNotFound);
+            break;
+        default:
+            break;
+    }
+}
+
+void ChessBoardImpl::do_stop()
+{   // hosted counterpart of onStop, later tasks are rejected by drain
+    for (auto id: mIds)
+    {
+        queueEvent(&board::INotifier::reject, id, board::ReasonReject::boardStopped);
+    }
+    {
+        std::lock_guard lock(mMutexTasks);
+        mTaskList.clear();
+        mUrgentList.clear();
+    }
+    flushEvents();
+}
+
+void ChessBoardImpl::do_reset()
+{   // under mMutexTasks with no task left; a stale waiter stays only in the list of an occupied cell,
+    // the lists of free cells were emptied when they were freed
+    mOccupancy.occupied(mOccupied);
+    for (auto &coordinate: mOccupied)
+    {
+        auto &cell = getCell(toIndex(coordinate));
+        cell.first = sEmptyCell;
+        cell.second.clear();
+        mOccupancy.reset(coordinate);
+    }
+    mIds.clear();
+}
+
+void ChessBoardImpl::coalesce(Task &task)
+{   // under mMutexTasks; the places and moves of a figure are in mTaskList in their order
+    auto before = mTaskList.size() + mUrgentList.size();
+    if (task.mTypeTask == Task::Type::cancelMove)
+    {   // a cancel that meets the move it cancels takes it out and answers for both
+        auto last = std::find_if(mTaskList.rbegin(), mTaskList.rend(), [&task](const Task &queued) {
+            return queued.mId == task.mId && queued.mTypeTask == Task::Type::move;
+        });
+        if (last != mTaskList.rend() && last->mFrom == task.mFrom && last->mTo == task.mTo)
+        {
+            mTaskList.erase(std::next(last).base());
+            task.mTypeTask = Task::Type::cancelQueued;
+        }
+    } else if (task.mTypeTask == Task::Type::remove) {
+        // a removed figure needs no answer to its earlier moves and cancels
+        auto superseded = [&task](const Task &queued) {
+            return queued.mId == task.mId
+                && (queued.mTypeTask == Task::Type::move
+                    || queued.mTypeTask == Task::Type::cancelMove
+                    || queued.mTypeTask == Task::Type::cancelQueued);
+        };
+        mTaskList.remove_if(superseded);
+        mUrgentList.remove_if(superseded);
+    }
+    if (auto dropped = before - mTaskList.size() - mUrgentList.size())
+    {
+        mStatistic->recordCoalesced(dropped);
+        if (mCapacity != sUnbounded)
+        {
+            mWaitSpace.notify_all();
+        }
+    }
+}
+
+std::list<ChessBoardImpl::Task> *ChessBoardImpl::nextLane()
+{   // under mMutexTasks
+    if (mUrgentList.empty())
+    {
+        mUrgentRun = 0;
+        return mTaskList.empty() ? nullptr : &mTaskList;
+    }
+    if (mTaskList.empty() || mDrainPolicy == DrainPolicy::strict || mUrgentRun < mUrgentWeight)
+    {
+        ++mUrgentRun;
+        return &mUrgentList;
+    }
+    mUrgentRun = 0;
+    return &mTaskList;
+}
+
+void ChessBoardImpl::drain()
 {
-    std::unique_lock lock(mMutexNotifier);
-    for (auto &notifier: mListNotifiers) {
-        std::invoke(std::forward<Func>(func), *notifier, std::forward<Args>(args)...);
+    std::unique_lock lock(mMutexTasks);
+    mDrainPosted = false;
+    while (auto lane = nextLane())
+    {
+        auto task = std::move(lane->front());
+        lane->pop_front();
+        auto stopped = mReasonWeakUp == ReasonWeakUp::stop || mReasonWeakUp == ReasonWeakUp::exit;
+        lock.unlock();
+        if (stopped)
+        {
+            queueEvent(&board::INotifier::reject, task.mId, board::ReasonReject::boardStopped);
+        } else {
+            do_task(task);
+        }
+        if (mEvents.size() >= sMaxBatchEvents)
+        {
+            flushEvents();
+        }
+        lock.lock();
+    }
+    lock.unlock();
+    flushEvents();
+}
+
+BoardStatistic::Operation ChessBoardImpl::toOperation(const Task &task)
+{
+    switch (task.mTypeTask) {
+        case Task::Type::place:
+            return BoardStatistic::Operation::place;
+        case Task::Type::move:
+        case Task::Type::prepare:
+        case Task::Type::waiting:
+        case Task::Type::granted:
+        case Task::Type::abort:
+            return BoardStatistic::Operation::move;
+        case Task::Type::cancelMove:
+        case Task::Type::cancelQueued:
+        case Task::Type::cancelHandOff:
+        case Task::Type::cancelled:
+        case Task::Type::notCancelled:
+            return BoardStatistic::Operation::cancelMove;
+        case Task::Type::remove:
+            return BoardStatistic::Operation::remove;
+    }
+    return BoardStatistic::Operation::place;
+}
+
+void ChessBoardImpl::wakeUp(ReasonWeakUp reason)
+{   // a less important reason never overrides a pending exit/stop
+    if (reason < mReasonWeakUp)
+    {
+        mReasonWeakUp = reason;
+    }
+    if (reason == ReasonWeakUp::stop || reason == ReasonWeakUp::exit)
+    {
+        mWaitSpace.notify_all();
+    }
+    if (!mStrand)
+    {
+        mWait.notify_all();
+    } else if (reason == ReasonWeakUp::do_work && !mDrainPosted) {
+        mDrainPosted = true;
+        mStrand->post([board = shared_from_this()]() {
+            board->drain();
+        });
+    }
+}
+
+void ChessBoardImpl::flushEvents()
+{   // without mMutexTasks, a notifier may submit its next command from the handler
+    if (mEvents.empty())
+    {
+        return;
+    }
+    {
+        Tracer::Scope scope("flushEvents");
+        std::unique_lock lock(mMutexNotifier);
+        for (auto &notifier: mListNotifiers) {
+            notifier->onEvents(mEvents.data(), mEvents.size());
+        }
+    }
+    auto delivered = Clock::now();
+    for (std::size_t i = 0; i < mEvents.size(); ++i)
+    {
+        if (mEventsSubmitted[i] != Clock::time_point())
+        {
+            mStatistic->recordOutcome(static_cast<BoardStatistic::Outcome>(mEvents[i].mType), mEvents[i].mReason,
+                                      delivered - mEventsSubmitted[i]);
+        }
     }
+    mEvents.clear();
+    mEventsSubmitted.clear();
+}
+
+template<typename Func, typename... Args>
+void ChessBoardImpl::queueEvent(Func &&func, Args&&... args)
+{   // on the board thread; commands that are not timed (stop) get an epoch submit time
+    mEvents.push_back(toEvent(func, args...));
+    mEventsSubmitted.push_back(mCurrentTask ? mCurrentTask->mSubmitted : Clock::time_point());
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include <utility>
@@ -12,20 +13,44 @@
 #include "IGameElement.h"
 #include "IChessBoard.h"
 #include "TreadBase.h"
+#include "BoardStatistic.h"
+#include "IChessMan.h"
+#include "Occupancy.h"
+#include "Partition.h"
 
 class IState;
+class Strand;
 
 class ChessBoardImpl
         : public board::IChessBoard
         , public IGameElement
         , public TreadBase
+        , public std::enable_shared_from_this<ChessBoardImpl>
 {
 public:
-    explicit ChessBoardImpl(std::uint8_t sizeBoard);
+    enum class OverloadPolicy;
+    enum class DrainPolicy;
+
+    // with blockingSliders moves must be legal for the piece and rooks, bishops and queens
+    // may not pass over occupied cells, otherwise figures jump anywhere
+    explicit ChessBoardImpl(std::uint8_t sizeBoard, bool blockingSliders = false);
+    // at most `capacity` place and move commands queued, the policy decides about the next one;
+    // cancels and removes are always queued so that a full board can still be drained
+    ChessBoardImpl(std::uint8_t sizeBoard, bool blockingSliders, std::size_t capacity, OverloadPolicy policy);
+    // hosted: no thread of its own, the tasks run on `strand` and the latencies go to a statistic
+    // shared with other boards; must be owned by a shared_ptr. The queue is unbounded, a producer
+    // blocked on the strand would never see it drained
+    ChessBoardImpl(std::uint8_t sizeBoard, bool blockingSliders, std::shared_ptr<Strand> strand,
+                   std::shared_ptr<BoardStatistic> statistic);
     ~ChessBoardImpl() override;
 
     void startGame() override;
     void stopGame() override;
+    // empties a running board for the next game without a new board or thread: the board thread
+    // finishes the tasks queued before, then clears the occupied cells and their waiters; the
+    // notifiers of the last game must be gone, the statistic keeps counting. Throws
+    // std::logic_error for a hosted or stopped board
+    void reset();
 
     void addNotifier(std::shared_ptr<board::INotifier> notifier) override;
     void removeNotifier(std::shared_ptr<board::INotifier> notifier) override;
@@ -34,64 +59,173 @@ public:
     void placeFigure(const chessman::IChessMan &figure, const board::Coordinate &to) override;
     void removeFigure(const chessman::IChessMan &figure) override;
     void cancelMoveFigure(const chessman::IChessMan &figure, const board::Coordinate &to) override;
+    // try-submit: false instead of waiting or notifying when the queue is full, whatever the policy
+    bool tryPlaceFigure(const chessman::IChessMan &figure, const board::Coordinate &to);
+    bool tryMoveFigure(const chessman::IChessMan &figure, const board::Coordinate &to);
 
     uint8_t sizeBoard() const noexcept override;
+    void legalDestinations(const chessman::IChessMan &figure, std::vector<board::Coordinate> &destinations) const override;
+    bool sampleDestination(const chessman::IChessMan &figure, std::uint32_t random, board::Coordinate &to) const override;
+
+    const BoardStatistic &statistic() const noexcept;
+    // the most commands ever queued at once
+    std::size_t queueHighWater() const noexcept;
+    // the order in which queued commands run, fifo by default; may change while the board runs.
+    // Throws std::invalid_argument for a weighted policy with a zero weight
+    void setDrainPolicy(DrainPolicy policy, std::size_t urgentWeight = sDefaultUrgentWeight);
+
+    // makes the board one partition of a larger one, see Partition.h: it serves only the rows of
+    // the partition and hands figures over to the others through `peer`. The cells and the
+    // occupancy of the whole board stay allocated, those of the other rows stay empty. Must be
+    // set before the first command; throws std::invalid_argument for a partition that does not
+    // fit the board, and with blocking sliders, whose paths may cross partitions
+    void setPartition(const board::Partition &partition, std::shared_ptr<board::IHandOffPeer> peer);
+    // a hand-off message from another partition, queued like a cancel
+    void handOff(const board::HandOff &message);
+
+    static constexpr std::size_t sUnbounded = 0;
+    static constexpr std::size_t sDefaultUrgentWeight = 4;
 
 protected:
     void loop() override;
     void onStop() override;
 
 private:
-    using Waiting_t = std::pair<std::uint32_t /* id */, board::Coordinate /* from */>;
+    struct Waiting_t;
     using Cell_t = std::pair<std::uint32_t /* sEmptyCell/id */, std::list<Waiting_t>>;
-    using Row_t = std::vector<Cell_t>;
-    using Board_t = std::vector<Row_t>;
+    using Board_t = std::vector<Cell_t>; // by CellIndex
     struct Task;
     enum class ReasonWeakUp;
+    using Clock = std::chrono::steady_clock;
 
-    Board_t::value_type::const_reference getCell(const board::Coordinate &coordinate) const;
-    Board_t::value_type::reference getCell(const board::Coordinate &coordinate);
+    ChessBoardImpl(std::uint8_t sizeBoard, bool blockingSliders, std::size_t capacity, OverloadPolicy policy,
+                   std::shared_ptr<Strand> strand, std::shared_ptr<BoardStatistic> statistic);
+
+    // the index must be valid, it is checked once at submit
+    Board_t::const_reference getCell(board::CellIndex index) const;
+    Board_t::reference getCell(board::CellIndex index);
+    board::CellIndex toIndex(const board::Coordinate &coordinate) const noexcept;
+    board::Coordinate toCoordinate(board::CellIndex index) const noexcept;
+    bool owns(board::CellIndex index) const noexcept;
+    bool submit(const Task &task, bool tryOnly);
+    void coalesce(Task &task);
+    std::list<Task> *nextLane();
+    void notifyOverloaded(std::uint32_t id);
     void do_task(const Task &task);
-    void do_place(std::uint32_t id, const board::Coordinate &to_coordinate);
-    void do_move(std::uint32_t id, const board::Coordinate &from_coordinate, const board::Coordinate &to_coordinate);
-    void do_cancel_move(std::uint32_t id, const board::Coordinate &from_coordinate, const board::Coordinate &to_coordinate);
-    void do_remove(std::uint32_t id, const board::Coordinate &from_coordinate);
-    void do_check_waiting(const board::Coordinate &current_coordinate);
+    void do_place(std::uint32_t id, board::CellIndex to_index);
+    void do_move(std::uint32_t id, chessman::ChessmanType piece, board::CellIndex from_index, board::CellIndex to_index);
+    void do_cancel_move(std::uint32_t id, chessman::ChessmanType piece, board::CellIndex from_index,
+                        board::CellIndex to_index);
+    void do_remove(std::uint32_t id, board::CellIndex from_index);
+    void do_check_waiting(board::CellIndex current_index);
+    void do_hand_off(const Task &task);
+    void do_stop();
+    void do_reset();
+    void drain();
+    void wakeUp(ReasonWeakUp reason);
+    // delivers the queued notifications, one onEvents per notifier
+    void flushEvents();
+    static BoardStatistic::Operation toOperation(const Task &task);
 
+    // the notification goes out with the next flushEvents
     template<typename Func, typename... Args>
-    void notifyAll(Func &&func, Args&&... args) const;
+    void queueEvent(Func &&func, Args&&... args);
 
     std::mutex mMutexTasks;
     std::condition_variable mWait;
+    std::condition_variable mWaitSpace; // producers of a full queue, blocking policy only
     ReasonWeakUp mReasonWeakUp;
-    std::list<Task> mTaskList;
+    std::list<Task> mTaskList;   // place and move, or every command with the fifo policy
+    std::list<Task> mUrgentList; // cancelMove and remove, they free cells
+    DrainPolicy mDrainPolicy;
+    std::size_t mUrgentWeight;
+    std::size_t mUrgentRun;      // urgent tasks run since the last task of mTaskList
+    bool mResetPending;
+    const std::size_t mCapacity;
+    const OverloadPolicy mPolicy;
+    std::atomic<std::size_t> mHighWater;
 
     mutable std::recursive_mutex mMutexNotifier;
     std::vector<std::shared_ptr<board::INotifier>> mListNotifiers;
+    // copy of mListNotifiers for producers, read without waiting for a notification in progress
+    std::shared_ptr<const std::vector<std::shared_ptr<board::INotifier>>> mOverloadNotifiers;
 
+    const std::uint8_t mSizeBoard;
     Board_t mBoard;
     std::set<std::uint32_t> mIds;
+    Occupancy mOccupancy;        // written by the board thread, read by legalDestinations without a lock
+    std::vector<board::Coordinate> mOccupied; // scratch of do_reset
+    const bool mBlockingSliders;
+    board::Partition mPartition;                 // the whole board unless setPartition
+    std::shared_ptr<board::IHandOffPeer> mPeer;
+
+    const std::shared_ptr<Strand> mStrand; // hosted boards only
+    bool mDrainPosted;
+    const std::shared_ptr<BoardStatistic> mStatistic;
+    const Task *mCurrentTask;
+    // notifications of the batch in progress, board thread only
+    std::vector<board::BoardEvent> mEvents;
+    std::vector<Clock::time_point> mEventsSubmitted; // the epoch for an untimed notification
+    // a long batch is flushed early so that figures are not kept waiting for the whole queue
+    static constexpr std::size_t sMaxBatchEvents = 64;
+};
+
+enum class ChessBoardImpl::OverloadPolicy
+{
+    block,  // the producer waits until the board thread frees a slot
+    reject  // the command is dropped and the figure gets ReasonReject::overloaded at once
+};
+
+enum class ChessBoardImpl::DrainPolicy
+{
+    fifo,     // one lane, commands run in the order they were submitted
+    strict,   // cancels and removes run before any queued place or move
+    weighted  // up to urgentWeight cancels and removes per place or move
 };
 
 struct ChessBoardImpl::Task {
     enum class Type {
-        place, move, cancelMove, remove
+        place, move, cancelMove, remove,
+        cancelQueued, // a cancel that took its move out of the queue, the figure never left its cell
+        // hand-off messages between partitions, see board::HandOff, all from prepare on; a found
+        // cancel is cancelled
+        prepare, waiting, granted, abort, cancelHandOff, cancelled, notCancelled
     };
     Task(Type type,
          std::uint32_t id,
-         board::Coordinate from,
-         board::Coordinate to)
+         board::CellIndex from,
+         board::CellIndex to,
+         chessman::ChessmanType piece = chessman::ChessmanType::rook)
          : mId(id)
          , mTypeTask(type)
-         , mFromCoordinate(std::move(from))
-         , mToCoordinate(std::move(to))
+         , mFrom(from)
+         , mTo(to)
+         , mPiece(piece)
+         , mSubmitted(Clock::now())
     {
 
     }
     std::uint32_t mId;
     Type mTypeTask;
-    const board::Coordinate mFromCoordinate;
-    const board::Coordinate mToCoordinate;
+    const board::CellIndex mFrom;   // invalid for a cell outside the board, answered incorrectCoordinate
+    const board::CellIndex mTo;
+    const chessman::ChessmanType mPiece;   // fills padding, a task stays 24 bytes
+    const Clock::time_point mSubmitted;
+};
+
+struct ChessBoardImpl::Waiting_t {
+    Waiting_t(std::uint32_t id, board::CellIndex from, chessman::ChessmanType piece = chessman::ChessmanType::rook)
+        : mId(id)
+        , mFrom(from)
+        , mPiece(piece)
+        , mSince(Clock::now())
+    {
+
+    }
+    std::uint32_t mId;
+    board::CellIndex mFrom;    // invalid for a pending placement
+    chessman::ChessmanType mPiece;
+    Clock::time_point mSince;
 };
 
 enum class ChessBoardImpl::ReasonWeakUp
@@ -99,12 +233,27 @@ enum class ChessBoardImpl::ReasonWeakUp
     exit, stop, do_work, fake,
 };
 
-inline ChessBoardImpl::Board_t::value_type::reference ChessBoardImpl::getCell(const board::Coordinate &coordinate)
+inline ChessBoardImpl::Board_t::reference ChessBoardImpl::getCell(board::CellIndex index)
+{
+    return mBoard[index.value()];
+}
+
+inline ChessBoardImpl::Board_t::const_reference ChessBoardImpl::getCell(board::CellIndex index) const
+{
+    return mBoard[index.value()];
+}
+
+inline bool ChessBoardImpl::owns(board::CellIndex index) const noexcept
+{
+    return mPartition.owns(toCoordinate(index));
+}
+
+inline board::CellIndex ChessBoardImpl::toIndex(const board::Coordinate &coordinate) const noexcept
 {
-    return mBoard.at(coordinate.first).at(coordinate.second);
+    return board::CellIndex::fromCoordinate(coordinate, mSizeBoard);
 }
 
-inline ChessBoardImpl::Board_t::value_type::const_reference ChessBoardImpl::getCell(const board::Coordinate &coordinate) const
+inline board::Coordinate ChessBoardImpl::toCoordinate(board::CellIndex index) const noexcept
 {
-    return mBoard.at(coordinate.first).at(coordinate.second);
+    return index.toCoordinate(mSizeBoard);
 }
@@ -0,0 +1,292 @@
+#include <cerrno>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "EventBus.h"
+
+using namespace eventbus;
+
+static_assert(sizeof(Header) == 64, "the slots start on a cache line");
+static_assert(sizeof(Slot) == 32, "two slots per cache line");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared between processes");
+
+static std::string segmentPath(const std::string &name)
+{
+    return name.empty() || name.front() != '/' ? "/" + name : name;
+}
+
+static std::uint64_t stamp(std::uint64_t sequence)
+{
+    return 2 * sequence + 2;
+}
+
+static std::uint64_t packCoordinate(const board::Coordinate &coordinate)
+{
+    return static_cast<std::uint8_t>(coordinate.first) | static_cast<std::uint64_t>(
+            static_cast<std::uint8_t>(coordinate.second)) << 8u;
+}
+
+static board::Coordinate unpackCoordinate(std::uint64_t word)
+{
+    return {static_cast<std::int8_t>(word & 0xFFu), static_cast<std::int8_t>((word >> 8u) & 0xFFu)};
+}
+
+EventBus::EventBus(std::string name, std::size_t capacity)
+    : mName(segmentPath(name))
+    , mSize(sizeof(Header) + capacity * sizeof(Slot))
+    , mHeader(nullptr)
+    , mSlots(nullptr)
+    , mMask(capacity - 1)
+    , mDevice(0)
+    , mInode(0)
+{
+    if (!capacity || (capacity & (capacity - 1)) || capacity > UINT32_MAX)
+    {
+        throw std::invalid_argument("EventBus: capacity must be a power of two");
+    }
+    // a fresh segment: truncating a mapped one would fault its readers or strand them past the head
+    ::shm_unlink(mName.c_str());
+    auto fd = ::shm_open(mName.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "shm_open " + mName);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(mSize)) < 0)
+    {
+        auto error = errno;
+        ::close(fd);
+        ::shm_unlink(mName.c_str());
+        throw std::system_error(error, std::generic_category(), "ftruncate " + mName);
+    }
+    struct stat status{};
+    ::fstat(fd, &status);
+    mDevice = status.st_dev;
+    mInode = status.st_ino;
+    auto base = ::mmap(nullptr, mSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    auto error = errno;
+    ::close(fd);
+    if (base == MAP_FAILED)
+    {
+        ::shm_unlink(mName.c_str());
+        throw std::system_error(error, std::generic_category(), "mmap " + mName);
+    }
+    // the new segment is zero: every stamp is below the stamp of any event
+    mHeader = new (base) Header();
+    mHeader->mVersion = sVersion;
+    mHeader->mCapacity = static_cast<std::uint32_t>(capacity);
+    mHeader->mHead.store(0, std::memory_order_relaxed);
+    mSlots = reinterpret_cast<Slot *>(static_cast<char *>(base) + sizeof(Header));
+    mHeader->mMagic.store(sMagic, std::memory_order_release);
+}
+
+EventBus::~EventBus()
+{
+    ::munmap(mHeader, mSize);
+    if (auto fd = ::shm_open(mName.c_str(), O_RDONLY | O_CLOEXEC, 0); fd >= 0)
+    {
+        struct stat status{};
+        auto own = ::fstat(fd, &status) == 0 && status.st_dev == mDevice && status.st_ino == mInode;
+        ::close(fd);
+        if (own)
+        {
+            ::shm_unlink(mName.c_str());
+        }
+    }
+}
+
+const std::string &EventBus::name() const noexcept
+{
+    return mName;
+}
+
+std::uint64_t EventBus::published() const noexcept
+{
+    return mHeader->mHead.load(std::memory_order_relaxed);
+}
+
+/* ************************************************************
+ * IMPL board::INotifier
+ * ************************************************************/
+void EventBus::placed(std::uint32_t id, const board::Coordinate &to) noexcept
+{
+    publish({id, board::BoardEvent::Type::placed, board::ReasonReject::empty, board::invalidCoordinate, to});
+}
+
+void EventBus::moved(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept
+{
+    publish({id, board::BoardEvent::Type::moved, board::ReasonReject::empty, from, to});
+}
+
+void EventBus::cancelMoved(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept
+{
+    publish({id, board::BoardEvent::Type::cancelMoved, board::ReasonReject::empty, from, to});
+}
+
+void EventBus::removed(std::uint32_t id, const board::Coordinate &from) noexcept
+{
+    publish({id, board::BoardEvent::Type::removed, board::ReasonReject::empty, from, board::invalidCoordinate});
+}
+
+void EventBus::waitingForCell(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept
+{
+    publish({id, board::BoardEvent::Type::waitingForCell, board::ReasonReject::empty, from, to});
+}
+
+void EventBus::reject(std::uint32_t id, board::ReasonReject reason) noexcept
+{
+    publish({id, board::BoardEvent::Type::reject, reason, board::invalidCoordinate, board::invalidCoordinate});
+}
+
+void EventBus::onEvents(const board::BoardEvent *events, std::size_t count) noexcept
+{
+    for (auto event = events; event != events + count; ++event)
+    {
+        publish(*event);
+    }
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+void EventBus::publish(const board::BoardEvent &event) noexcept
+{   // writers a lap apart never meet in one slot while the ring is larger than a burst
+    auto sequence = mHeader->mHead.fetch_add(1, std::memory_order_relaxed);
+    auto &slot = mSlots[sequence & mMask];
+    auto published = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    slot.mStamp.store(stamp(sequence) - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.mWords[0].store(event.mId
+                         | static_cast<std::uint64_t>(event.mType) << 32u
+                         | static_cast<std::uint64_t>(event.mReason) << 40u
+                         | packCoordinate(event.mFrom) << 48u, std::memory_order_relaxed);
+    slot.mWords[1].store(packCoordinate(event.mTo), std::memory_order_relaxed);
+    slot.mWords[2].store(static_cast<std::uint64_t>(published), std::memory_order_relaxed);
+    slot.mStamp.store(stamp(sequence), std::memory_order_release);
+}
+
+/* ************************************************************
+ * IMPL EventBusReader
+ * ************************************************************/
+EventBusReader::EventBusReader(const std::string &name, bool fromOldest)
+    : mSize(0)
+    , mHeader(nullptr)
+    , mSlots(nullptr)
+    , mMask(0)
+    , mNext(0)
+    , mLost(0)
+{
+    auto path = segmentPath(name);
+    auto fd = ::shm_open(path.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "shm_open " + path);
+    }
+    struct stat status{};
+    if (::fstat(fd, &status) < 0)
+    {
+        auto error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "fstat " + path);
+    }
+    mSize = static_cast<std::size_t>(status.st_size);
+    if (mSize < sizeof(Header))
+    {
+        ::close(fd);
+        throw std::invalid_argument("EventBusReader: " + path + " is not an event bus");
+    }
+    auto base = ::mmap(nullptr, mSize, PROT_READ, MAP_SHARED, fd, 0);
+    auto error = errno;
+    ::close(fd);
+    if (base == MAP_FAILED)
+    {
+        throw std::system_error(error, std::generic_category(), "mmap " + path);
+    }
+    mHeader = static_cast<const Header *>(base);
+    if (mHeader->mMagic.load(std::memory_order_acquire) != sMagic || mHeader->mVersion != sVersion
+        || mSize != sizeof(Header) + std::size_t(mHeader->mCapacity) * sizeof(Slot))
+    {
+        ::munmap(base, mSize);
+        throw std::invalid_argument("EventBusReader: " + path + " is not an event bus of version "
+                                    + std::to_string(sVersion));
+    }
+    mSlots = reinterpret_cast<const Slot *>(static_cast<const char *>(base) + sizeof(Header));
+    mMask = mHeader->mCapacity - 1;
+    mNext = mHeader->mHead.load(std::memory_order_acquire);
+    if (fromOldest)
+    {
+        mNext = mNext > mHeader->mCapacity ? mNext - mHeader->mCapacity : 0;
+    }
+}
+
+EventBusReader::~EventBusReader()
+{
+    ::munmap(const_cast<Header *>(mHeader), mSize);
+}
+
+std::size_t EventBusReader::poll(Record *records, std::size_t max)
+{
+    auto head = mHeader->mHead.load(std::memory_order_acquire);
+    std::size_t count = 0;
+    while (count < max && mNext < head)
+    {
+        if (head - mNext > mHeader->mCapacity)
+        {   // a lap behind, the older slots are gone
+            mLost += head - mHeader->mCapacity - mNext;
+            mNext = head - mHeader->mCapacity;
+        }
+        auto &slot = mSlots[mNext & mMask];
+        auto before = slot.mStamp.load(std::memory_order_acquire);
+        if (before < stamp(mNext))
+        {   // claimed, the writer is not done yet
+            break;
+        }
+        if (before == stamp(mNext))
+        {
+            std::uint64_t words[3];
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                words[i] = slot.mWords[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.mStamp.load(std::memory_order_relaxed) == before)
+            {
+                auto &record = records[count++];
+                record.mSequence = mNext;
+                record.mPublished = std::chrono::nanoseconds(words[2]);
+                record.mEvent.mId = static_cast<std::uint32_t>(words[0]);
+                record.mEvent.mType = static_cast<board::BoardEvent::Type>((words[0] >> 32u) & 0xFFu);
+                record.mEvent.mReason = static_cast<board::ReasonReject>((words[0] >> 40u) & 0xFFu);
+                record.mEvent.mFrom = unpackCoordinate(words[0] >> 48u);
+                record.mEvent.mTo = unpackCoordinate(words[1]);
+                ++mNext;
+                continue;
+            }
+        }
+        // overwritten by a later lap while or before it was read
+        ++mLost;
+        ++mNext;
+    }
+    return count;
+}
+
+std::uint64_t EventBusReader::next() const noexcept
+{
+    return mNext;
+}
+
+std::uint64_t EventBusReader::lost() const noexcept
+{
+    return mLost;
+}
+
+std::size_t EventBusReader::capacity() const noexcept
+{
+    return mHeader->mCapacity;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "IChessBoard.h"
+
+/*
+ * Board events in a ring of POSIX shared memory (/dev/shm/<name>) for observers in other
+ * processes. Every event gets the next sequence number and goes to slot sequence % capacity;
+ * a slot is a seqlock, so the publisher never waits for a reader: a reader that falls more than
+ * a ring behind finds its slots overwritten, skips them and counts them as lost.
+ *
+ * Layout, version sVersion: a 64-byte Header, then `capacity` 32-byte Slots. A slot holds the
+ * sequence stamp 2 * n + 2 of event n once written (2 * n + 1 while it is written) and three
+ * words: id, kind, reason and from; to; the steady_clock time of publishing in ns, which is
+ * CLOCK_MONOTONIC and so comparable between processes of one host.
+ */
+namespace eventbus {
+
+struct Header
+{
+    std::atomic<std::uint64_t> mMagic; // sMagic once the ring is ready
+    std::uint32_t mVersion;
+    std::uint32_t mCapacity;           // slots, a power of two
+    std::atomic<std::uint64_t> mHead;  // sequence of the next event
+    std::uint64_t mReserved[5];
+};
+
+struct alignas(32) Slot
+{
+    std::atomic<std::uint64_t> mStamp;
+    std::atomic<std::uint64_t> mWords[3];
+};
+
+struct Record
+{
+    std::uint64_t mSequence;
+    std::chrono::nanoseconds mPublished; // steady_clock time since epoch
+    board::BoardEvent mEvent;
+};
+
+static constexpr std::uint64_t sMagic = 0x5355424B4F4F52ull; // "ROOKBUS"
+static constexpr std::uint32_t sVersion = 1;
+
+} // eventbus
+
+/*
+ * The writing side, a notifier of a board. Unlinks a segment of the same name and creates a new
+ * one, and unlinks it when destroyed unless a newer bus took the name over; readers of an
+ * unlinked segment keep their mapping of it but
+ * see no new events, they must open the bus again. Publishing is a
+ * fetch_add and four stores, safe from the board thread and from producers that are answered
+ * overloaded at the same time.
+ */
+class EventBus : public board::INotifier
+{
+public:
+    // throws std::invalid_argument for a capacity that is not a power of two,
+    // std::system_error when the segment cannot be created
+    EventBus(std::string name, std::size_t capacity = sDefaultCapacity);
+    ~EventBus() override;
+
+    const std::string &name() const noexcept;
+    std::uint64_t published() const noexcept;
+
+    void placed(std::uint32_t id, const board::Coordinate &to) noexcept override;
+    void moved(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
+    void cancelMoved(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
+    void removed(std::uint32_t id, const board::Coordinate &from) noexcept override;
+    void waitingForCell(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
+    void reject(std::uint32_t id, board::ReasonReject reason) noexcept override;
+    void onEvents(const board::BoardEvent *events, std::size_t count) noexcept override;
+
+    static constexpr std::size_t sDefaultCapacity = 1u << 16u;
+
+private:
+    void publish(const board::BoardEvent &event) noexcept;
+
+    const std::string mName;
+    std::size_t mSize;
+    eventbus::Header *mHeader;
+    eventbus::Slot *mSlots;
+    std::uint64_t mMask;
+    std::uint64_t mDevice;  // of the segment, the name may be taken over by a newer bus
+    std::uint64_t mInode;
+};
+
+/*
+ * The reading side, one per consumer, any number of them per segment. Maps the segment read-only
+ * and copies events out slot by slot; it starts at the newest event unless told to start at the
+ * oldest one still in the ring.
+ */
+class EventBusReader
+{
+public:
+    // throws std::system_error when there is no such segment, std::invalid_argument when the
+    // segment is not an event bus of this version
+    explicit EventBusReader(const std::string &name, bool fromOldest = false);
+    ~EventBusReader();
+
+    EventBusReader(const EventBusReader &) = delete;
+    EventBusReader &operator=(const EventBusReader &) = delete;
+
+    // up to `max` events in sequence order, 0 when there is nothing new; stops early at an event
+    // whose writer has not finished yet
+    std::size_t poll(eventbus::Record *records, std::size_t max);
+
+    // sequence of the next event to read
+    std::uint64_t next() const noexcept;
+    // events overwritten before this reader got to them
+    std::uint64_t lost() const noexcept;
+    std::size_t capacity() const noexcept;
+
+private:
+    std::size_t mSize;
+    const eventbus::Header *mHeader;
+    const eventbus::Slot *mSlots;
+    std::uint64_t mMask;
+    std::uint64_t mNext;
+    std::uint64_t mLost;
+};
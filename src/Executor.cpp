@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <thread>
+
+#include "Executor.h"
+
+static bool laterTimer(const Executor::Clock::time_point &at, std::uint64_t sequence,
+                       const Executor::Clock::time_point &otherAt, std::uint64_t otherSequence)
+{
+    return at != otherAt ? at > otherAt : sequence > otherSequence;
+}
+
+class Executor::Worker : public TreadBase
+{
+public:
+    explicit Worker(Executor &executor)
+        : TreadBase("Executor")
+        , mExecutor(executor)
+    {
+        TreadBase::start();
+    }
+
+    ~Worker() override
+    {
+        TreadBase::join();
+    }
+
+protected:
+    void loop() override
+    {
+        mExecutor.run();
+    }
+
+private:
+    Executor &mExecutor;
+};
+
+Executor::Executor(std::size_t threads)
+    : mMutex()
+    , mWait()
+    , mStop(false)
+    , mReady()
+    , mTimers()
+    , mCancelled()
+    , mSequence(0)
+    , mWorkers()
+{
+    if (!threads)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        mWorkers.push_back(std::make_unique<Worker>(*this));
+    }
+}
+
+Executor::~Executor()
+{
+    {
+        std::lock_guard lock(mMutex);
+        mStop = true;
+        mWait.notify_all();
+    }
+    mWorkers.clear();
+    // the tasks may own objects that post again from their destructors
+    std::deque<Task> ready;
+    std::vector<Timer> timers;
+    {
+        std::lock_guard lock(mMutex);
+        ready.swap(mReady);
+        timers.swap(mTimers);
+    }
+}
+
+void Executor::post(Task task)
+{
+    std::lock_guard lock(mMutex);
+    if (!mStop)
+    {
+        mReady.push_back(std::move(task));
+        mWait.notify_one();
+    }
+}
+
+Executor::TimerId Executor::postAt(Clock::time_point at, Task task)
+{
+    auto later = [](const Timer &left, const Timer &right) {
+        return laterTimer(left.mAt, left.mSequence, right.mAt, right.mSequence);
+    };
+    std::lock_guard lock(mMutex);
+    auto timer = mSequence++;
+    if (!mStop)
+    {
+        mTimers.push_back({at, timer, std::move(task)});
+        std::push_heap(mTimers.begin(), mTimers.end(), later);
+        if (mTimers.front().mSequence == timer)
+        {   // a new earliest deadline, a sleeping worker has to wait less
+            mWait.notify_one();
+        }
+    }
+    return timer;
+}
+
+Executor::TimerId Executor::postAfter(std::chrono::nanoseconds delay, Task task)
+{
+    return postAt(Clock::now() + delay, std::move(task));
+}
+
+void Executor::cancel(TimerId timer)
+{
+    auto later = [](const Timer &left, const Timer &right) {
+        return laterTimer(left.mAt, left.mSequence, right.mAt, right.mSequence);
+    };
+    // the tasks may own objects that post again from their destructors
+    std::vector<Task> dropped;
+    std::lock_guard lock(mMutex);
+    if (mStop || timer >= mSequence || !mCancelled.insert(timer).second
+        || mCancelled.size() <= mTimers.size() / 2)
+    {
+        return;
+    }
+    auto kept = mTimers.begin();
+    for (auto &entry: mTimers)
+    {
+        if (mCancelled.count(entry.mSequence))
+        {
+            dropped.push_back(std::move(entry.mTask));
+        } else {
+            *kept++ = std::move(entry);
+        }
+    }
+    mTimers.erase(kept, mTimers.end());
+    std::make_heap(mTimers.begin(), mTimers.end(), later);
+    // marks of timers that were due already go as well
+    mCancelled.clear();
+}
+
+std::size_t Executor::threads() const noexcept
+{
+    return mWorkers.size();
+}
+
+std::size_t Executor::pendingTimers() const
+{
+    std::lock_guard lock(mMutex);
+    return mTimers.size();
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+void Executor::run()
+{
+    auto later = [](const Timer &left, const Timer &right) {
+        return laterTimer(left.mAt, left.mSequence, right.mAt, right.mSequence);
+    };
+    std::unique_lock lock(mMutex);
+    while (!mStop)
+    {
+        auto now = Clock::now();
+        Task dropped;
+        while (!mTimers.empty() && mTimers.front().mAt <= now && !dropped)
+        {
+            std::pop_heap(mTimers.begin(), mTimers.end(), later);
+            if (mCancelled.erase(mTimers.back().mSequence))
+            {
+                dropped = std::move(mTimers.back().mTask);
+            } else {
+                mReady.push_back(std::move(mTimers.back().mTask));
+            }
+            mTimers.pop_back();
+        }
+        if (dropped)
+        {   // destroyed outside of the lock like a task that ran
+            lock.unlock();
+            dropped = nullptr;
+            lock.lock();
+        } else if (!mReady.empty())
+        {
+            auto task = std::move(mReady.front());
+            mReady.pop_front();
+            if (!mReady.empty())
+            {
+                mWait.notify_one();
+            }
+            lock.unlock();
+            task();
+            task = nullptr; // release what the task owns before taking the lock again
+            lock.lock();
+        } else if (mTimers.empty()) {
+            mWait.wait(lock);
+        } else {
+            mWait.wait_until(lock, mTimers.front().mAt);
+        }
+    }
+}
+
+/* ************************************************************
+ * IMPL Strand
+ * ************************************************************/
+Strand::Strand(Executor &executor, Around around)
+    : mExecutor(executor)
+    , mAround(std::move(around))
+    , mMutex()
+    , mTasks()
+    , mScheduled(false)
+    , mBusy(0)
+{
+
+}
+
+void Strand::post(Executor::Task task)
+{
+    std::lock_guard lock(mMutex);
+    mTasks.push_back(std::move(task));
+    if (!mScheduled)
+    {
+        mScheduled = true;
+        mExecutor.post([strand = shared_from_this()]() {
+            strand->drain();
+        });
+    }
+}
+
+std::chrono::nanoseconds Strand::busyTime() const noexcept
+{
+    return std::chrono::nanoseconds(mBusy.load(std::memory_order_relaxed));
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+void Strand::drain()
+{
+    auto started = Executor::Clock::now();
+    auto exhausted = false;
+    auto batch = [this, &exhausted]() {
+        for (std::size_t i = 0; i < sBatch && !exhausted; ++i)
+        {
+            Executor::Task task;
+            {
+                std::lock_guard lock(mMutex);
+                if (mTasks.empty())
+                {   // from here on a post schedules a new drain
+                    mScheduled = false;
+                    exhausted = true;
+                    continue;
+                }
+                task = std::move(mTasks.front());
+                mTasks.pop_front();
+            }
+            task();
+        }
+    };
+    if (mAround)
+    {
+        mAround(batch);
+    } else {
+        batch();
+    }
+    mBusy.fetch_add((Executor::Clock::now() - started).count(), std::memory_order_relaxed);
+    if (exhausted)
+    {
+        return;
+    }
+
+    std::lock_guard lock(mMutex);
+    if (mTasks.empty())
+    {
+        mScheduled = false;
+    } else {   // the batch is used up, queue behind the other strands
+        mExecutor.post([strand = shared_from_this()]() {
+            strand->drain();
+        });
+    }
+}
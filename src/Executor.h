@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "RemoveCopyMove.h"
+#include "TreadBase.h"
+
+/*
+ * A fixed pool of worker threads with a FIFO of ready tasks and a heap of timers. Timers are
+ * moved to the ready queue by whichever worker wakes up first, so a timer fires late by at
+ * most the run time of the task in front of it. A cancelled timer is only marked; it is skipped
+ * when due, and the heap is compacted once the marks outnumber half of it, so re-arming keeps
+ * it at about twice the armed timers. Pending tasks are dropped by the destructor.
+ */
+class Executor : public virtual RemoveCopyMove
+{
+public:
+    using Task = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+    using TimerId = std::uint64_t;
+
+    // 0 threads: one per core
+    explicit Executor(std::size_t threads = 0);
+    ~Executor() override;
+
+    void post(Task task);
+    TimerId postAt(Clock::time_point at, Task task);
+    TimerId postAfter(std::chrono::nanoseconds delay, Task task);
+    // the task of a timer not yet due is dropped instead of run; a timer that is already due may
+    // still run, an unknown one is ignored
+    void cancel(TimerId timer);
+
+    std::size_t threads() const noexcept;
+    // entries of the timer heap, cancelled ones not yet compacted included
+    std::size_t pendingTimers() const;
+
+private:
+    class Worker;
+    struct Timer;
+
+    void run();
+
+    mutable std::mutex mMutex;
+    std::condition_variable mWait;
+    bool mStop;
+    std::deque<Task> mReady;
+    std::vector<Timer> mTimers; // min-heap on mAt, then mSequence
+    std::unordered_set<TimerId> mCancelled;
+    std::uint64_t mSequence;
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+};
+
+struct Executor::Timer
+{
+    Clock::time_point mAt;
+    std::uint64_t mSequence; // equal deadlines fire in posting order, also the TimerId
+    Task mTask;
+};
+
+/*
+ * Runs the tasks posted to it one at a time and in order on an Executor, so that everything
+ * posted to one strand needs no locking against itself. A drain runs a bounded batch and then
+ * yields the worker to other strands.
+ */
+class Strand : public std::enable_shared_from_this<Strand>
+{
+public:
+    // runs `batch` on the worker, e.g. within thread-local state the tasks of the strand expect
+    using Around = std::function<void(const std::function<void()> &batch)>;
+
+    explicit Strand(Executor &executor, Around around = nullptr);
+
+    void post(Executor::Task task);
+    // time spent running the tasks of this strand
+    std::chrono::nanoseconds busyTime() const noexcept;
+
+    static constexpr std::size_t sBatch = 64;
+
+private:
+    void drain();
+
+    Executor &mExecutor;
+    const Around mAround;
+    std::mutex mMutex;
+    std::deque<Executor::Task> mTasks;
+    bool mScheduled;
+    std::atomic<std::int64_t> mBusy;
+};
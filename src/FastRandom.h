@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+/*
+ * Small engines for the simulation hot path. Both satisfy UniformRandomBitGenerator, so they can
+ * also feed the std distributions, but boundedRandom() below is what GameRules uses.
+ */
+
+// xoshiro256** by Blackman and Vigna, 32 bytes of state, 64-bit output
+class Xoshiro256
+{
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256(std::uint64_t seed = 1) noexcept
+        : mState()
+    {
+        for (auto &word: mState)
+        {   // splitmix64 spreads the seed, the state must not be all zeros
+            seed += 0x9e3779b97f4a7c15ull;
+            auto z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() noexcept
+    {
+        auto result = rotl(mState[1] * 5, 7) * 9;
+        auto t = mState[1] << 17;
+        mState[2] ^= mState[0];
+        mState[3] ^= mState[1];
+        mState[1] ^= mState[2];
+        mState[0] ^= mState[3];
+        mState[2] ^= t;
+        mState[3] = rotl(mState[3], 45);
+        return result;
+    }
+
+private:
+    static constexpr std::uint64_t rotl(std::uint64_t x, int k) noexcept
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t mState[4];
+};
+
+// PCG32 (XSH-RR) by O'Neill, 64-bit LCG state, 32-bit output
+class Pcg32
+{
+public:
+    using result_type = std::uint32_t;
+
+    explicit Pcg32(std::uint64_t seed = 1, std::uint64_t stream = 0xda3e39cb94b95bdbull) noexcept
+        : mState(0)
+        , mIncrement((stream << 1) | 1)
+    {
+        (*this)();
+        mState += seed;
+        (*this)();
+    }
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() noexcept
+    {
+        auto old = mState;
+        mState = old * 6364136223846793005ull + mIncrement;
+        auto xorShifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+        auto rotation = static_cast<std::uint32_t>(old >> 59);
+        return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+    }
+
+private:
+    std::uint64_t mState;
+    const std::uint64_t mIncrement;
+};
+
+namespace fast_random_detail {
+
+// engines with exactly 32 or 64 random bits, std::mt19937 reports a 64-bit result_type for 32 bits
+template<typename Engine>
+constexpr int bits()
+{
+    constexpr auto span = static_cast<std::uint64_t>(Engine::max() - Engine::min());
+    static_assert(span == std::numeric_limits<std::uint32_t>::max() || span == std::numeric_limits<std::uint64_t>::max(),
+                  "FastRandom needs an engine with 32 or 64 random bits");
+    return span == std::numeric_limits<std::uint32_t>::max() ? 32 : 64;
+}
+
+template<typename Engine>
+std::uint32_t draw32(Engine &engine) noexcept
+{   // the high bits of xoshiro are the strongest
+    return static_cast<std::uint32_t>(static_cast<std::uint64_t>(engine() - Engine::min()) >> (bits<Engine>() - 32));
+}
+
+}
+
+/*
+ * Uniform value in [0, range), range > 0, by Lemire's multiply-shift: the high half of
+ * random * range is the result. The low half only triggers a redraw when it falls in the
+ * range's biased remainder, which for board-sized ranges is about once in 2^26 draws, and
+ * the division that finds it is skipped on the common path.
+ */
+template<typename Engine>
+std::uint32_t boundedRandom(Engine &engine, std::uint32_t range) noexcept
+{
+    auto product = static_cast<std::uint64_t>(fast_random_detail::draw32(engine)) * range;
+    auto low = static_cast<std::uint32_t>(product);
+    if (low < range)
+    {
+        auto threshold = static_cast<std::uint32_t>(-range) % range;
+        while (low < threshold)
+        {
+            product = static_cast<std::uint64_t>(fast_random_detail::draw32(engine)) * range;
+            low = static_cast<std::uint32_t>(product);
+        }
+    }
+    return static_cast<std::uint32_t>(product >> 32);
+}
+
+// uniform double in [0, 1) from the top 53 of 64 random bits
+template<typename Engine>
+double unitRandom(Engine &engine) noexcept
+{
+    std::uint64_t bits;
+    if constexpr (fast_random_detail::bits<Engine>() == 64)
+    {
+        bits = static_cast<std::uint64_t>(engine() - Engine::min());
+    } else {
+        bits = fast_random_detail::draw32(engine);
+        bits = (bits << 32) | fast_random_detail::draw32(engine);
+    }
+    return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
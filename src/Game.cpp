@@ -5,24 +5,54 @@
 #include "ChessBoardImpl.h"
 #include "GameRules.h"
 #include "Logger.h"
+#include "MappedFileSink.h"
 #include "ParticipantGame.h"
+#include "Tracer.h"
 
-Game::Game(size_t countParticipants, size_t countSteps)
-    : mGameElements()
+Game::Game(size_t countParticipants, size_t countSteps, GameSettings settings)
+    : mSettings(std::move(settings))
+    , mLogStream()
+    , mEventBus()
+    , mGameElements()
+    , mBoard()
     , mCountParticipants(countParticipants)
     , mCountSteps(countSteps)
     , mStartGame(false)
+    , mParked(false)
     , mStartBarrier()
     , mEndBarrier()
 {
 
 }
 
+Game::~Game()
+{
+    if (mParked)
+    {
+        stopGame();
+    }
+}
+
 void Game::startGame()
 {
+    if (mParked)
+    {   // the participants are parked past the end barrier, the board thread waits for tasks
+        mParked = false;
+        mStartGame = true;
+        for (auto &element: mGameElements)
+        {
+            element->startGame();
+        }
+        return;
+    }
     if (!mStartGame)
     {
         mStartGame = true;
+        GameRules::configure(mSettings.mRules);
+        if (!mSettings.mTracePath.empty())
+        {
+            Tracer::instance().enable(mSettings.mTracePath);
+        }
         auto deleter = [](pthread_barrier_t *barrier) {
             pthread_barrier_destroy(barrier);
             delete barrier;
@@ -33,25 +63,85 @@ void Game::startGame()
         pthread_barrier_init(mStartBarrier.get(), nullptr, mCountParticipants);
         pthread_barrier_init(mEndBarrier.get(), nullptr, mCountParticipants + 1);
 
-        auto board = std::make_shared<ChessBoardImpl>(GameRules::sizeBoard());
-        auto logger = std::make_shared<Logger>(std::cout);
-        board->startGame();
-        logger->startGame();
-        board->addNotifier(logger);
+        auto board = std::make_shared<ChessBoardImpl>(GameRules::sizeBoard(), mSettings.mRules.mBlockingSliders,
+                                                       mSettings.mBoardCapacity, mSettings.mBoardPolicy);
+        board->setAttributes(mSettings.mBoardThread);
+        board->setDrainPolicy(mSettings.mBoardDrain, mSettings.mBoardUrgentWeight);
+        std::shared_ptr<Logger> logger;
+        std::vector<std::shared_ptr<ParticipantGame>> participants;
+        try {
+            board->startGame();
+            if (!mSettings.mEventBusName.empty())
+            {
+                if (!mEventBus)
+                {
+                    mEventBus = std::make_shared<EventBus>(mSettings.mEventBusName, mSettings.mEventBusCapacity);
+                }
+                board->addNotifier(mEventBus);
+            }
+            if (mSettings.mLogEnabled)
+            {
+                if (!mSettings.mLogPath.empty() && !mLogStream)
+                {
+                    mLogStream = std::make_unique<MappedFileSink>(mSettings.mLogPath, mSettings.mLogSegmentSize,
+                                                                  mSettings.mLogRotatePeriod, mSettings.mLogMaxSegments);
+                }
+                logger = std::make_shared<Logger>(mLogStream ? *mLogStream : std::cout,
+                                                  mSettings.mLogCapacity, mSettings.mLogPolicy);
+                logger->setAttributes(mSettings.mLoggerThread);
+                logger->startGame();
+                board->addNotifier(logger);
+            }
 
-        for (size_t i = 0; i < mCountParticipants; ++i)
+            for (size_t i = 0; i < mCountParticipants; ++i)
+            {
+                auto &pieces = mSettings.mRules.mPieces;
+                auto participant = std::make_shared<ParticipantGame>(board, mCountSteps, mStartBarrier, mEndBarrier,
+                                                                     pieces[i % pieces.size()], mSettings.mReusable);
+                participant->setAttributes(mSettings.mParticipantThread);
+                participants.push_back(participant);
+                participant->startGame();
+            }
+        } catch (...) {
+            // thread attributes the system refuses or no thread left, e.g. EAGAIN for the n-th
+            // participant: the ones started wait for release and leave without a game, and no
+            // notifier keeps the board and its thread alive
+            for (auto &participant: participants)
+            {
+                participant->stopGame();
+            }
+            if (logger)
+            {
+                logger->stopGame();
+            }
+            board->stopGame();
+            mStartBarrier.reset();
+            mEndBarrier.reset();
+            mStartGame = false;
+            throw;
+        }
+
+        for (auto &participant: participants)
         {
-            auto participant = std::make_shared<ParticipantGame>(board, mCountSteps, mStartBarrier, mEndBarrier);
-            participant->startGame();
+            participant->release();
             mGameElements.push_back(participant);
         }
-
-        mGameElements.push_back(logger);
+        if (logger)
+        {
+            mGameElements.push_back(logger);
+        }
         mGameElements.push_back(board);
+        mBoard = board;
     }
 }
 
 void Game::stopGame() {
+    if (mParked)
+    {   // nobody waits at the end barrier, the parked participants just leave
+        mParked = false;
+        mStartGame = true;
+        mEndBarrier.reset();
+    }
     if (mStartGame)
     {
         mStartGame = false;
@@ -60,12 +150,36 @@ void Game::stopGame() {
             element->stopGame();
         }
         mGameElements.clear();
-        pthread_barrier_wait(mEndBarrier.get());
+        if (mEndBarrier)
+        {
+            pthread_barrier_wait(mEndBarrier.get());
+        }
+        if (mSettings.mDumpStatistic)
+        {
+            mBoard->statistic().dump(std::cout);
+        }
+        if (!mSettings.mTracePath.empty() && !Tracer::instance().dump())
+        {
+            std::cerr << "Cannot write trace " << mSettings.mTracePath << std::endl;
+        }
     }
 }
 
 void Game::waitEnd()
 {
     pthread_barrier_wait(mEndBarrier.get());
+    if (mSettings.mReusable)
+    {   // the board finishes the last commands of the game, so its statistic is complete here
+        mBoard->reset();
+        mStartGame = false;
+        mParked = true;
+        return;
+    }
     mEndBarrier.reset();
+    stopGame();
+}
+
+std::shared_ptr<const ChessBoardImpl> Game::board() const
+{
+    return mBoard;
 }
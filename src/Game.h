@@ -1,28 +1,91 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <ostream>
+#include <string>
 #include <vector>
 
+#include "ChessBoardImpl.h"
+#include "EventBus.h"
+#include "GameRules.h"
+#include "Logger.h"
+#include "TreadBase.h"
+
 namespace board {
     class IChessBoard;
 }
 class IGameElement;
 
+struct GameSettings
+{
+    // board size and participant delays, installed into GameRules by startGame
+    GameRules::Settings mRules;
+
+    // no Logger at all when disabled, e.g. for throughput sweeps
+    bool mLogEnabled = true;
+    // Logger output: stdout when the path is empty, otherwise memory-mapped segments <mLogPath>.NNNNNN.log
+    std::string mLogPath;
+    std::size_t mLogSegmentSize = 64u << 20u;
+    std::chrono::milliseconds mLogRotatePeriod = std::chrono::milliseconds::zero();
+    std::size_t mLogMaxSegments = 0;
+
+    std::size_t mLogCapacity = Logger::sUnbounded;
+    Logger::OverloadPolicy mLogPolicy = Logger::OverloadPolicy::block;
+
+    // place and move commands queued on the board at most, see ChessBoardImpl::OverloadPolicy
+    std::size_t mBoardCapacity = ChessBoardImpl::sUnbounded;
+    ChessBoardImpl::OverloadPolicy mBoardPolicy = ChessBoardImpl::OverloadPolicy::block;
+    // cancels and removes free cells, they may overtake the queued places and moves
+    ChessBoardImpl::DrainPolicy mBoardDrain = ChessBoardImpl::DrainPolicy::fifo;
+    std::size_t mBoardUrgentWeight = ChessBoardImpl::sDefaultUrgentWeight;
+
+    // board events published to POSIX shared memory /dev/shm/<mEventBusName> for observers in other
+    // processes, see EventBus; disabled when empty
+    std::string mEventBusName;
+    std::size_t mEventBusCapacity = EventBus::sDefaultCapacity;
+
+    // Chrome/Perfetto trace-event JSON written at stopGame, disabled when empty
+    std::string mTracePath;
+
+    // board latency table printed to stdout at stopGame
+    bool mDumpStatistic = true;
+
+    // waitEnd keeps the board, Logger and participant threads for the next startGame, the board is
+    // reset in place and the barriers are reused; stopGame tears everything down
+    bool mReusable = false;
+
+    // per role, e.g. the board pinned to an isolated core and small stacks for many participants
+    ThreadAttributes mBoardThread;
+    ThreadAttributes mLoggerThread;
+    ThreadAttributes mParticipantThread;
+};
+
 class Game final
 {
 public:
-    Game(size_t countParticipants, size_t countSteps);
+    Game(size_t countParticipants, size_t countSteps, GameSettings settings = {});
+    // tears down a parked reusable game
+    ~Game();
 
+    // a reusable game that ended in waitEnd starts the next one on the same threads
     void startGame();
     void stopGame();
     void waitEnd();
 
+    std::shared_ptr<const ChessBoardImpl> board() const;
+
 private:
+    const GameSettings mSettings;
+    std::unique_ptr<std::ostream> mLogStream;
+    std::shared_ptr<EventBus> mEventBus; // created by the first startGame, outlives the boards
     std::vector<std::shared_ptr<IGameElement>> mGameElements;
+    std::shared_ptr<ChessBoardImpl> mBoard;
     size_t mCountParticipants;
     size_t mCountSteps;
     bool mStartGame;
+    bool mParked; // reusable only: the last game ended, the threads wait for the next one
     std::shared_ptr<pthread_barrier_t> mStartBarrier, mEndBarrier;
 };
 
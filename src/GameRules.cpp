@@ -1,60 +1,221 @@
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <limits>
 #include <random>
+#include <stdexcept>
+#include <type_traits>
 
+#include "FastRandom.h"
 #include "GameRules.h"
 #include "IChessMan.h"
 #include "ChessManImpl.h"
+#include "StepStrategy.h"
 
 using namespace board;
 
-static thread_local std::mt19937 mGen{std::random_device()() };
+template<typename Engine>
+static Engine seeded()
+{
+    std::random_device device;
+    auto seed = [&device]() {
+        return (static_cast<std::uint64_t>(device()) << 32) | device();
+    };
+    if constexpr (std::is_same_v<Engine, std::mt19937>)
+    {
+        return Engine(device());
+    } else if constexpr (std::is_same_v<Engine, Pcg32>) {
+        auto state = seed();
+        return Engine(state, seed());
+    } else {
+        return Engine(seed());
+    }
+}
 
-bool GameRules::checkStep(const std::shared_ptr<chessman::IChessMan> &chessMan, const Coordinate &coordinate)
+template<typename Engine>
+static Engine &engine()
+{   // built on the first draw of the calling thread, only the selected engine is ever built
+    thread_local Engine sEngine = seeded<Engine>();
+    return sEngine;
+}
+
+template<typename Function>
+static auto withEngine(Function &&function)
 {
-    auto result = false;
-    auto &ch_crd = chessMan->getCurrentCoordinate();
-    if (chessMan->getType() == chessman::ChessmanType::rook)
+    switch (GameRules::settings().mRandomEngine) {
+        case RandomEngine::mt19937:
+            return function(engine<std::mt19937>());
+        case RandomEngine::pcg32:
+            return function(engine<Pcg32>());
+        case RandomEngine::xoshiro256:
+            break;
+    }
+    return function(engine<Xoshiro256>());
+}
+
+void GameRules::configure(const Settings &settings)
+{
+    validate(settings);
+    current() = settings;
+}
+
+void GameRules::validate(const Settings &settings)
+{
+    if (settings.mSizeBoard < sMinSizeBoard || settings.mSizeBoard > sMaxSizeBoard)
+    {
+        throw std::invalid_argument("Board size must be in [" + std::to_string(sMinSizeBoard) + ", "
+                                    + std::to_string(sMaxSizeBoard) + "]");
+    }
+    if (settings.mDelayNextStepMin.count() < 0 || settings.mDelayNextStepMin > settings.mDelayNextStepMax
+        || settings.mDelayWaitForCell.count() < 0 || settings.mDelayConfirm.count() < 0)
+    {
+        throw std::invalid_argument("Delays must be non-negative and min must not exceed max");
+    }
+    if (settings.mDelayNextStepMax - settings.mDelayNextStepMin
+        >= std::chrono::milliseconds(std::numeric_limits<std::uint32_t>::max()))
+    {
+        throw std::invalid_argument("Step delay range is too wide");
+    }
+    if (settings.mPieces.empty())
+    {
+        throw std::invalid_argument("At least one piece type is required");
+    }
+    for (auto type: settings.mPieces)
     {
-        result = ch_crd != coordinate // ch_crd is not same coordinate
-               && coordinate >= 0 && coordinate <= sizeBoard() // located in board
-               && (ch_crd.first == coordinate.first || ch_crd.second == coordinate.second);
+        if (settings.mSizeBoard < chessman::minSizeBoard(type))
+        {
+            throw std::invalid_argument("Board size " + std::to_string(settings.mSizeBoard) + " leaves a piece without moves");
+        }
     }
-    return result;
+}
+
+bool GameRules::checkStep(const std::shared_ptr<chessman::IChessMan> &chessMan, const Coordinate &coordinate)
+{
+    return checkStep(chessMan->getType(), chessMan->getCurrentCoordinate(), coordinate);
 }
 
 board::Coordinate GameRules::generateFirstStep() {
-    std::uniform_int_distribution<> distribution_step(0, sizeBoard() - 1);
-    return board::Coordinate(distribution_step(mGen), distribution_step(mGen));
+    if (auto &strategy = settings().mStepStrategy; strategy)
+    {
+        return strategy->firstStep();
+    }
+    // one draw over all cells instead of one per axis
+    auto size = static_cast<std::uint32_t>(sizeBoard());
+    auto cell = generateBounded(size * size);
+    return board::Coordinate(static_cast<Coordinate::first_type>(cell / size),
+                             static_cast<Coordinate::second_type>(cell % size));
 }
 
 Coordinate GameRules::generateStep(const chessman::IChessMan &chessMan)
 {
-    Coordinate result;
+    if (auto &strategy = settings().mStepStrategy; strategy)
     {
-       std::uniform_int_distribution distribution_direction(0, 1);
-       auto &coordinate = chessMan.getCurrentCoordinate();
-       if (distribution_direction(mGen))
-       {   // change x
-           std::uniform_int_distribution<> distribution_step(0 - coordinate.first, sizeBoard() - 1 - coordinate.first);
-           Coordinate::first_type delta;
-           do {
-               delta = static_cast<Coordinate::first_type>(distribution_step(mGen));
-           } while (!delta);
-           result.first = static_cast<Coordinate::first_type>(coordinate.first + delta);
-           result.second = coordinate.second;
-       } else {
-           // change y
-           std::uniform_int_distribution<> distribution_step(0 - coordinate.second, sizeBoard() - 1 - coordinate.second);
-           Coordinate::second_type delta;
-           do {
-               delta = static_cast<Coordinate::second_type>(distribution_step(mGen));
-           } while (!delta);
-           result.first = coordinate.first;
-           result.second = static_cast<Coordinate::second_type>(coordinate.second + delta);
-       }
+        return strategy->nextStep(chessMan);
     }
+    return generateUniformStep(chessMan.getType(), chessMan.getCurrentCoordinate());
+}
 
-    return result;
+Coordinate GameRules::generateStep(const chessman::IChessMan &chessMan, const board::IChessBoard &chessBoard)
+{
+    if (auto &strategy = settings().mStepStrategy; strategy)
+    {
+        return strategy->nextStepOnBoard(chessMan, chessBoard);
+    }
+    return generateUniformStep(chessMan.getType(), chessMan.getCurrentCoordinate());
+}
+
+Coordinate GameRules::generateUniformStep(chessman::ChessmanType type, const Coordinate &coordinate)
+{   // a single draw over the legal targets, the current cell is skipped rather than redrawn
+    using chessman::ChessmanType;
+
+    auto size = sizeBoard();
+    auto x = static_cast<std::int32_t>(coordinate.first);
+    auto y = static_cast<std::int32_t>(coordinate.second);
+    auto lineTarget = [&](std::uint32_t draw) -> Coordinate {
+        // draw in [0, 2 * (size - 1)) picks the axis and one of the other cells on it
+        auto others = static_cast<std::uint32_t>(size - 1);
+        if (draw < others)
+        {   // change x
+            auto other = static_cast<std::int32_t>(draw);
+            return {static_cast<Coordinate::first_type>(other + (other >= x)), coordinate.second};
+        }
+        // change y
+        auto other = static_cast<std::int32_t>(draw - others);
+        return {coordinate.first, static_cast<Coordinate::second_type>(other + (other >= y))};
+    };
+    // the diagonal (+1, +1) has `below` cells before the coordinate, the anti-diagonal (+1, -1) `belowAnti`,
+    // only the sliders along diagonals pay for them
+    std::int32_t below = 0, diagonal = 0, belowAnti = 0, antiDiagonal = 0;
+    if (type == ChessmanType::bishop || type == ChessmanType::queen)
+    {
+        below = std::min(x, y);
+        diagonal = below + std::min(size - 1 - x, size - 1 - y);
+        belowAnti = std::min(x, size - 1 - y);
+        antiDiagonal = belowAnti + std::min(size - 1 - x, y);
+    }
+    auto diagonalTarget = [&](std::uint32_t draw) -> Coordinate {
+        auto index = static_cast<std::int32_t>(draw);
+        if (index < diagonal)
+        {
+            auto k = index - below;
+            k += k >= 0;
+            return {static_cast<Coordinate::first_type>(x + k), static_cast<Coordinate::second_type>(y + k)};
+        }
+        auto k = index - diagonal - belowAnti;
+        k += k >= 0;
+        return {static_cast<Coordinate::first_type>(x + k), static_cast<Coordinate::second_type>(y - k)};
+    };
+    auto offsetTarget = [&](const std::array<Coordinate, 8> &offsets) -> Coordinate {
+        std::array<Coordinate, 8> targets{};
+        std::uint32_t count = 0;
+        for (auto &offset: offsets)
+        {
+            auto tx = x + offset.first;
+            auto ty = y + offset.second;
+            targets[count] = {static_cast<Coordinate::first_type>(tx), static_cast<Coordinate::second_type>(ty)};
+            count += tx >= 0 && ty >= 0 && tx < size && ty < size;
+        }
+        return count ? targets[generateBounded(count)] : invalidCoordinate;
+    };
+
+    switch (type) {
+        case ChessmanType::rook:
+            break;
+        case ChessmanType::bishop:
+            return diagonalTarget(generateBounded(static_cast<std::uint32_t>(diagonal + antiDiagonal)));
+        case ChessmanType::queen:
+        {
+            auto lines = static_cast<std::uint32_t>(2 * (size - 1));
+            auto draw = generateBounded(lines + static_cast<std::uint32_t>(diagonal + antiDiagonal));
+            return draw < lines ? lineTarget(draw) : diagonalTarget(draw - lines);
+        }
+        case ChessmanType::knight:
+            return offsetTarget(chessman::sKnightOffsets);
+        case ChessmanType::king:
+            return offsetTarget(chessman::sKingOffsets);
+    }
+    return lineTarget(generateBounded(static_cast<std::uint32_t>(2 * (size - 1))));
+}
+
+std::uint32_t GameRules::generateBounded(std::uint32_t range)
+{
+    return withEngine([range](auto &engine) {
+        return boundedRandom(engine, range);
+    });
+}
+
+std::uint32_t GameRules::generateBits()
+{
+    return withEngine([](auto &engine) {
+        return fast_random_detail::draw32(engine);
+    });
+}
+
+double GameRules::generateUnit()
+{
+    return withEngine([](auto &engine) {
+        return unitRandom(engine);
+    });
 }
 
 std::uint32_t GameRules::generateId()
@@ -70,16 +231,21 @@ std::shared_ptr<chessman::IChessMan> GameRules::makeChessMan(chessman::ChessmanT
 
 std::chrono::milliseconds GameRules::generateDelayWaitNextStep()
 {
-    std::uniform_int_distribution distribution_direction(200, 300);
-    return std::chrono::milliseconds(distribution_direction(mGen));
+    auto &rules = settings();
+    auto span = static_cast<std::uint32_t>((rules.mDelayNextStepMax - rules.mDelayNextStepMin).count());
+    if (!span)
+    {
+        return rules.mDelayNextStepMin;
+    }
+    return rules.mDelayNextStepMin + std::chrono::milliseconds(generateBounded(span + 1));
 }
 
 std::chrono::milliseconds GameRules::generateDelayWaitForCell()
 {
-    return std::chrono::milliseconds(5000);
+    return settings().mDelayWaitForCell;
 }
 
 std::chrono::milliseconds GameRules::generateDelayConfirm()
 {
-    return std::chrono::milliseconds(100);
+    return settings().mDelayConfirm;
 }
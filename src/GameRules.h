@@ -2,19 +2,53 @@
 
 #include <memory>
 #include <chrono>
+#include <vector>
 #include <Coordinate.h>
 #include <IChessMan.h>
+#include "MoveTable.h"
 
 class ChessBoardImpl;
+namespace board {
+    class IChessBoard;
+}
 class IGameElement;
+class IStepStrategy;
+
+// engine behind every GameRules draw, each thread owns and seeds its own
+enum class RandomEngine
+{
+    mt19937, xoshiro256, pcg32
+};
 
 class GameRules
 {
 public:
+    struct Settings;
+    class Scope;
+
+    // applied by Game::startGame, must not change while a game is running
+    static void configure(const Settings &settings);
+    // throws std::invalid_argument for the settings configure refuses
+    static void validate(const Settings &settings);
+    // those of the innermost Scope of the calling thread, otherwise the configured ones
+    static const Settings &settings();
+
     static bool checkStep(const std::shared_ptr<chessman::IChessMan> &chessMan, const board::Coordinate &coordinate);
+    // a move table lookup, `to` must differ from `from`
+    static bool checkStep(chessman::ChessmanType type, const board::Coordinate &from, const board::Coordinate &to);
     static board::Coordinate generateFirstStep();
     static board::Coordinate generateStep(const chessman::IChessMan &chessMan);
-    static constexpr std::int32_t sizeBoard();
+    // the same, a step strategy may look at the occupancy of the board the figure stands on
+    static board::Coordinate generateStep(const chessman::IChessMan &chessMan, const board::IChessBoard &board);
+    // uniform over the legal moves of the piece from coordinate, ignores the step strategy
+    static board::Coordinate generateUniformStep(chessman::ChessmanType type, const board::Coordinate &coordinate);
+    // uniform in [0, range), range > 0
+    static std::uint32_t generateBounded(std::uint32_t range);
+    // 32 uniform bits
+    static std::uint32_t generateBits();
+    // uniform in [0, 1)
+    static double generateUnit();
+    static std::int32_t sizeBoard();
     static std::uint32_t generateId();
 
     static std::shared_ptr<chessman::IChessMan> makeChessMan(chessman::ChessmanType type);
@@ -22,9 +56,83 @@ public:
     static std::chrono::milliseconds generateDelayWaitNextStep();
     static std::chrono::milliseconds generateDelayWaitForCell();
     static std::chrono::milliseconds generateDelayConfirm();
+
+    static constexpr std::int32_t sMinSizeBoard = 2;
+    static constexpr std::int32_t sMaxSizeBoard = 127; // Coordinate is a pair of int8_t
+
+private:
+    static Settings &current();
+    static const Settings *&scoped();
+};
+
+struct GameRules::Settings
+{
+    std::int32_t mSizeBoard = 8;
+    std::chrono::milliseconds mDelayNextStepMin = std::chrono::milliseconds(200);
+    std::chrono::milliseconds mDelayNextStepMax = std::chrono::milliseconds(300);
+    std::chrono::milliseconds mDelayWaitForCell = std::chrono::milliseconds(5000);
+    std::chrono::milliseconds mDelayConfirm = std::chrono::milliseconds(100);
+    // uniform random moves when empty
+    std::shared_ptr<IStepStrategy> mStepStrategy;
+    RandomEngine mRandomEngine = RandomEngine::xoshiro256;
+    // handed out to the participants in turn
+    std::vector<chessman::ChessmanType> mPieces{chessman::ChessmanType::rook};
+    // the board enforces the piece moves and blocks sliders at occupied cells, see ChessBoardImpl
+    bool mBlockingSliders = false;
+};
+
+/*
+ * Rules for the calling thread while alive, so that games with rules of their own may share
+ * threads, e.g. the hosted games of a GameServer around the tasks of their strands. Scopes nest.
+ */
+class GameRules::Scope
+{
+public:
+    explicit Scope(const Settings &settings) noexcept
+        : mPrevious(scoped())
+    {
+        scoped() = &settings;
+    }
+
+    ~Scope()
+    {
+        scoped() = mPrevious;
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const Settings *mPrevious;
 };
 
-inline constexpr std::int32_t GameRules::sizeBoard()
+inline GameRules::Settings &GameRules::current()
+{   // function-local so that static initializers (benchmark registration) may read it
+    static Settings settings;
+    return settings;
+}
+
+inline const GameRules::Settings *&GameRules::scoped()
+{
+    static thread_local const Settings *settings = nullptr;
+    return settings;
+}
+
+inline const GameRules::Settings &GameRules::settings()
 {
-    return 8;
+    auto scope = scoped();
+    return scope ? *scope : current();
 }
+
+inline std::int32_t GameRules::sizeBoard()
+{
+    return settings().mSizeBoard;
+}
+
+inline bool GameRules::checkStep(chessman::ChessmanType type, const board::Coordinate &from, const board::Coordinate &to)
+{
+    return board::CellIndex::fromCoordinate(to, static_cast<std::uint8_t>(sizeBoard())).valid() // located in board
+           && chessman::canMove(type, to.first - from.first, to.second - from.second);
+}
+
+static_assert(chessman::sMoveTableSide >= GameRules::sMaxSizeBoard);
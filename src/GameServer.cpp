@@ -0,0 +1,257 @@
+#include <stdexcept>
+#include <utility>
+
+#include "ChessBoardImpl.h"
+#include "GameServer.h"
+#include "HostedParticipant.h"
+
+/*
+ * One game of the server: a board and its participants on one strand. It is also a notifier of
+ * its board to count the outcomes of the game.
+ */
+class HostedGame
+        : public board::INotifier
+        , public std::enable_shared_from_this<HostedGame>
+{
+public:
+    using Done = std::function<void(const HostedGameStats &stats)>;
+
+    HostedGame(std::uint32_t id, std::size_t countParticipants, std::size_t countSteps, Executor &executor,
+               std::shared_ptr<const GameRules::Settings> rules, std::shared_ptr<BoardStatistic> statistic, Done done)
+        : mStats{id, countParticipants, 0, 0, 0, 0, {}, {}, false}
+        , mCountSteps(countSteps)
+        , mExecutor(executor)
+        , mRules(std::move(rules))
+        , mStrand(std::make_shared<Strand>(executor, [rules = mRules](const std::function<void()> &batch) {
+            // the states, the board and the step strategy read GameRules on the worker
+            GameRules::Scope scope(*rules);
+            batch();
+        }))
+        , mStatistic(std::move(statistic))
+        , mDone(std::move(done))
+        , mBoard()
+        , mParticipants()
+        , mRunning(0)
+        , mStarted()
+    {
+
+    }
+
+    void startGame()
+    {
+        mStrand->post([self = shared_from_this()]() {
+            self->start();
+        });
+    }
+
+    void stopGame()
+    {
+        mStrand->post([self = shared_from_this()]() {
+            for (auto &participant: self->mParticipants)
+            {
+                participant->stopGame();
+            }
+        });
+    }
+
+protected:
+    void placed(std::uint32_t, const board::Coordinate &) noexcept override {}
+    void moved(std::uint32_t, const board::Coordinate &, const board::Coordinate &) noexcept override
+    {
+        ++mStats.mMoves;
+    }
+    void cancelMoved(std::uint32_t, const board::Coordinate &, const board::Coordinate &) noexcept override
+    {
+        ++mStats.mCancels;
+    }
+    void removed(std::uint32_t, const board::Coordinate &) noexcept override {}
+    void waitingForCell(std::uint32_t, const board::Coordinate &, const board::Coordinate &) noexcept override
+    {
+        ++mStats.mWaits;
+    }
+    void reject(std::uint32_t, board::ReasonReject) noexcept override
+    {
+        ++mStats.mRejects;
+    }
+
+private:
+    void start()
+    {
+        auto &rules = *mRules;
+        mStarted = std::chrono::steady_clock::now();
+        mBoard = std::make_shared<ChessBoardImpl>(rules.mSizeBoard, rules.mBlockingSliders, mStrand, mStatistic);
+        mBoard->addNotifier(shared_from_this());
+        mBoard->startGame();
+        std::weak_ptr<HostedGame> weak = shared_from_this();
+        for (std::size_t i = 0; i < mStats.mParticipants; ++i)
+        {
+            auto finished = [weak](bool failed) {
+                if (auto self = weak.lock(); self)
+                {
+                    self->participantFinished(failed);
+                }
+            };
+            mParticipants.push_back(std::make_shared<HostedParticipant>(mBoard, mCountSteps, mExecutor, mStrand,
+                                                                        finished,
+                                                                        rules.mPieces[i % rules.mPieces.size()]));
+        }
+        mRunning = mParticipants.size();
+        for (auto &participant: mParticipants)
+        {
+            participant->startGame();
+        }
+    }
+
+    void participantFinished(bool failed)
+    {
+        if (failed && !mStats.mFailed)
+        {   // stop the rest of this game only, the other games go on
+            mStats.mFailed = true;
+            for (auto &participant: mParticipants)
+            {
+                participant->stopGame();
+            }
+        }
+        if (--mRunning)
+        {
+            return;
+        }
+        mBoard->stopGame();
+        mBoard->removeNotifier(shared_from_this());
+        mStats.mWallTime = std::chrono::steady_clock::now() - mStarted;
+        mStats.mBusyTime = mStrand->busyTime();
+        mParticipants.clear();
+        mBoard.reset();
+        mDone(mStats);
+    }
+
+    HostedGameStats mStats;
+    const std::size_t mCountSteps;
+    Executor &mExecutor;
+    const std::shared_ptr<const GameRules::Settings> mRules;
+    const std::shared_ptr<Strand> mStrand;
+    const std::shared_ptr<BoardStatistic> mStatistic;
+    const Done mDone;
+    std::shared_ptr<ChessBoardImpl> mBoard;
+    std::vector<std::shared_ptr<HostedParticipant>> mParticipants;
+    std::size_t mRunning;
+    std::chrono::steady_clock::time_point mStarted;
+};
+
+GameServer::GameServer(GameServerSettings settings)
+    : mSettings(std::move(settings))
+    , mRules(std::make_shared<const GameRules::Settings>(mSettings.mRules))
+    , mStatistic(std::make_shared<BoardStatistic>())
+    , mMutex()
+    , mIdle()
+    , mGames()
+    , mParticipants(0)
+    , mNextId(1)
+    , mRefused(0)
+    , mFinished()
+    , mExecutor(mSettings.mThreads)
+{
+    GameRules::validate(mSettings.mRules);
+}
+
+GameServer::~GameServer()
+{
+    stopAll();
+    waitIdle();
+}
+
+std::uint32_t GameServer::startGame(std::size_t countParticipants, std::size_t countSteps)
+{
+    auto sizeBoard = static_cast<std::size_t>(mRules->mSizeBoard);
+    if (!countParticipants || countParticipants >= sizeBoard * sizeBoard)
+    {
+        throw std::invalid_argument("A hosted game needs participants and at least one free cell");
+    }
+    std::shared_ptr<HostedGame> game;
+    std::uint32_t id = 0;
+    {
+        std::lock_guard lock(mMutex);
+        if (mGames.size() >= mSettings.mMaxGames || mParticipants + countParticipants > mSettings.mMaxParticipants)
+        {
+            mRefused.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+        id = mNextId++;
+        if (!mNextId)
+        {
+            mNextId = 1;
+        }
+        game = std::make_shared<HostedGame>(id, countParticipants, countSteps, mExecutor, mRules, mStatistic,
+                                            [this](const HostedGameStats &stats) {
+                                                finished(stats);
+                                            });
+        mGames.emplace(id, game);
+        mParticipants += countParticipants;
+    }
+    game->startGame();
+    return id;
+}
+
+void GameServer::stopAll()
+{
+    std::lock_guard lock(mMutex);
+    for (auto &[id, game]: mGames)
+    {
+        game->stopGame();
+    }
+}
+
+void GameServer::waitIdle()
+{
+    std::unique_lock lock(mMutex);
+    mIdle.wait(lock, [this]() {
+        return mGames.empty();
+    });
+}
+
+std::size_t GameServer::runningGames() const
+{
+    std::lock_guard lock(mMutex);
+    return mGames.size();
+}
+
+std::uint64_t GameServer::refusedGames() const noexcept
+{
+    return mRefused.load(std::memory_order_relaxed);
+}
+
+std::vector<HostedGameStats> GameServer::takeFinished()
+{
+    std::lock_guard lock(mMutex);
+    return std::exchange(mFinished, {});
+}
+
+const BoardStatistic &GameServer::statistic() const noexcept
+{
+    return *mStatistic;
+}
+
+const Executor &GameServer::executor() const noexcept
+{
+    return mExecutor;
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+void GameServer::finished(const HostedGameStats &stats)
+{   // on the strand of the game, which keeps the game alive until it returns
+    std::shared_ptr<HostedGame> game;
+    std::lock_guard lock(mMutex);
+    if (auto it = mGames.find(stats.mGameId); it != mGames.end())
+    {
+        game = std::move(it->second);
+        mGames.erase(it);
+        mParticipants -= stats.mParticipants;
+    }
+    mFinished.push_back(stats);
+    if (mGames.empty())
+    {
+        mIdle.notify_all();
+    }
+}
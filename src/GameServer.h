@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "BoardStatistic.h"
+#include "Executor.h"
+#include "GameRules.h"
+
+class HostedGame;
+
+struct GameServerSettings
+{
+    // shared by every hosted game, each game reads them through a GameRules::Scope on its strand,
+    // the configured GameRules stay as they are
+    GameRules::Settings mRules;
+    // executor threads, 0: one per core
+    std::size_t mThreads = 0;
+    // admission control, a game that would exceed either limit is refused
+    std::size_t mMaxGames = 4096;
+    std::size_t mMaxParticipants = 1u << 16u;
+};
+
+struct HostedGameStats
+{
+    std::uint32_t mGameId;
+    std::size_t mParticipants;
+    std::uint64_t mMoves;
+    std::uint64_t mWaits;
+    std::uint64_t mRejects;
+    std::uint64_t mCancels;
+    std::chrono::nanoseconds mWallTime; // from startGame until the last participant left
+    std::chrono::nanoseconds mBusyTime; // executor time spent on the game
+    bool mFailed;                       // a participant met an unexpected event and the game was stopped
+};
+
+/*
+ * Hosts many independent games on one executor of about one thread per core instead of a
+ * thread per board, logger and participant. Every game runs its board and participants on its
+ * own Strand, so games never block each other and a failing game is stopped alone. The latency
+ * histograms of all boards go to one shared BoardStatistic (a statistic per board would weigh
+ * more than a small board itself), the per-game counters come with HostedGameStats.
+ * There is no Logger, games are meant to be many and small.
+ */
+class GameServer
+{
+public:
+    explicit GameServer(GameServerSettings settings);
+    // stops the running games and waits for them
+    ~GameServer();
+
+    // the id of the new game, 0 when admission control refuses it
+    std::uint32_t startGame(std::size_t countParticipants, std::size_t countSteps);
+    // asks every running game to stop, the participants remove their figures
+    void stopAll();
+    // blocks until no game is running
+    void waitIdle();
+
+    std::size_t runningGames() const;
+    std::uint64_t refusedGames() const noexcept;
+    // stats of the games finished since the last call
+    std::vector<HostedGameStats> takeFinished();
+    const BoardStatistic &statistic() const noexcept;
+    const Executor &executor() const noexcept;
+
+private:
+    void finished(const HostedGameStats &stats);
+
+    const GameServerSettings mSettings;
+    const std::shared_ptr<const GameRules::Settings> mRules;
+    const std::shared_ptr<BoardStatistic> mStatistic;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mIdle;
+    std::map<std::uint32_t, std::shared_ptr<HostedGame>> mGames;
+    std::size_t mParticipants;
+    std::uint32_t mNextId;
+    std::atomic<std::uint64_t> mRefused;
+    std::vector<HostedGameStats> mFinished;
+
+    Executor mExecutor; // last, so that it stops before the games go away
+};
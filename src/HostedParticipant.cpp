@@ -0,0 +1,186 @@
+#include <stdexcept>
+
+#include "Executor.h"
+#include "GameRules.h"
+#include "HostedParticipant.h"
+#include "Tracer.h"
+#include "state/WaitForConfirmStep.h"
+
+using namespace board;
+
+HostedParticipant::HostedParticipant(std::shared_ptr<board::IChessBoard> board, std::size_t countStep,
+                                     Executor &executor, std::shared_ptr<Strand> strand, Finished finished,
+                                     chessman::ChessmanType type)
+    : mBoard(std::move(board))
+    , mExecutor(executor)
+    , mStrand(std::move(strand))
+    , mFinished(std::move(finished))
+    , mType(type)
+    , mChessMan(nullptr)
+    , mEvents()
+    , mCounterStep(countStep)
+    , mStopping(false)
+    , mTimerGeneration(0)
+    , mTimer(0)
+    , mTimerArmed(false)
+    , mState(nullptr)
+{
+
+}
+
+void HostedParticipant::startGame()
+{
+    mStrand->post([self = shared_from_this()]() {
+        self->mChessMan = GameRules::makeChessMan(self->mType);
+        self->mBoard->addNotifier(self);
+        self->mState = std::make_unique<WaitForConfirmStep>(self->mBoard, self->mChessMan);
+        self->mBoard->placeFigure(*self->mChessMan, GameRules::generateFirstStep());
+        self->armTimer();
+    });
+}
+
+void HostedParticipant::stopGame()
+{
+    mStrand->post([self = shared_from_this()]() {
+        if (self->mState && !self->mStopping)
+        {
+            self->mStopping = true;
+            self->push(std::make_unique<Event>(Event::Type::stop, invalidCoordinate, ReasonReject::empty));
+        }
+    });
+}
+
+/* ************************************************************
+ * IMPL board::INotifier
+ * ************************************************************/
+void HostedParticipant::placed(std::uint32_t id, const board::Coordinate &to) noexcept
+{
+    if (mState && id == mChessMan->getID() && !mStopping)
+    {
+        push(std::make_unique<Event>(Event::Type::placed, to, ReasonReject::empty));
+    }
+}
+
+void HostedParticipant::moved(std::uint32_t id, const Coordinate &, const Coordinate &to) noexcept
+{
+    if (mState && id == mChessMan->getID() && !mStopping)
+    {
+        push(std::make_unique<Event>(Event::Type::moved, to, ReasonReject::empty));
+        if (!--mCounterStep)
+        {
+            mStopping = true;
+            push(std::make_unique<Event>(Event::Type::stop, invalidCoordinate, ReasonReject::empty));
+        }
+    }
+}
+
+void HostedParticipant::cancelMoved(std::uint32_t id, const Coordinate &, const Coordinate &to) noexcept
+{
+    if (mState && id == mChessMan->getID() && !mStopping)
+    {
+        push(std::make_unique<Event>(Event::Type::cancelMoved, to, ReasonReject::empty));
+    }
+}
+
+void HostedParticipant::removed(std::uint32_t id, const Coordinate &) noexcept
+{
+    if (mState && id == mChessMan->getID() && !mStopping)
+    {
+        push(std::make_unique<Event>(Event::Type::remove, invalidCoordinate, ReasonReject::empty));
+    }
+}
+
+void HostedParticipant::waitingForCell(std::uint32_t id, const Coordinate &, const Coordinate &to) noexcept
+{
+    if (mState && id == mChessMan->getID() && !mStopping)
+    {
+        push(std::make_unique<Event>(Event::Type::waitingForCell, to, ReasonReject::empty));
+    }
+}
+
+void HostedParticipant::reject(std::uint32_t id, board::ReasonReject reason) noexcept
+{
+    if (mState && id == mChessMan->getID() && !mStopping)
+    {
+        push(std::make_unique<Event>(Event::Type::reject, invalidCoordinate, reason));
+    }
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+void HostedParticipant::push(std::unique_ptr<Event> event)
+{   // the notification arrives inside the board's flushEvents, the state runs after it
+    mEvents.push_back(std::move(event));
+    mStrand->post([self = shared_from_this()]() {
+        if (!self->mEvents.empty())
+        {
+            auto event = std::move(self->mEvents.front());
+            self->mEvents.pop_front();
+            self->step(std::move(event));
+        }
+    });
+}
+
+void HostedParticipant::step(std::unique_ptr<Event> event)
+{
+    if (!mState)
+    {
+        return;
+    }
+    try {
+        Tracer::Scope scope(mState->name());
+        mState = mState->doWork(std::move(event));
+    } catch (const std::logic_error &) {
+        finish(true);
+        return;
+    }
+    if (mState->stop())
+    {
+        finish(false);
+    } else {
+        armTimer();
+    }
+}
+
+void HostedParticipant::armTimer()
+{
+    if (mTimerArmed)
+    {   // most waits end with an event, the timeout would only weigh on the timer heap
+        mExecutor.cancel(mTimer);
+    }
+    auto generation = ++mTimerGeneration;
+    std::weak_ptr<HostedParticipant> weak = shared_from_this();
+    mTimerArmed = true;
+    mTimer = mExecutor.postAfter(mState->waitPeriod(), [weak, generation]() {
+        if (auto self = weak.lock(); self)
+        {
+            self->mStrand->post([self, generation]() {
+                // a timer already due when it was cancelled still gets here
+                if (self->mTimerGeneration != generation)
+                {
+                    return;
+                }
+                self->mTimerArmed = false;
+                // events win over a timeout that fired at the same time, as in ParticipantGame
+                if (self->mEvents.empty())
+                {
+                    self->step(nullptr);
+                }
+            });
+        }
+    });
+}
+
+void HostedParticipant::finish(bool failed)
+{
+    if (mTimerArmed)
+    {
+        mExecutor.cancel(mTimer);
+        mTimerArmed = false;
+    }
+    mState.reset();
+    mEvents.clear();
+    mBoard->removeNotifier(shared_from_this());
+    mFinished(failed);
+}
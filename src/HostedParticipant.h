@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+
+#include "Executor.h"
+#include "IChessBoard.h"
+#include "IChessMan.h"
+#include "ParticipantGame.h"
+
+/*
+ * ParticipantGame without a thread: the same states run on the strand of the hosted game and
+ * a state's wait period becomes an executor timer. The board of the game shares the strand, so
+ * its notifications arrive on it too and nothing here is locked.
+ */
+class HostedParticipant
+        : public board::INotifier
+        , public std::enable_shared_from_this<HostedParticipant>
+{
+public:
+    // `finished` runs on the strand once the figure left the board, with true when a state
+    // threw on an unexpected event
+    using Finished = std::function<void(bool failed)>;
+
+    HostedParticipant(std::shared_ptr<board::IChessBoard> board, std::size_t countStep, Executor &executor,
+                      std::shared_ptr<Strand> strand, Finished finished,
+                      chessman::ChessmanType type = chessman::ChessmanType::rook);
+
+    // both post to the strand
+    void startGame();
+    void stopGame();
+
+protected:
+    void placed(std::uint32_t id, const board::Coordinate &to) noexcept override;
+    void moved(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
+    void cancelMoved(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
+    void removed(std::uint32_t id, const board::Coordinate &from) noexcept override;
+    void waitingForCell(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
+    void reject(std::uint32_t id, board::ReasonReject reason) noexcept override;
+
+private:
+    using Event = ParticipantGame::Event;
+
+    void push(std::unique_ptr<Event> event);
+    void step(std::unique_ptr<Event> event);
+    void armTimer();
+    void finish(bool failed);
+
+    const std::shared_ptr<board::IChessBoard> mBoard;
+    Executor &mExecutor;
+    const std::shared_ptr<Strand> mStrand;
+    const Finished mFinished;
+    const chessman::ChessmanType mType;
+    std::shared_ptr<chessman::IChessMan> mChessMan;
+
+    std::list<std::unique_ptr<Event>> mEvents;
+    std::size_t mCounterStep;
+    bool mStopping;
+    std::uint64_t mTimerGeneration; // a timer fires only if nothing happened since it was armed
+    Executor::TimerId mTimer;       // the armed timer, cancelled when superseded
+    bool mTimerArmed;
+    std::unique_ptr<ParticipantGame::IState> mState;
+};
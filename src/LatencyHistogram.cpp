@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cmath>
+
+#include "LatencyHistogram.h"
+
+LatencyHistogram::LatencyHistogram()
+    : mBuckets()
+    , mCount(0)
+    , mSum(0)
+    , mMax(0)
+{
+    reset();
+}
+
+void LatencyHistogram::record(std::uint64_t nanoseconds) noexcept
+{
+    mBuckets[indexOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    mCount.fetch_add(1, std::memory_order_relaxed);
+    mSum.fetch_add(nanoseconds, std::memory_order_relaxed);
+    auto max = mMax.load(std::memory_order_relaxed);
+    while (max < nanoseconds && !mMax.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds duration) noexcept
+{
+    record(static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(duration.count(), 0)));
+}
+
+void LatencyHistogram::reset() noexcept
+{
+    for (auto &bucket: mBuckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    mCount.store(0, std::memory_order_relaxed);
+    mSum.store(0, std::memory_order_relaxed);
+    mMax.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) noexcept
+{
+    for (std::size_t i = 0; i < sCountBuckets; ++i)
+    {
+        if (auto count = other.mBuckets[i].load(std::memory_order_relaxed); count)
+        {
+            mBuckets[i].fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+    mCount.fetch_add(other.mCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    mSum.fetch_add(other.mSum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    auto otherMax = other.mMax.load(std::memory_order_relaxed);
+    auto max = mMax.load(std::memory_order_relaxed);
+    while (max < otherMax && !mMax.compare_exchange_weak(max, otherMax, std::memory_order_relaxed))
+    {
+    }
+}
+
+std::uint64_t LatencyHistogram::count() const noexcept
+{
+    return mCount.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::sum() const noexcept
+{
+    return mSum.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::percentile(double quantile) const noexcept
+{
+    std::uint64_t total = 0;
+    for (auto &bucket: mBuckets)
+    {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if (!total)
+    {
+        return 0;
+    }
+
+    auto target = static_cast<std::uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(total)));
+    target = std::max<std::uint64_t>(target, 1);
+    std::uint64_t accumulated = 0;
+    for (std::size_t i = 0; i < mBuckets.size(); ++i)
+    {
+        accumulated += mBuckets[i].load(std::memory_order_relaxed);
+        if (accumulated >= target)
+        {
+            return std::min(valueOf(i), mMax.load(std::memory_order_relaxed));
+        }
+    }
+    return mMax.load(std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const noexcept
+{
+    auto count = mCount.load(std::memory_order_relaxed);
+    return Snapshot{count,
+                    count ? mSum.load(std::memory_order_relaxed) / count : 0,
+                    percentile(0.5),
+                    percentile(0.99),
+                    percentile(0.999),
+                    mMax.load(std::memory_order_relaxed)};
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+std::size_t LatencyHistogram::indexOf(std::uint64_t value) noexcept
+{
+    value = std::min<std::uint64_t>(value, (std::uint64_t{1} << sMaxValueBits) - 1);
+    if (value < 2 * sHalfBucket)
+    {
+        return static_cast<std::size_t>(value);
+    }
+    auto msb = 63u - static_cast<std::uint32_t>(__builtin_clzll(value));
+    auto exponent = msb - (sSubBucketBits - 1);
+    return exponent * sHalfBucket + static_cast<std::size_t>(value >> exponent);
+}
+
+std::uint64_t LatencyHistogram::valueOf(std::size_t index) noexcept
+{   // highest value that falls into the bucket
+    if (index < 2 * sHalfBucket)
+    {
+        return index;
+    }
+    auto exponent = index / sHalfBucket - 1;
+    auto mantissa = static_cast<std::uint64_t>(index - exponent * sHalfBucket);
+    return (mantissa << exponent) + (std::uint64_t{1} << exponent) - 1;
+}
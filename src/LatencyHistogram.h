@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/*
+ * Lock-free log-linear (HDR-style) histogram of durations in nanoseconds.
+ * Values below 2^sSubBucketBits are exact, larger ones keep the sSubBucketBits - 1 bits below the
+ * leading one: a bucket is at most 1/64 (about 1.6%) of its values wide, and a percentile, the
+ * highest value of its bucket, overstates by less than that. Recording is a few relaxed atomic
+ * increments, readers may run concurrently with writers and see a slightly stale but consistent
+ * enough picture.
+ */
+class LatencyHistogram
+{
+public:
+    struct Snapshot;
+
+    LatencyHistogram();
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    void record(std::uint64_t nanoseconds) noexcept;
+    void record(std::chrono::nanoseconds duration) noexcept;
+    void reset() noexcept;
+    // adds the counts of `other`, e.g. thread-local histograms into a shared one
+    void merge(const LatencyHistogram &other) noexcept;
+
+    std::uint64_t count() const noexcept;
+    std::uint64_t sum() const noexcept;
+    std::uint64_t percentile(double quantile) const noexcept;
+    Snapshot snapshot() const noexcept;
+
+    static constexpr std::uint32_t sSubBucketBits = 7;
+    static constexpr std::uint32_t sMaxValueBits = 40; // ~18 minutes, larger values are clamped
+
+private:
+    static constexpr std::uint32_t sHalfBucket = 1u << (sSubBucketBits - 1);
+    static constexpr std::size_t sCountBuckets = (sMaxValueBits - sSubBucketBits + 3) * sHalfBucket;
+
+    static std::size_t indexOf(std::uint64_t value) noexcept;
+    static std::uint64_t valueOf(std::size_t index) noexcept;
+
+    std::array<std::atomic<std::uint64_t>, sCountBuckets> mBuckets;
+    std::atomic<std::uint64_t> mCount;
+    std::atomic<std::uint64_t> mSum;
+    std::atomic<std::uint64_t> mMax;
+};
+
+struct LatencyHistogram::Snapshot
+{
+    std::uint64_t mCount;
+    std::uint64_t mMean;
+    std::uint64_t mP50;
+    std::uint64_t mP99;
+    std::uint64_t mP999;
+    std::uint64_t mMax;
+};
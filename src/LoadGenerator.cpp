@@ -0,0 +1,385 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "ChessManImpl.h"
+#include "GameRules.h"
+#include "LoadGenerator.h"
+
+using namespace board;
+
+LoadGenerator::LoadGenerator(std::shared_ptr<board::IChessBoard> board, OpenLoopSettings settings)
+    : TreadBase("LoadGenerator")
+    , mBoard(std::move(board))
+    , mSettings(settings)
+    , mMutex()
+    , mWait()
+    , mStop(false)
+    , mDone(false)
+    , mSlots()
+    , mSlotById()
+    , mIdle()
+    , mBacklog()
+    , mPlaced(0)
+    , mUnplaced(0)
+    , mRetry()
+    , mGenerator(settings.mSeed)
+    , mScheduled(0)
+    , mIssued(0)
+    , mCompleted(0)
+    , mMoved(0)
+    , mCancelled(0)
+    , mRejected(0)
+    , mMaxBacklog(0)
+    , mFirstArrival()
+    , mLastResolution()
+    , mLatency()
+    , mServiceLatency()
+{
+    if (!(mSettings.mRate > 0.0))
+    {
+        throw std::invalid_argument("Open-loop rate must be positive");
+    }
+    auto cells = static_cast<std::size_t>(mBoard->sizeBoard()) * mBoard->sizeBoard();
+    if (!mSettings.mFigures || mSettings.mFigures >= cells)
+    {
+        throw std::invalid_argument("Open-loop figures must leave at least one free cell");
+    }
+}
+
+LoadGenerator::~LoadGenerator()
+{
+    TreadBase::join();
+}
+
+/* ************************************************************
+ * IMPL IGameElement
+ * ************************************************************/
+void LoadGenerator::startGame()
+{
+    std::vector<Slot *> toPlace;
+    if (std::lock_guard lock(mMutex); mSlots.empty())
+    {
+        for (std::size_t i = 0; i < mSettings.mFigures; ++i)
+        {
+            auto slot = std::make_unique<Slot>();
+            auto &pieces = GameRules::settings().mPieces;
+            slot->mFigure = std::make_unique<ChessManImpl>(GameRules::generateId(), pieces[i % pieces.size()]);
+            slot->mState = SlotState::placing;
+            slot->mHome = {static_cast<Coordinate::first_type>(i / mBoard->sizeBoard()),
+                           static_cast<Coordinate::second_type>(i % mBoard->sizeBoard())};
+            mSlotById.emplace(slot->mFigure->getID(), slot.get());
+            toPlace.push_back(slot.get());
+            mSlots.push_back(std::move(slot));
+        }
+    }
+    if (!toPlace.empty())
+    {
+        mBoard->addNotifier(shared_from_this());
+        for (auto slot: toPlace)
+        {
+            mBoard->placeFigure(*slot->mFigure, slot->mHome);
+        }
+        TreadBase::start();
+    }
+}
+
+void LoadGenerator::stopGame()
+{
+    std::lock_guard lock(mMutex);
+    mStop = true;
+    mWait.notify_all();
+}
+
+void LoadGenerator::waitEnd()
+{
+    {
+        std::unique_lock lock(mMutex);
+        mWait.wait(lock, [this]() {
+            return mDone;
+        });
+    }
+    TreadBase::join();
+}
+
+const LatencyHistogram &LoadGenerator::latency() const noexcept
+{
+    return mLatency;
+}
+
+const LatencyHistogram &LoadGenerator::serviceLatency() const noexcept
+{
+    return mServiceLatency;
+}
+
+LoadGenerator::Counters LoadGenerator::counters() const
+{
+    std::lock_guard lock(mMutex);
+    return Counters{mPlaced, mScheduled, mIssued, mCompleted, mMoved, mCancelled, mRejected, mMaxBacklog,
+                    mLastResolution > mFirstArrival ? mLastResolution - mFirstArrival : Clock::duration::zero()};
+}
+
+/* ************************************************************
+ * IMPL TreadBase
+ * ************************************************************/
+void LoadGenerator::loop()
+{
+    std::unique_lock lock(mMutex);
+    // a placement waiting for a cell may never be answered; a late one still joins the schedule
+    auto placing = Clock::now() + mSettings.mDrainTimeout;
+    auto backoff = std::chrono::milliseconds(1);
+    auto settled = [this]() {
+        return mStop || mPlaced + mUnplaced == mSlots.size();
+    };
+    while (mWait.wait_until(lock, placing, [&]() {
+        return settled() || !mRetry.empty();
+    }) && !settled())
+    {   // placements the full board did not queue, sent again after a growing pause
+        if (mWait.wait_until(lock, std::min(Clock::now() + backoff, placing), [this]() {
+            return mStop;
+        }))
+        {
+            break;
+        }
+        backoff = std::min(backoff * 2, std::chrono::milliseconds(64));
+        auto toPlace = std::move(mRetry);
+        mRetry.clear();
+        lock.unlock();
+        for (auto slot: toPlace)
+        {
+            mBoard->placeFigure(*slot->mFigure, slot->mHome);
+        }
+        lock.lock();
+    }
+
+    mFirstArrival = Clock::now();
+    // without a figure on the board no arrival could ever be served
+    auto end = mPlaced ? mFirstArrival + mSettings.mDuration : mFirstArrival;
+    auto next = mFirstArrival;
+    while (!mStop)
+    {
+        for (auto now = Clock::now(); next <= now && next < end; next += nextInterval())
+        {   // arrivals are never skipped, a late sender catches up
+            mBacklog.push_back(next);
+            ++mScheduled;
+        }
+        mMaxBacklog = std::max(mMaxBacklog, mBacklog.size());
+
+        std::vector<std::pair<Slot *, Coordinate>> toSend;
+        while (!mBacklog.empty() && !mIdle.empty())
+        {
+            auto slot = mIdle.back();
+            mIdle.pop_back();
+            slot->mState = SlotState::moving;
+            slot->mIntended = mBacklog.front();
+            mBacklog.pop_front();
+            toSend.emplace_back(slot, GameRules::generateStep(*slot->mFigure, *mBoard));
+        }
+        if (!toSend.empty())
+        {
+            mIssued += toSend.size();
+            lock.unlock();
+            for (auto &[slot, to]: toSend)
+            {
+                slot->mSent = Clock::now();
+                mBoard->moveFigure(*slot->mFigure, to);
+            }
+            lock.lock();
+            continue;
+        }
+
+        if (next >= end && mBacklog.empty())
+        {
+            break;
+        }
+        auto ready = [this]() {
+            return mStop || (!mBacklog.empty() && !mIdle.empty());
+        };
+        if (next < end)
+        {
+            mWait.wait_until(lock, next, ready);
+        } else {
+            mWait.wait(lock, ready);
+        }
+    }
+
+    mWait.wait_until(lock, Clock::now() + mSettings.mDrainTimeout, [this]() {
+        return mIdle.size() == mPlaced;
+    });
+    std::vector<Slot *> toRemove;
+    for (auto slot: mIdle)
+    {
+        slot->mState = SlotState::removing;
+        toRemove.push_back(slot);
+    }
+    mIdle.clear();
+    lock.unlock();
+    for (auto slot: toRemove)
+    {
+        mBoard->removeFigure(*slot->mFigure);
+    }
+    lock.lock();
+    mWait.wait_until(lock, Clock::now() + mSettings.mDrainTimeout, [&]() {
+        return std::all_of(toRemove.begin(), toRemove.end(), [](auto slot) {
+            return slot->mState == SlotState::removed;
+        });
+    });
+}
+
+void LoadGenerator::onStop()
+{
+    mBoard->removeNotifier(shared_from_this());
+    std::lock_guard lock(mMutex);
+    mDone = true;
+    mWait.notify_all();
+}
+
+/* ************************************************************
+ * IMPL board::INotifier
+ * ************************************************************/
+void LoadGenerator::placed(std::uint32_t id, const board::Coordinate &to) noexcept
+{
+    if (std::lock_guard lock(mMutex); auto slot = findSlot(id))
+    {
+        if (slot->mState == SlotState::placing)
+        {
+            slot->mFigure->setCurrentCoordinate(to);
+            ++mPlaced;
+            release(*slot);
+        }
+    }
+}
+
+void LoadGenerator::moved(std::uint32_t id, const board::Coordinate &, const board::Coordinate &to) noexcept
+{
+    if (std::lock_guard lock(mMutex); auto slot = findSlot(id))
+    {
+        if (slot->mState == SlotState::moving || slot->mState == SlotState::cancelling)
+        {
+            slot->mFigure->setCurrentCoordinate(to);
+            ++mMoved;
+            resolve(*slot);
+            if (slot->mState == SlotState::moving)
+            {
+                release(*slot);
+            } else {
+                // the cell was freed before the cancel, its reject is still to come
+                slot->mState = SlotState::cancelGranted;
+            }
+        }
+    }
+}
+
+void LoadGenerator::cancelMoved(std::uint32_t id, const board::Coordinate &, const board::Coordinate &) noexcept
+{
+    if (std::lock_guard lock(mMutex); auto slot = findSlot(id))
+    {
+        if (slot->mState == SlotState::cancelling)
+        {
+            ++mCancelled;
+            resolve(*slot);
+            release(*slot);
+        }
+    }
+}
+
+void LoadGenerator::removed(std::uint32_t id, const board::Coordinate &) noexcept
+{
+    if (std::lock_guard lock(mMutex); auto slot = findSlot(id))
+    {
+        if (slot->mState == SlotState::removing)
+        {
+            slot->mState = SlotState::removed;
+            mWait.notify_all();
+        }
+    }
+}
+
+void LoadGenerator::waitingForCell(std::uint32_t id, const board::Coordinate &, const board::Coordinate &to) noexcept
+{
+    ChessManImpl *figure = nullptr;
+    if (std::lock_guard lock(mMutex); auto slot = findSlot(id))
+    {
+        if (slot->mState == SlotState::moving)
+        {
+            slot->mState = SlotState::cancelling;
+            figure = slot->mFigure.get();
+        }
+    }
+    if (figure)
+    {
+        mBoard->cancelMoveFigure(*figure, to);
+    }
+}
+
+void LoadGenerator::reject(std::uint32_t id, board::ReasonReject reason) noexcept
+{
+    if (std::lock_guard lock(mMutex); auto slot = findSlot(id))
+    {
+        switch (slot->mState) {
+            case SlotState::moving:
+            case SlotState::cancelling:
+                ++mRejected;
+                resolve(*slot);
+                release(*slot);
+                break;
+            case SlotState::cancelGranted:
+                release(*slot);
+                break;
+            case SlotState::placing:
+                if (reason == ReasonReject::overloaded)
+                {
+                    mRetry.push_back(slot);
+                } else {
+                    ++mUnplaced;
+                    slot->mState = SlotState::removed;
+                }
+                break;
+            case SlotState::removing:
+                slot->mState = SlotState::removed;
+                break;
+            case SlotState::idle:
+            case SlotState::removed:
+                break;
+        }
+        if (reason == ReasonReject::boardStopped)
+        {
+            mStop = true;
+        }
+        mWait.notify_all();
+    }
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+LoadGenerator::Slot *LoadGenerator::findSlot(std::uint32_t id)
+{
+    auto it = mSlotById.find(id);
+    return it != mSlotById.end() ? it->second : nullptr;
+}
+
+void LoadGenerator::resolve(Slot &slot)
+{
+    auto now = Clock::now();
+    mLatency.record(now - slot.mIntended);
+    mServiceLatency.record(now - slot.mSent);
+    mLastResolution = now;
+    ++mCompleted;
+}
+
+void LoadGenerator::release(Slot &slot)
+{
+    slot.mState = SlotState::idle;
+    mIdle.push_back(&slot);
+    mWait.notify_all();
+}
+
+LoadGenerator::Clock::duration LoadGenerator::nextInterval()
+{
+    std::chrono::duration<double> seconds(1.0 / mSettings.mRate);
+    if (mSettings.mArrival == ArrivalProcess::poisson)
+    {
+        seconds = std::chrono::duration<double>(std::exponential_distribution<double>(mSettings.mRate)(mGenerator));
+    }
+    return std::max(std::chrono::duration_cast<Clock::duration>(seconds), Clock::duration(1));
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "IChessBoard.h"
+#include "IGameElement.h"
+#include "LatencyHistogram.h"
+#include "TreadBase.h"
+
+class ChessManImpl;
+
+enum class ArrivalProcess
+{
+    constant, poisson
+};
+
+struct OpenLoopSettings
+{
+    ArrivalProcess mArrival = ArrivalProcess::constant;
+    double mRate = 1000.0;                 // commands per second
+    std::size_t mFigures = 4;              // placed on distinct cells before the schedule starts
+    std::chrono::milliseconds mDuration = std::chrono::milliseconds(1000);
+    // bounds the wait for the placements before and for the answers after the schedule
+    std::chrono::milliseconds mDrainTimeout = std::chrono::milliseconds(5000);
+    std::uint64_t mSeed = 1;
+};
+
+/*
+ * Open-loop driver: moves are scheduled at a constant rate or with Poisson arrivals regardless
+ * of how fast the board answers. A scheduled move is sent by the first idle figure; while all
+ * figures are busy it waits in a backlog. Latency is measured from the scheduled (intended) time
+ * to the answer that frees the figure, so queueing past saturation is not hidden (coordinated
+ * omission). A move answered with waitingForCell is cancelled at once and resolves with moved
+ * or cancelMoved. The schedule starts once every placement is answered or after mDrainTimeout;
+ * a placement rejected as overloaded is retried with backoff until then, a figure whose placement
+ * was rejected otherwise stays off the board.
+ */
+class LoadGenerator
+        : public IGameElement
+        , public TreadBase
+        , public board::INotifier
+        , public std::enable_shared_from_this<LoadGenerator>
+{
+public:
+    struct Counters;
+
+    LoadGenerator(std::shared_ptr<board::IChessBoard> board, OpenLoopSettings settings);
+    ~LoadGenerator() override;
+
+    void startGame() override;
+    void stopGame() override;
+    // blocks until the schedule is done and the figures are drained and removed
+    void waitEnd();
+
+    // from the intended send time, what a caller of the board experiences
+    const LatencyHistogram &latency() const noexcept;
+    // from the actual send time, what a closed-loop client would report
+    const LatencyHistogram &serviceLatency() const noexcept;
+    Counters counters() const;
+
+protected:
+    void placed(std::uint32_t id, const board::Coordinate &to) noexcept override;
+    void moved(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
+    void cancelMoved(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
+    void removed(std::uint32_t id, const board::Coordinate &from) noexcept override;
+    void waitingForCell(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
+    void reject(std::uint32_t id, board::ReasonReject reason) noexcept override;
+
+    void loop() override;
+    void onStop() override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Slot;
+    enum class SlotState;
+
+    Slot *findSlot(std::uint32_t id);
+    void resolve(Slot &slot);
+    void release(Slot &slot);
+    Clock::duration nextInterval();
+
+    const std::shared_ptr<board::IChessBoard> mBoard;
+    const OpenLoopSettings mSettings;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mWait;
+    bool mStop;
+    bool mDone;
+    std::vector<std::unique_ptr<Slot>> mSlots;
+    std::unordered_map<std::uint32_t, Slot *> mSlotById;
+    std::vector<Slot *> mIdle;
+    std::deque<Clock::time_point> mBacklog;
+    std::size_t mPlaced;
+    std::size_t mUnplaced;
+    std::vector<Slot *> mRetry; // placements rejected as overloaded
+    std::mt19937_64 mGenerator;
+
+    std::uint64_t mScheduled;
+    std::uint64_t mIssued;
+    std::uint64_t mCompleted;
+    std::uint64_t mMoved;
+    std::uint64_t mCancelled;
+    std::uint64_t mRejected;
+    std::size_t mMaxBacklog;
+    Clock::time_point mFirstArrival;
+    Clock::time_point mLastResolution;
+
+    LatencyHistogram mLatency;
+    LatencyHistogram mServiceLatency;
+};
+
+struct LoadGenerator::Counters
+{
+    std::size_t mPlaced;        // figures on the board, the board rejected the placement of the others
+    std::uint64_t mScheduled;   // arrivals generated by the schedule
+    std::uint64_t mIssued;      // moves sent to the board
+    std::uint64_t mCompleted;   // moves resolved, equals the latency count
+    std::uint64_t mMoved;
+    std::uint64_t mCancelled;   // waited for a cell and were cancelled
+    std::uint64_t mRejected;
+    std::size_t mMaxBacklog;
+    std::chrono::nanoseconds mElapsed; // from the first arrival to the last resolution
+};
+
+enum class LoadGenerator::SlotState
+{
+    placing, idle, moving, cancelling, cancelGranted, removing, removed
+};
+
+struct LoadGenerator::Slot
+{
+    std::unique_ptr<ChessManImpl> mFigure;
+    SlotState mState;
+    board::Coordinate mHome;    // the cell of the placement
+    Clock::time_point mIntended;
+    Clock::time_point mSent;
+};
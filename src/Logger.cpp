@@ -1,6 +1,8 @@
 #include "ostream"
+#include <iterator>
 #include "Logger.h"
 #include "IChessMan.h"
+#include "Tracer.h"
 
 inline std::ostream& operator<<(std::ostream& os, const board::Coordinate& coord)
 {
@@ -9,12 +11,12 @@ inline std::ostream& operator<<(std::ostream& os, const board::Coordinate& coord
 }
 
 inline std::ostream& operator<<(std::ostream& os, const chessman::IChessMan& chessman)
-{
-    switch (chessman.getType()) {
-        case chessman::ChessmanType::rook:
-            os << "rook[" << chessman.getID() << "] " << chessman.getCurrentCoordinate();;
-            break;
-    }
+{   // in the order of chessman::ChessmanType
+    static constexpr const char *sPieces[] = {"rook", "bishop", "queen", "knight", "king"};
+    static_assert(std::size(sPieces) == static_cast<std::size_t>(chessman::ChessmanType::king) + 1);
+
+    os << sPieces[static_cast<std::size_t>(chessman.getType())]
+       << "[" << chessman.getID() << "] " << chessman.getCurrentCoordinate();
     return os;
 }
 
@@ -67,6 +69,12 @@ inline std::ostream& operator<<(std::ostream& os, const board::ReasonReject reas
         case board::ReasonReject::waiterNotFound:
             os << "waiterNotFound";
             break;
+        case board::ReasonReject::pathBlocked:
+            os << "pathBlocked";
+            break;
+        case board::ReasonReject::overloaded:
+            os << "overloaded";
+            break;
     }
     return os;
 }
@@ -78,21 +86,41 @@ inline void print_action(std::ostream &os, Args&&... args)
 }
 
 Logger::Logger(std::ostream &os)
+    : Logger(os, sUnbounded, OverloadPolicy::block)
+{
+
+}
+
+Logger::Logger(std::ostream &os, std::size_t capacity, OverloadPolicy policy, std::size_t sampleRate)
     : TreadBase("Logger")
     , mOut(os)
+    , mMutex()
+    , mWait()
+    , mWaitSpace()
+    , mReasonWeakUp(ReasonWeakUp::fake)
+    , mQueueLog()
+    , mCapacity(capacity)
+    , mPolicy(policy)
+    , mSampleRate(sampleRate ? sampleRate : 1)
+    , mSampleCounter(0)
+    , mDropped(0)
+    , mDelayed(0)
 {
 
 }
 
 Logger::~Logger()
 {
-
-    if (std::lock_guard lock(mMutex); mReasonWeakUp != ReasonWeakUp::stop)
     {
-        mReasonWeakUp = ReasonWeakUp::exit;
-        mWait.notify_all();
-        TreadBase::join();
+        std::lock_guard lock(mMutex);
+        if (mReasonWeakUp != ReasonWeakUp::stop)
+        {
+            mReasonWeakUp = ReasonWeakUp::exit;
+            mWait.notify_all();
+            mWaitSpace.notify_all();
+        }
     }
+    TreadBase::join();
 }
 
 /* ************************************************************
@@ -109,10 +137,16 @@ void Logger::stopGame()
         std::lock_guard lock(mMutex);
         mReasonWeakUp = ReasonWeakUp::stop;
         mWait.notify_all();
+        mWaitSpace.notify_all();
     }
     join();
 }
 
+Logger::Statistic Logger::statistic() const noexcept
+{
+    return Statistic{mDropped.load(std::memory_order_relaxed), mDelayed.load(std::memory_order_relaxed)};
+}
+
 /* ************************************************************
  * IMPL TreadBase
  * ************************************************************/
@@ -130,17 +164,18 @@ void Logger::onStart()
 void Logger::loop()
 {
     std::unique_lock lock(mMutex);
-    while (mReasonWeakUp != ReasonWeakUp::stop)
+    while (mReasonWeakUp != ReasonWeakUp::stop && mReasonWeakUp != ReasonWeakUp::exit)
     {
         while (!mQueueLog.empty())
         {
             auto log = std::move(mQueueLog.front());
             mQueueLog.pop();
+            mWaitSpace.notify_one();
             lock.unlock();
             print(log);
             lock.lock();
         }
-        if (mReasonWeakUp != ReasonWeakUp::stop)
+        if (mReasonWeakUp == ReasonWeakUp::print_log)
         {
             mReasonWeakUp = ReasonWeakUp::fake;
         }
@@ -160,6 +195,10 @@ void Logger::onStop()
             mQueueLog.pop();
         }
     }
+    if (auto statistic = Logger::statistic(); statistic.mDropped || statistic.mDelayed)
+    {
+        mOut << "Logger dropped: " << statistic.mDropped << ", delayed: " << statistic.mDelayed << std::endl;
+    }
     mOut << "Logger stopped.\n";
 }
 
@@ -168,76 +207,127 @@ void Logger::onStop()
  * ************************************************************/
 void Logger::placed(std::uint32_t id, const board::Coordinate &to) noexcept
 {
-    std::lock_guard lock(mMutex);
-    if (mReasonWeakUp != ReasonWeakUp::stop)
-    {
-        mQueueLog.emplace(Action::placed, id, board::Coordinate{}, to, board::ReasonReject::empty);
-        mReasonWeakUp = ReasonWeakUp::print_log;
-        mWait.notify_all();
-    }
+    push(LogStruct(Action::placed, id, board::Coordinate{}, to, board::ReasonReject::empty));
 }
 
 void Logger::moved(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept
 {
-    std::lock_guard lock(mMutex);
-    if (mReasonWeakUp != ReasonWeakUp::stop)
-    {
-        mQueueLog.emplace(Action::moved, id, from, to, board::ReasonReject::empty);
-        mReasonWeakUp = ReasonWeakUp::print_log;
-        mWait.notify_all();
-    }
+    push(LogStruct(Action::moved, id, from, to, board::ReasonReject::empty));
 }
 
 void Logger::cancelMoved(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept
 {
-    std::lock_guard lock(mMutex);
-    if (mReasonWeakUp != ReasonWeakUp::stop)
-    {
-        mQueueLog.emplace(Action::cancelMoved, id, from, to, board::ReasonReject::empty);
-        mReasonWeakUp = ReasonWeakUp::print_log;
-        mWait.notify_all();
-    }
+    push(LogStruct(Action::cancelMoved, id, from, to, board::ReasonReject::empty));
 }
 
 void Logger::removed(std::uint32_t id, const board::Coordinate &from) noexcept
 {
-    std::lock_guard lock(mMutex);
-    if (mReasonWeakUp != ReasonWeakUp::stop)
+    push(LogStruct(Action::removed, id, from, board::Coordinate{}, board::ReasonReject::empty));
+}
+
+void Logger::waitingForCell(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept
+{
+    push(LogStruct(Action::waitingForCell, id, from, to, board::ReasonReject::empty));
+}
+
+void Logger::reject(std::uint32_t id, board::ReasonReject reason) noexcept
+{
+    push(LogStruct(Action::reject, id, board::Coordinate{}, board::Coordinate{}, reason));
+}
+
+void Logger::onEvents(const board::BoardEvent *events, std::size_t count) noexcept
+{   // one lock and one wake-up of the printer for the whole batch
+    using Type = board::BoardEvent::Type;
+    static_assert(static_cast<Action>(Type::placed) == Action::placed);
+    static_assert(static_cast<Action>(Type::moved) == Action::moved);
+    static_assert(static_cast<Action>(Type::cancelMoved) == Action::cancelMoved);
+    static_assert(static_cast<Action>(Type::removed) == Action::removed);
+    static_assert(static_cast<Action>(Type::waitingForCell) == Action::waitingForCell);
+    static_assert(static_cast<Action>(Type::reject) == Action::reject);
+
+    std::unique_lock lock(mMutex);
+    auto queued = false;
+    for (auto event = events; event != events + count; ++event)
     {
-        mQueueLog.emplace(Action::removed, id, from, board::Coordinate{}, board::ReasonReject::empty);
-        mReasonWeakUp = ReasonWeakUp::print_log;
-        mWait.notify_all();
+        queued |= enqueue(lock, LogStruct(static_cast<Action>(event->mType), event->mId, event->mFrom, event->mTo,
+                                          event->mReason));
+    }
+    if (queued)
+    {
+        wakePrinter();
     }
 }
 
-void Logger::waitingForCell(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+void Logger::push(LogStruct &&logStruct)
 {
-    std::lock_guard lock(mMutex);
-    if (mReasonWeakUp != ReasonWeakUp::stop)
+    std::unique_lock lock(mMutex);
+    if (enqueue(lock, std::move(logStruct)))
     {
-        mQueueLog.emplace(Action::waitingForCell, id, from, to, board::ReasonReject::empty);
-        mReasonWeakUp = ReasonWeakUp::print_log;
-        mWait.notify_all();
+        wakePrinter();
     }
 }
 
-void Logger::reject(std::uint32_t id, board::ReasonReject reason) noexcept
+bool Logger::enqueue(std::unique_lock<std::mutex> &lock, LogStruct &&logStruct)
 {
-    std::lock_guard lock(mMutex);
-    if (mReasonWeakUp != ReasonWeakUp::stop)
+    if (mReasonWeakUp == ReasonWeakUp::stop || mReasonWeakUp == ReasonWeakUp::exit)
+    {
+        return false;
+    }
+    if (mCapacity != sUnbounded && mQueueLog.size() >= mCapacity)
+    {
+        switch (mPolicy)
+        {
+            case OverloadPolicy::block:
+                mDelayed.fetch_add(1, std::memory_order_relaxed);
+                // records queued earlier in the same batch have not woken the printer yet
+                wakePrinter();
+                mWaitSpace.wait(lock, [this]() {
+                    return mQueueLog.size() < mCapacity
+                        || mReasonWeakUp == ReasonWeakUp::stop
+                        || mReasonWeakUp == ReasonWeakUp::exit;
+                });
+                if (mReasonWeakUp == ReasonWeakUp::stop || mReasonWeakUp == ReasonWeakUp::exit)
+                {
+                    mDropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                break;
+            case OverloadPolicy::dropNewest:
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            case OverloadPolicy::sample:
+                if (++mSampleCounter % mSampleRate)
+                {
+                    mDropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                [[fallthrough]];
+            case OverloadPolicy::dropOldest:
+                mQueueLog.pop();
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+                break;
+        }
+    }
+    mQueueLog.emplace(std::move(logStruct));
+    return true;
+}
+
+void Logger::wakePrinter()
+{   // under mMutex, a stop or exit is never overridden
+    if (mReasonWeakUp != ReasonWeakUp::stop && mReasonWeakUp != ReasonWeakUp::exit)
     {
-        mQueueLog.emplace(Action::reject, id, board::Coordinate{}, board::Coordinate{}, reason);
         mReasonWeakUp = ReasonWeakUp::print_log;
         mWait.notify_all();
     }
 }
 
-/* ************************************************************
- * IMPL private
- * ************************************************************/
 
 void Logger::print(const Logger::LogStruct log)
 {
+    Tracer::Scope scope("Logger::print");
     switch (log.mAction)
     {
         case Logger::Action::placed:
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <mutex>
 #include <condition_variable>
@@ -13,12 +14,22 @@ class Logger
         , public IGameElement
 {
 public:
+    enum class OverloadPolicy;
+    struct Statistic;
+
     explicit Logger(std::ostream &os);
+    Logger(std::ostream &os, std::size_t capacity, OverloadPolicy policy,
+           std::size_t sampleRate = sDefaultSampleRate);
     ~Logger() override;
 
     void startGame() override;
     void stopGame() override;
 
+    Statistic statistic() const noexcept;
+
+    static constexpr std::size_t sUnbounded = 0;
+    static constexpr std::size_t sDefaultSampleRate = 10;
+
 protected:
     void placed(std::uint32_t id, const board::Coordinate &to) noexcept override;
     void moved(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
@@ -26,6 +37,7 @@ protected:
     void removed(std::uint32_t id, const board::Coordinate &from) noexcept override;
     void waitingForCell(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
     void reject(std::uint32_t id, board::ReasonReject reason) noexcept override;
+    void onEvents(const board::BoardEvent *events, std::size_t count) noexcept override;
 
     void onStart() override;
     void loop() override;
@@ -37,17 +49,43 @@ private:
     struct LogStruct;
     friend std::ostream& operator<<(std::ostream& os, const Logger::Action& action);
     void print(const LogStruct logStruct);
+    void push(LogStruct &&logStruct);
+    // under mMutex; false when the record was dropped or the logger stopped
+    bool enqueue(std::unique_lock<std::mutex> &lock, LogStruct &&logStruct);
+    void wakePrinter();
 
     std::ostream &mOut;
 
     std::mutex mMutex;
     std::condition_variable mWait;
+    std::condition_variable mWaitSpace;
     ReasonWeakUp mReasonWeakUp;
     std::queue<LogStruct> mQueueLog;
+
+    const std::size_t mCapacity;
+    const OverloadPolicy mPolicy;
+    const std::size_t mSampleRate;
+    std::size_t mSampleCounter;
+    std::atomic<std::uint64_t> mDropped;
+    std::atomic<std::uint64_t> mDelayed;
 };
 
-enum class Logger::Action
+enum class Logger::OverloadPolicy
 {
+    block,      // producer waits until the printer frees a slot
+    dropNewest, // incoming record is discarded
+    dropOldest, // oldest queued record is evicted
+    sample      // 1-in-N incoming records evicts the oldest one, the rest are discarded
+};
+
+struct Logger::Statistic
+{
+    std::uint64_t mDropped;
+    std::uint64_t mDelayed;
+};
+
+enum class Logger::Action
+{ // in the order of board::BoardEvent::Type, Logger::onEvents checks it
     placed,
     moved,
     cancelMoved,
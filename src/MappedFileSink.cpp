@@ -0,0 +1,180 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "MappedFileSink.h"
+
+static std::string segmentName(const std::string &prefix, std::size_t index)
+{
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%06zu.log", index);
+    return prefix + suffix;
+}
+
+MappedFileBuf::MappedFileBuf(std::string prefix,
+                             std::size_t segmentSize,
+                             std::chrono::milliseconds rotatePeriod,
+                             std::size_t maxSegments)
+    : std::streambuf()
+    , mPrefix(std::move(prefix))
+    , mSegmentSize(segmentSize)
+    , mRotatePeriod(rotatePeriod)
+    , mMaxSegments(maxSegments)
+    , mFd(-1)
+    , mBase(nullptr)
+    , mIndex(0)
+    , mOpened()
+    , mSegments()
+{
+    if (!mSegmentSize)
+    {
+        throw std::invalid_argument("MappedFileBuf: segment size must be positive");
+    }
+    openSegment(nullptr, 0);
+}
+
+MappedFileBuf::~MappedFileBuf()
+{
+    if (mBase)
+    {
+        closeSegment(static_cast<std::size_t>(pptr() - pbase()));
+    }
+}
+
+const std::string &MappedFileBuf::currentSegment() const noexcept
+{
+    return mSegments.back();
+}
+
+/* ************************************************************
+ * IMPL std::streambuf
+ * ************************************************************/
+MappedFileBuf::int_type MappedFileBuf::overflow(int_type ch)
+{
+    if (!rotate())
+    {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+int MappedFileBuf::sync()
+{
+    if (mRotatePeriod != sNoRotatePeriod && mBase && pptr() != pbase()
+        && std::chrono::steady_clock::now() - mOpened >= mRotatePeriod)
+    {
+        return rotate() ? 0 : -1;
+    }
+    return mBase ? 0 : -1;
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+void MappedFileBuf::openSegment(const char *carry, std::size_t carrySize)
+{
+    auto name = segmentName(mPrefix, ++mIndex);
+    auto fd = ::open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "open " + name);
+    }
+    auto size = static_cast<off_t>(mSegmentSize);
+    if (auto error = ::posix_fallocate(fd, 0, size); error && ::ftruncate(fd, size) < 0)
+    {
+        error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "allocate " + name);
+    }
+    auto base = ::mmap(nullptr, mSegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED)
+    {
+        auto error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "mmap " + name);
+    }
+    ::madvise(base, mSegmentSize, MADV_SEQUENTIAL);
+
+    mFd = fd;
+    mBase = static_cast<char *>(base);
+    mOpened = std::chrono::steady_clock::now();
+    mSegments.push_back(std::move(name));
+    while (mMaxSegments != sKeepAll && mSegments.size() > mMaxSegments)
+    {
+        ::unlink(mSegments.front().c_str());
+        mSegments.pop_front();
+    }
+
+    setp(mBase, mBase + mSegmentSize);
+    if (carrySize)
+    {
+        std::memcpy(mBase, carry, carrySize);
+        pbump(static_cast<int>(carrySize));
+    }
+}
+
+void MappedFileBuf::closeSegment(std::size_t used)
+{
+    ::munmap(mBase, mSegmentSize);
+    // on failure the segment keeps its zero tail, readers still see every record
+    auto truncated = ::ftruncate(mFd, static_cast<off_t>(used));
+    static_cast<void>(truncated);
+    ::close(mFd);
+    mBase = nullptr;
+    mFd = -1;
+    setp(nullptr, nullptr);
+}
+
+bool MappedFileBuf::rotate()
+{
+    if (!mBase)
+    {
+        return false;
+    }
+    // close the segment on the last record boundary and carry the unfinished record over
+    auto used = static_cast<std::size_t>(pptr() - pbase());
+    auto boundary = used;
+    while (boundary && mBase[boundary - 1] != '\n')
+    {
+        --boundary;
+    }
+    if (!boundary)
+    {
+        boundary = used; // a single record longer than a segment is split
+    }
+    std::string carry(mBase + boundary, used - boundary);
+
+    closeSegment(boundary);
+    try {
+        openSegment(carry.data(), carry.size());
+    } catch (std::system_error &) {
+        return false;
+    }
+    return true;
+}
+
+MappedFileSink::MappedFileSink(std::string prefix,
+                               std::size_t segmentSize,
+                               std::chrono::milliseconds rotatePeriod,
+                               std::size_t maxSegments)
+    : std::ostream(nullptr)
+    , mBuf(std::move(prefix), segmentSize, rotatePeriod, maxSegments)
+{   // the stream gets the buffer only once it is constructed, rdbuf clears the badbit of nullptr
+    rdbuf(&mBuf);
+}
+
+const MappedFileBuf &MappedFileSink::buffer() const noexcept
+{
+    return mBuf;
+}
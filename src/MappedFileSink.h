@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <deque>
+
+/*
+ * Stream buffer over pre-allocated memory-mapped segment files.
+ * Records are copied straight into the mapping, so there is no write(2) per record.
+ * A segment is closed when it is full or on the first flush after the rotate period.
+ * A closed segment is truncated to its used size and always ends on a record ('\n') boundary,
+ * so older segments are plain text files: <prefix>.000001.log, <prefix>.000002.log, ...
+ */
+class MappedFileBuf : public std::streambuf
+{
+public:
+    MappedFileBuf(std::string prefix,
+                  std::size_t segmentSize,
+                  std::chrono::milliseconds rotatePeriod = sNoRotatePeriod,
+                  std::size_t maxSegments = sKeepAll);
+    ~MappedFileBuf() override;
+
+    MappedFileBuf(const MappedFileBuf &) = delete;
+    MappedFileBuf &operator=(const MappedFileBuf &) = delete;
+
+    const std::string &currentSegment() const noexcept;
+
+    static constexpr std::chrono::milliseconds sNoRotatePeriod{0};
+    static constexpr std::size_t sKeepAll = 0;
+
+protected:
+    int_type overflow(int_type ch) override;
+    int sync() override;
+
+private:
+    void openSegment(const char *carry, std::size_t carrySize);
+    void closeSegment(std::size_t used);
+    bool rotate();
+
+    const std::string mPrefix;
+    const std::size_t mSegmentSize;
+    const std::chrono::milliseconds mRotatePeriod;
+    const std::size_t mMaxSegments;
+
+    int mFd;
+    char *mBase;
+    std::size_t mIndex;
+    std::chrono::steady_clock::time_point mOpened;
+    std::deque<std::string> mSegments;
+};
+
+class MappedFileSink : public std::ostream
+{
+public:
+    MappedFileSink(std::string prefix,
+                   std::size_t segmentSize,
+                   std::chrono::milliseconds rotatePeriod = MappedFileBuf::sNoRotatePeriod,
+                   std::size_t maxSegments = MappedFileBuf::sKeepAll);
+    ~MappedFileSink() override = default;
+
+    const MappedFileBuf &buffer() const noexcept;
+
+private:
+    MappedFileBuf mBuf;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Coordinate.h"
+#include "IChessMan.h"
+
+/*
+ * Move masks of every piece type, generated at compile time. The board size is chosen at run
+ * time, so the table is indexed by the absolute displacement (|dx|, |dy|) instead of by square,
+ * all the pieces move symmetrically. An entry holds one bit per ChessmanType, checking a move is
+ * one load and one bit test. The board lets figures pass over each other, so there are no
+ * blockers to consider.
+ */
+namespace chessman {
+
+// displacements 0..126 cover GameRules::sMaxSizeBoard, a power of two side keeps the range check to one compare
+inline constexpr std::int32_t sMoveTableSide = 128;
+
+constexpr std::uint8_t typeBit(ChessmanType type) noexcept
+{
+    return static_cast<std::uint8_t>(1u << static_cast<unsigned>(type));
+}
+
+constexpr std::array<std::uint8_t, sMoveTableSide * sMoveTableSide> buildMoveMasks() noexcept
+{
+    std::array<std::uint8_t, sMoveTableSide * sMoveTableSide> masks{};
+    for (std::int32_t dx = 0; dx < sMoveTableSide; ++dx)
+    {
+        for (std::int32_t dy = 0; dy < sMoveTableSide; ++dy)
+        {
+            std::uint8_t mask = 0;
+            if (dx || dy)
+            {
+                if (!dx || !dy)
+                {
+                    mask |= typeBit(ChessmanType::rook) | typeBit(ChessmanType::queen);
+                }
+                if (dx == dy)
+                {
+                    mask |= typeBit(ChessmanType::bishop) | typeBit(ChessmanType::queen);
+                }
+                if ((dx == 1 && dy == 2) || (dx == 2 && dy == 1))
+                {
+                    mask |= typeBit(ChessmanType::knight);
+                }
+                if (dx <= 1 && dy <= 1)
+                {
+                    mask |= typeBit(ChessmanType::king);
+                }
+            }
+            masks[dx * sMoveTableSide + dy] = mask;
+        }
+    }
+    return masks;
+}
+
+inline constexpr auto sMoveMasks = buildMoveMasks();
+
+constexpr bool canMove(ChessmanType type, std::int32_t dx, std::int32_t dy) noexcept
+{
+    auto x = static_cast<std::uint32_t>(dx < 0 ? -dx : dx);
+    auto y = static_cast<std::uint32_t>(dy < 0 ? -dy : dy);
+    return (x | y) < sMoveTableSide && (sMoveMasks[x * sMoveTableSide + y] & typeBit(type));
+}
+
+// the short-range pieces, filtered against the board edges when generating a step
+inline constexpr std::array<board::Coordinate, 8> sKnightOffsets{{
+    {1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}
+}};
+inline constexpr std::array<board::Coordinate, 8> sKingOffsets{{
+    {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}
+}};
+
+// smallest board where the piece can move from every square, a knight in the middle of 3x3 cannot
+constexpr std::int32_t minSizeBoard(ChessmanType type) noexcept
+{
+    return type == ChessmanType::knight ? 4 : 2;
+}
+
+static_assert(canMove(ChessmanType::rook, 0, -5) && !canMove(ChessmanType::rook, 1, 1));
+static_assert(canMove(ChessmanType::bishop, -3, 3) && !canMove(ChessmanType::bishop, 0, 3));
+static_assert(canMove(ChessmanType::queen, 4, -4) && canMove(ChessmanType::queen, 4, 0));
+static_assert(canMove(ChessmanType::knight, -2, 1) && !canMove(ChessmanType::knight, 2, 2));
+static_assert(canMove(ChessmanType::king, 1, -1) && !canMove(ChessmanType::king, 0, 0));
+
+}
@@ -0,0 +1,404 @@
+#include <algorithm>
+#include <thread>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include "Occupancy.h"
+#include "MoveTable.h"
+#include "SlidingAttacks.h"
+
+using namespace board;
+using chessman::ChessmanType;
+
+static std::uint64_t boardMask(std::int32_t sizeBoard)
+{
+    std::uint64_t mask = 0;
+    for (std::int32_t x = 0; x < std::min(sizeBoard, chessman::sBitboardSide); ++x)
+    {
+        for (std::int32_t y = 0; y < std::min(sizeBoard, chessman::sBitboardSide); ++y)
+        {
+            mask |= chessman::squareBit(x * chessman::sBitboardSide + y);
+        }
+    }
+    return mask;
+}
+
+// the square of the set bit of the given rank, counted from the lowest
+static std::int32_t selectBit(std::uint64_t mask, std::uint32_t rank)
+{
+#if defined(__BMI2__)
+    return __builtin_ctzll(_pdep_u64(std::uint64_t(1) << rank, mask));
+#else
+    for (; rank; --rank)
+    {
+        mask &= mask - 1;
+    }
+    return __builtin_ctzll(mask);
+#endif
+}
+
+// [0, count) from a 32-bit draw by a multiply and shift, the bias is below count / 2^32
+static std::uint32_t scale(std::uint32_t random, std::size_t count)
+{
+    return static_cast<std::uint32_t>((std::uint64_t(random) * count) >> 32);
+}
+
+static bool slides(ChessmanType type, const Coordinate &direction)
+{
+    auto straight = !direction.first || !direction.second;
+    switch (type) {
+        case ChessmanType::rook:
+            return straight;
+        case ChessmanType::bishop:
+            return !straight;
+        case ChessmanType::queen:
+            return true;
+        case ChessmanType::knight:
+        case ChessmanType::king:
+            break;
+    }
+    return false;
+}
+
+template<typename Read>
+auto Occupancy::consistent(Read &&read) const
+{
+    while (true)
+    {
+        auto sequence = mSequence.load(std::memory_order_acquire);
+        if (sequence & 1u)
+        {   // the board thread is in the middle of a write
+            std::this_thread::yield();
+            continue;
+        }
+        auto result = read();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (mSequence.load(std::memory_order_relaxed) == sequence)
+        {
+            return result;
+        }
+    }
+}
+
+Occupancy::Occupancy(std::int32_t sizeBoard)
+    : mSizeBoard(sizeBoard)
+    , mBoardMask(boardMask(sizeBoard))
+    , mBitboard(0)
+    , mLines()
+    , mSequence(0)
+{
+    if (isBitboard())
+    {   // fill the attack tables here rather than on the first move of the board thread
+        chessman::rookAttacks(0, 0);
+        chessman::bishopAttacks(0, 0);
+    } else {
+        auto words = static_cast<std::size_t>(2 * antiDiagonal(sizeBoard - 1, sizeBoard - 1) + 2);
+        mLines = std::make_unique<std::atomic<std::uint64_t>[]>(words);
+        for (std::size_t word = 0; word < words; ++word)
+        {
+            mLines[word].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Occupancy::set(const Coordinate &coordinate) noexcept
+{
+    if (isBitboard())
+    {   // the board thread is the only writer, a plain load and store publish the word
+        auto bitboard = mBitboard.load(std::memory_order_relaxed);
+        mBitboard.store(bitboard | chessman::squareBit(chessman::toSquare(coordinate)), std::memory_order_relaxed);
+        return;
+    }
+    auto sequence = mSequence.load(std::memory_order_relaxed);
+    mSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    update(coordinate, true);
+    mSequence.store(sequence + 2, std::memory_order_release);
+}
+
+void Occupancy::reset(const Coordinate &coordinate) noexcept
+{
+    if (isBitboard())
+    {
+        auto bitboard = mBitboard.load(std::memory_order_relaxed);
+        mBitboard.store(bitboard & ~chessman::squareBit(chessman::toSquare(coordinate)), std::memory_order_relaxed);
+        return;
+    }
+    auto sequence = mSequence.load(std::memory_order_relaxed);
+    mSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    update(coordinate, false);
+    mSequence.store(sequence + 2, std::memory_order_release);
+}
+
+void Occupancy::move(const Coordinate &from, const Coordinate &to) noexcept
+{
+    if (isBitboard())
+    {
+        auto bitboard = mBitboard.load(std::memory_order_relaxed);
+        bitboard &= ~chessman::squareBit(chessman::toSquare(from));
+        mBitboard.store(bitboard | chessman::squareBit(chessman::toSquare(to)), std::memory_order_relaxed);
+        return;
+    }
+    auto sequence = mSequence.load(std::memory_order_relaxed);
+    mSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    update(from, false);
+    update(to, true);
+    mSequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool Occupancy::test(const Coordinate &coordinate) const noexcept
+{
+    if (isBitboard())
+    {
+        return mBitboard.load(std::memory_order_relaxed) & chessman::squareBit(chessman::toSquare(coordinate));
+    }
+    return consistent([&]() {
+        return static_cast<bool>((line(row(coordinate.first)) >> coordinate.second) & 1);
+    });
+}
+
+bool Occupancy::pathClear(chessman::ChessmanType type, const Coordinate &from, const Coordinate &to) const noexcept
+{
+    using chessman::ChessmanType;
+    if (type == ChessmanType::knight || type == ChessmanType::king)
+    {
+        return true;
+    }
+    auto x = from.first;
+    auto y = from.second;
+    auto straight = x == to.first || y == to.second;
+    if (isBitboard())
+    {
+        auto square = chessman::toSquare(from);
+        auto bitboard = mBitboard.load(std::memory_order_relaxed);
+        auto attacks = straight ? chessman::rookAttacks(square, bitboard) : chessman::bishopAttacks(square, bitboard);
+        return attacks & chessman::squareBit(chessman::toSquare(to));
+    }
+    if (x == to.first)
+    {
+        return clear(row(x), y, to.second);
+    }
+    if (y == to.second)
+    {
+        return clear(column(y), x, to.first);
+    }
+    if (x - y == to.first - to.second)
+    {
+        return clear(diagonal(x, y), x, to.first);
+    }
+    return clear(antiDiagonal(x, y), x, to.first);
+}
+
+std::uint64_t Occupancy::destinationMask(ChessmanType type, const Coordinate &from, bool blocking) const noexcept
+{
+    auto square = chessman::toSquare(from);
+    auto occupied = mBitboard.load(std::memory_order_relaxed);
+    auto blockers = blocking ? occupied : 0;
+    std::uint64_t reachable = 0;
+    switch (type) {
+        case ChessmanType::rook:
+            reachable = chessman::rookAttacks(square, blockers);
+            break;
+        case ChessmanType::bishop:
+            reachable = chessman::bishopAttacks(square, blockers);
+            break;
+        case ChessmanType::queen:
+            reachable = chessman::rookAttacks(square, blockers) | chessman::bishopAttacks(square, blockers);
+            break;
+        case ChessmanType::knight:
+        case ChessmanType::king:
+            for (auto &[dx, dy]: type == ChessmanType::knight ? chessman::sKnightOffsets : chessman::sKingOffsets)
+            {
+                auto x = from.first + dx;
+                auto y = from.second + dy;
+                if (x >= 0 && y >= 0 && x < chessman::sBitboardSide && y < chessman::sBitboardSide)
+                {
+                    reachable |= chessman::squareBit(x * chessman::sBitboardSide + y);
+                }
+            }
+            break;
+    }
+    return reachable & mBoardMask & ~occupied;
+}
+
+void Occupancy::destinations(ChessmanType type, const Coordinate &from, bool blocking,
+                             std::vector<Coordinate> &destinations) const
+{
+    destinations.clear();
+    if (isBitboard())
+    {
+        for (auto mask = destinationMask(type, from, blocking); mask; mask &= mask - 1)
+        {
+            auto square = __builtin_ctzll(mask);
+            destinations.emplace_back(square / chessman::sBitboardSide, square % chessman::sBitboardSide);
+        }
+        return;
+    }
+    auto inside = [this](std::int32_t x, std::int32_t y) {
+        return x >= 0 && y >= 0 && x < mSizeBoard && y < mSizeBoard;
+    };
+    auto free = [this](const Coordinate &cell) {
+        return !((line(row(cell.first)) >> cell.second) & 1);
+    };
+    consistent([&]() {
+        destinations.clear();
+        if (type == ChessmanType::knight || type == ChessmanType::king)
+        {
+            for (auto &[dx, dy]: type == ChessmanType::knight ? chessman::sKnightOffsets : chessman::sKingOffsets)
+            {
+                Coordinate to(from.first + dx, from.second + dy);
+                if (inside(to.first, to.second) && free(to))
+                {
+                    destinations.push_back(to);
+                }
+            }
+            return true;
+        }
+        for (auto &direction: chessman::sKingOffsets)
+        {
+            if (!slides(type, direction))
+            {
+                continue;
+            }
+            auto x = from.first + direction.first;
+            auto y = from.second + direction.second;
+            for (; inside(x, y); x += direction.first, y += direction.second)
+            {
+                Coordinate to(x, y);
+                if (free(to))
+                {
+                    destinations.push_back(to);
+                } else if (blocking) {
+                    break;
+                }
+            }
+        }
+        return true;
+    });
+}
+
+void Occupancy::occupied(std::vector<Coordinate> &cells) const
+{
+    cells.clear();
+    if (isBitboard())
+    {
+        for (auto mask = mBitboard.load(std::memory_order_relaxed); mask; mask &= mask - 1)
+        {
+            auto square = __builtin_ctzll(mask);
+            cells.emplace_back(square / chessman::sBitboardSide, square % chessman::sBitboardSide);
+        }
+        return;
+    }
+    for (std::int32_t x = 0; x < mSizeBoard; ++x)
+    {
+        for (auto cells_of_row = line(row(x)); cells_of_row; cells_of_row &= cells_of_row - 1)
+        {
+            auto low = static_cast<std::uint64_t>(cells_of_row);
+            auto y = low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<std::uint64_t>(cells_of_row >> 64u));
+            cells.emplace_back(x, y);
+        }
+    }
+}
+
+bool Occupancy::sampleDestination(ChessmanType type, const Coordinate &from, bool blocking,
+                                  std::uint32_t random, Coordinate &to) const
+{
+    if (isBitboard())
+    {
+        auto mask = destinationMask(type, from, blocking);
+        if (!mask)
+        {
+            return false;
+        }
+        auto square = selectBit(mask, scale(random, __builtin_popcountll(mask)));
+        to = {static_cast<Coordinate::first_type>(square / chessman::sBitboardSide),
+              static_cast<Coordinate::second_type>(square % chessman::sBitboardSide)};
+        return true;
+    }
+    static thread_local std::vector<Coordinate> cells;
+    destinations(type, from, blocking, cells);
+    if (cells.empty())
+    {
+        return false;
+    }
+    to = cells[scale(random, cells.size())];
+    return true;
+}
+
+bool Occupancy::isBitboard() const noexcept
+{
+    return mSizeBoard <= chessman::sBitboardSide;
+}
+
+std::uint64_t Occupancy::bitboard() const noexcept
+{
+    return mBitboard.load(std::memory_order_relaxed);
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+Occupancy::Line Occupancy::between(std::int32_t from, std::int32_t to) noexcept
+{
+    auto low = std::min(from, to);
+    auto high = std::max(from, to);
+    return ((Line(1) << high) - 1) & ~((Line(2) << low) - 1);
+}
+
+bool Occupancy::clear(std::size_t index, std::int32_t from, std::int32_t to) const noexcept
+{
+    return !(line(index) & between(from, to));
+}
+
+std::size_t Occupancy::row(std::int32_t x) const noexcept
+{
+    return static_cast<std::size_t>(x);
+}
+
+std::size_t Occupancy::column(std::int32_t y) const noexcept
+{
+    return static_cast<std::size_t>(mSizeBoard + y);
+}
+
+std::size_t Occupancy::diagonal(std::int32_t x, std::int32_t y) const noexcept
+{
+    return static_cast<std::size_t>(2 * mSizeBoard + x - y + mSizeBoard - 1);
+}
+
+std::size_t Occupancy::antiDiagonal(std::int32_t x, std::int32_t y) const noexcept
+{
+    return static_cast<std::size_t>(4 * mSizeBoard - 1 + x + y);
+}
+
+Occupancy::Line Occupancy::line(std::size_t index) const noexcept
+{
+    auto low = mLines[2 * index].load(std::memory_order_relaxed);
+    auto high = mLines[2 * index + 1].load(std::memory_order_relaxed);
+    return (Line(high) << 64u) | low;
+}
+
+void Occupancy::storeLine(std::size_t index, Line line) noexcept
+{
+    mLines[2 * index].store(static_cast<std::uint64_t>(line), std::memory_order_relaxed);
+    mLines[2 * index + 1].store(static_cast<std::uint64_t>(line >> 64u), std::memory_order_relaxed);
+}
+
+void Occupancy::update(const Coordinate &coordinate, bool occupied) noexcept
+{   // board thread, inside a write of the sequence
+    auto x = coordinate.first;
+    auto y = coordinate.second;
+    auto change = [&](std::size_t index, std::int32_t bit) {
+        auto mask = Line(1) << bit;
+        auto current = line(index);
+        storeLine(index, occupied ? current | mask : current & ~mask);
+    };
+    change(row(x), y);
+    change(column(y), x);
+    change(diagonal(x, y), x);
+    change(antiDiagonal(x, y), x);
+}
+
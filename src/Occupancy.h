@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Coordinate.h"
+#include "IChessMan.h"
+
+/*
+ * Occupied cells of a board, kept by the board thread. Boards up to 8x8 live in one bitboard and
+ * use the magic sliding attacks, larger boards keep one 128-bit mask per row, column and diagonal
+ * so that a path is still checked with one mask test.
+ *
+ * Only the board thread writes. Other threads may call test, destinations and sampleDestination
+ * meanwhile without a lock: a bitboard is one atomic word, the masks of a larger board are read
+ * under a sequence counter and read again when a write overlapped.
+ */
+class Occupancy
+{
+public:
+    explicit Occupancy(std::int32_t sizeBoard);
+
+    void set(const board::Coordinate &coordinate) noexcept;
+    void reset(const board::Coordinate &coordinate) noexcept;
+    // reset `from` and set `to` at once, a reader never sees the figure on neither cell
+    void move(const board::Coordinate &from, const board::Coordinate &to) noexcept;
+    bool test(const board::Coordinate &coordinate) const noexcept;
+
+    // no occupied cell strictly between `from` and `to`, the move must be legal for the piece,
+    // knights and kings never slide
+    bool pathClear(chessman::ChessmanType type, const board::Coordinate &from, const board::Coordinate &to) const noexcept;
+
+    // the free cells a figure of `type` on `from` may move to; with `blocking` sliders stop at the
+    // first occupied cell of a ray, otherwise they pass over occupied cells
+    std::uint64_t destinationMask(chessman::ChessmanType type, const board::Coordinate &from, bool blocking) const noexcept; // isBitboard() only
+    // the same cells as a list on any board size, replaces the content of `destinations`
+    void destinations(chessman::ChessmanType type, const board::Coordinate &from, bool blocking,
+                      std::vector<board::Coordinate> &destinations) const;
+    // one of the destinations without listing them on a bitboard, `random` is a uniform 32-bit
+    // draw; false when there is none
+    bool sampleDestination(chessman::ChessmanType type, const board::Coordinate &from, bool blocking,
+                           std::uint32_t random, board::Coordinate &to) const;
+
+    // the occupied cells, replaces the content of `cells`; a bitboard costs one step per cell,
+    // larger boards one more per row
+    void occupied(std::vector<board::Coordinate> &cells) const;
+
+    bool isBitboard() const noexcept;
+    // valid while isBitboard(), square = x * 8 + y
+    std::uint64_t bitboard() const noexcept;
+
+private:
+    using Line = unsigned __int128;
+
+    static Line between(std::int32_t from, std::int32_t to) noexcept;
+    bool clear(std::size_t line, std::int32_t from, std::int32_t to) const noexcept;
+
+    // the lines of a cell: its row, column, diagonal and anti-diagonal, and its bit in each
+    std::size_t row(std::int32_t x) const noexcept;
+    std::size_t column(std::int32_t y) const noexcept;
+    std::size_t diagonal(std::int32_t x, std::int32_t y) const noexcept;
+    std::size_t antiDiagonal(std::int32_t x, std::int32_t y) const noexcept;
+    Line line(std::size_t index) const noexcept;
+    void storeLine(std::size_t index, Line line) noexcept;
+    void update(const board::Coordinate &coordinate, bool occupied) noexcept;
+    // runs `read` until no write overlapped it, `read` must only read the lines
+    template<typename Read>
+    auto consistent(Read &&read) const;
+
+    const std::int32_t mSizeBoard;
+    const std::uint64_t mBoardMask;   // the squares of a board smaller than 8x8
+    std::atomic<std::uint64_t> mBitboard;
+    // sizes above 8 only: row x holds bit y, column y bit x, diagonals x - y and x + y hold bit x;
+    // two words per line, the rows first, then the columns, diagonals and anti-diagonals
+    std::unique_ptr<std::atomic<std::uint64_t>[]> mLines;
+    std::atomic<std::uint32_t> mSequence; // odd while the board thread writes the lines
+};
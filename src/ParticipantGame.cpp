@@ -2,22 +2,32 @@
 #include "ParticipantGame.h"
 #include "GameRules.h"
 #include "IChessMan.h"
+#include "Tracer.h"
 #include "state/WaitForConfirmStep.h"
 
 using namespace board;
 
 ParticipantGame::ParticipantGame(std::shared_ptr<board::IChessBoard> board, size_t countStep,
                                  std::weak_ptr<pthread_barrier_t> startBarrier,
-                                 std::weak_ptr<pthread_barrier_t> endBarrier)
+                                 std::weak_ptr<pthread_barrier_t> endBarrier,
+                                 chessman::ChessmanType type,
+                                 bool reusable)
         : TreadBase("ParticipantGame")
         , mStartBarrier(std::move(startBarrier))
         , mEndBarrier(std::move(endBarrier))
         , mBoard(std::move(board))
+        , mType(type)
         , mChessMan(nullptr)
         , mMutex()
         , mWait()
         , mReasonWeakUp(ParticipantGame::ReasonWeakUp::start)
+        , mEvents()
+        , mCountStep(countStep)
         , mCounterStep(countStep)
+        , mReusable(reusable)
+        , mReleased(false)
+        , mGameOver(false)
+        , mExit(false)
         , pThis(nullptr)
 {
 
@@ -32,21 +42,42 @@ ParticipantGame::~ParticipantGame()
  * IMPL IGameElement
  * ************************************************************/
 void ParticipantGame::startGame()
-{
-    if (std::lock_guard lock(mMutex); mReasonWeakUp == ReasonWeakUp::start)
+{   // the board notifies under its notifier lock and the notifications take mMutex, so
+    // addNotifier runs outside of mMutex
+    std::unique_lock lock(mMutex);
+    if (mReasonWeakUp == ReasonWeakUp::start)
     {
         mReasonWeakUp = ReasonWeakUp::next_step;
-        mChessMan = GameRules::makeChessMan(chessman::ChessmanType::rook);
+        mChessMan = GameRules::makeChessMan(mType);
+        lock.unlock();
         mBoard->addNotifier(shared_from_this());
         TreadBase::start();
+    } else if (mGameOver && !mExit) {
+        mReasonWeakUp = ReasonWeakUp::next_step;
+        mCounterStep = mCountStep;
+        mEvents.clear();
+        mChessMan = GameRules::makeChessMan(mType);
+        lock.unlock();
+        mBoard->addNotifier(shared_from_this());
+        lock.lock();
+        mGameOver = false;
+        mWait.notify_all();
     }
 }
 
+void ParticipantGame::release()
+{
+    std::lock_guard lock(mMutex);
+    mReleased = true;
+    mWait.notify_all();
+}
+
 void ParticipantGame::stopGame()
 {
     mBoard->removeNotifier(shared_from_this());
     std::lock_guard lock(mMutex);
     mReasonWeakUp = ParticipantGame::ReasonWeakUp::stop;
+    mExit = true;
     mWait.notify_all();
 }
 
@@ -56,47 +87,29 @@ void ParticipantGame::stopGame()
 void ParticipantGame::onStart()
 {
     pThis = shared_from_this();
-    if (auto barrier = mStartBarrier.lock(); barrier)
-    {
-        pthread_barrier_wait(barrier.get());
-    }
-    mState = std::make_unique<WaitForConfirmStep>(mBoard, mChessMan);
-    mBoard->placeFigure(*mChessMan, GameRules::generateFirstStep());
 }
 
 void ParticipantGame::loop()
 {
-    while (!mState->stop())
     {
-        std::unique_ptr<Event> event;
+        std::unique_lock lock(mMutex);
+        mWait.wait(lock, [this]() {
+            return mReleased || mExit;
+        });
+        if (!mReleased)
         {
-            std::unique_lock lock(mMutex);
-            mWait.wait_for(lock, mState->waitPeriod(), [&]() {
-                return !mEvents.empty();
-            });
-            if (mReasonWeakUp == ReasonWeakUp::stop)
-            {
-                mEvents.emplace_back(std::make_unique<Event>(ParticipantGame::Event::Type::stop,
-                                     board::invalidCoordinate,
-                                     board::ReasonReject::empty));
-            }
-            if (!mEvents.empty())
-            {
-                event = std::move(mEvents.front());
-                mEvents.pop_front();
-            }
+            return;
         }
-
-        mState = mState->doWork(std::move(event));
+    }
+    playGame();
+    while (mReusable && park())
+    {
+        playGame();
     }
 }
 
 void ParticipantGame::onStop()
 {
-    if (auto barrier = mEndBarrier.lock(); barrier)
-    {
-        pthread_barrier_wait(barrier.get());
-    }
     pThis.reset();
 }
 
@@ -105,65 +118,53 @@ void ParticipantGame::onStop()
  * ************************************************************/
 void ParticipantGame::placed(std::uint32_t id, const board::Coordinate &to) noexcept
 {
-    if (std::lock_guard lock(mMutex); id == mChessMan->getID() && mReasonWeakUp != ParticipantGame::ReasonWeakUp::stop)
-    {
-        mReasonWeakUp = ParticipantGame::ReasonWeakUp::next_step;
-        mEvents.emplace_back(std::make_unique<Event>(Event::Type::placed, to, board::ReasonReject::empty));
-        mWait.notify_all();
-    }
+    BoardEvent event{id, BoardEvent::Type::placed, ReasonReject::empty, invalidCoordinate, to};
+    onEvents(&event, 1);
 }
 
 void ParticipantGame::moved(std::uint32_t id, const Coordinate &from, const Coordinate &to) noexcept
 {
-    if (std::lock_guard lock(mMutex); id == mChessMan->getID() && mReasonWeakUp != ParticipantGame::ReasonWeakUp::stop)
-    {
-        mEvents.emplace_back(std::make_unique<Event>(Event::Type::moved, to, ReasonReject::empty));
-        if (--mCounterStep)
-        {
-            mReasonWeakUp = ParticipantGame::ReasonWeakUp::next_step;
-        } else {
-            mReasonWeakUp = ParticipantGame::ReasonWeakUp::stop;
-        }
-        mWait.notify_all();
-    }
+    BoardEvent event{id, BoardEvent::Type::moved, ReasonReject::empty, from, to};
+    onEvents(&event, 1);
 }
 
 void ParticipantGame::cancelMoved(std::uint32_t id, const Coordinate &from, const Coordinate &to) noexcept
 {
-    if (std::lock_guard lock(mMutex); id == mChessMan->getID() && mReasonWeakUp != ParticipantGame::ReasonWeakUp::stop)
-    {
-        mReasonWeakUp = ParticipantGame::ReasonWeakUp::next_step;
-        mEvents.emplace_back(std::make_unique<Event>(Event::Type::cancelMoved, to, ReasonReject::empty));
-        mWait.notify_all();
-    }
+    BoardEvent event{id, BoardEvent::Type::cancelMoved, ReasonReject::empty, from, to};
+    onEvents(&event, 1);
 }
 
 void ParticipantGame::removed(std::uint32_t id, const Coordinate &from) noexcept
 {
-    if (std::lock_guard lock(mMutex); id == mChessMan->getID() && mReasonWeakUp != ParticipantGame::ReasonWeakUp::stop)
-    {
-        mReasonWeakUp = ParticipantGame::ReasonWeakUp::next_step;
-        mEvents.emplace_back(std::make_unique<Event>(Event::Type::remove, invalidCoordinate, ReasonReject::empty));
-        mWait.notify_all();
-    }
+    BoardEvent event{id, BoardEvent::Type::removed, ReasonReject::empty, from, invalidCoordinate};
+    onEvents(&event, 1);
 }
 
 void ParticipantGame::waitingForCell(std::uint32_t id, const Coordinate &from, const Coordinate &to) noexcept
 {
-    if (std::lock_guard lock(mMutex); id == mChessMan->getID() && mReasonWeakUp != ParticipantGame::ReasonWeakUp::stop)
-    {
-        mReasonWeakUp = ParticipantGame::ReasonWeakUp::next_step;
-        mEvents.emplace_back(std::make_unique<Event>(Event::Type::waitingForCell, to, ReasonReject::empty));
-        mWait.notify_all();
-    }
+    BoardEvent event{id, BoardEvent::Type::waitingForCell, ReasonReject::empty, from, to};
+    onEvents(&event, 1);
 }
 
 void ParticipantGame::reject(std::uint32_t id, board::ReasonReject reason) noexcept
 {
-    if (std::lock_guard lock(mMutex); id == mChessMan->getID() && mReasonWeakUp != ParticipantGame::ReasonWeakUp::stop)
+    BoardEvent event{id, BoardEvent::Type::reject, reason, invalidCoordinate, invalidCoordinate};
+    onEvents(&event, 1);
+}
+
+void ParticipantGame::onEvents(const board::BoardEvent *events, std::size_t count) noexcept
+{   // the events of other figures are skipped, the thread is woken once per batch
+    std::lock_guard lock(mMutex);
+    auto queued = mEvents.size();
+    for (auto event = events; event != events + count && mReasonWeakUp != ReasonWeakUp::stop; ++event)
+    {
+        if (event->mId == mChessMan->getID())
+        {
+            accept(*event);
+        }
+    }
+    if (mEvents.size() != queued)
     {
-        mReasonWeakUp = ParticipantGame::ReasonWeakUp::next_step;
-        mEvents.emplace_back(std::make_unique<Event>(Event::Type::reject, invalidCoordinate, reason));
         mWait.notify_all();
     }
 }
@@ -171,3 +172,85 @@ void ParticipantGame::reject(std::uint32_t id, board::ReasonReject reason) noexc
 /* ************************************************************
  * IMPL private
  * ************************************************************/
+void ParticipantGame::accept(const board::BoardEvent &event)
+{   // under mMutex, for an event of this figure
+    mReasonWeakUp = ReasonWeakUp::next_step;
+    switch (event.mType) {
+        case BoardEvent::Type::placed:
+            mEvents.emplace_back(std::make_unique<Event>(Event::Type::placed, event.mTo, ReasonReject::empty));
+            break;
+        case BoardEvent::Type::moved:
+            mEvents.emplace_back(std::make_unique<Event>(Event::Type::moved, event.mTo, ReasonReject::empty));
+            if (!--mCounterStep)
+            {
+                mReasonWeakUp = ReasonWeakUp::stop;
+            }
+            break;
+        case BoardEvent::Type::cancelMoved:
+            mEvents.emplace_back(std::make_unique<Event>(Event::Type::cancelMoved, event.mTo, ReasonReject::empty));
+            break;
+        case BoardEvent::Type::removed:
+            mEvents.emplace_back(std::make_unique<Event>(Event::Type::remove, invalidCoordinate, ReasonReject::empty));
+            break;
+        case BoardEvent::Type::waitingForCell:
+            mEvents.emplace_back(std::make_unique<Event>(Event::Type::waitingForCell, event.mTo,
+                                                         ReasonReject::empty));
+            break;
+        case BoardEvent::Type::reject:
+            mEvents.emplace_back(std::make_unique<Event>(Event::Type::reject, invalidCoordinate, event.mReason));
+            break;
+    }
+}
+
+void ParticipantGame::playGame()
+{
+    if (auto barrier = mStartBarrier.lock(); barrier)
+    {
+        pthread_barrier_wait(barrier.get());
+    }
+    mState = std::make_unique<WaitForConfirmStep>(mBoard, mChessMan);
+    mBoard->placeFigure(*mChessMan, GameRules::generateFirstStep());
+    while (!mState->stop())
+    {
+        std::unique_ptr<Event> event;
+        {
+            std::unique_lock lock(mMutex);
+            mWait.wait_for(lock, mState->waitPeriod(), [&]() {
+                return !mEvents.empty();
+            });
+            if (mReasonWeakUp == ReasonWeakUp::stop)
+            {
+                mEvents.emplace_back(std::make_unique<Event>(ParticipantGame::Event::Type::stop,
+                                     board::invalidCoordinate,
+                                     board::ReasonReject::empty));
+            }
+            if (!mEvents.empty())
+            {
+                event = std::move(mEvents.front());
+                mEvents.pop_front();
+            }
+        }
+
+        Tracer::Scope scope(mState->name());
+        mState = mState->doWork(std::move(event));
+    }
+    // nothing of this game reaches the participant once the others are released
+    mBoard->removeNotifier(shared_from_this());
+    {
+        std::lock_guard lock(mMutex);
+        mGameOver = true;
+    }
+    if (auto barrier = mEndBarrier.lock(); barrier)
+    {
+        pthread_barrier_wait(barrier.get());
+    }
+}
+
+bool ParticipantGame::park()
+{
+    std::unique_lock lock(mMutex);
+    mWait.wait(lock, [this]() {
+        return !mGameOver || mExit;
+    });
+    return !mExit;
+}
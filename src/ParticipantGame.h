@@ -9,6 +9,7 @@
 #include "IGameElement.h"
 #include "TreadBase.h"
 #include "IChessBoard.h"
+#include "IChessMan.h"
 
 
 class ParticipantGame
@@ -21,12 +22,21 @@ public:
     class IState;
     struct Event;
 
+    // a reusable participant parks its thread after the end barrier instead of leaving, the next
+    // startGame plays another game with a new figure on the same barriers
     ParticipantGame(std::shared_ptr<board::IChessBoard> board, size_t countStep,
                     std::weak_ptr<pthread_barrier_t> startBarrier,
-                    std::weak_ptr<pthread_barrier_t> endBarrier);
+                    std::weak_ptr<pthread_barrier_t> endBarrier,
+                    chessman::ChessmanType type = chessman::ChessmanType::rook,
+                    bool reusable = false);
     ~ParticipantGame() override;
 
+    // starts the thread, or the next game of a parked reusable participant
     void startGame() override;
+    // the thread waits for release before the start barrier, so that a participant stopped before
+    // all of them run, e.g. when Game cannot start the next one, leaves without its first game
+    void release();
+    // stops the game and lets the thread leave, parked or not
     void stopGame() override;
 
 protected:
@@ -36,6 +46,7 @@ protected:
     void removed(std::uint32_t id, const board::Coordinate &from) noexcept override;
     void waitingForCell(std::uint32_t id, const board::Coordinate &from, const board::Coordinate &to) noexcept override;
     void reject(std::uint32_t id, board::ReasonReject reason) noexcept override;
+    void onEvents(const board::BoardEvent *events, std::size_t count) noexcept override;
 
     void onStart() override;
     void loop() override;
@@ -44,15 +55,27 @@ protected:
 private:
     enum class ReasonWeakUp;
 
+    // under mMutex: queues an event of this figure for the state
+    void accept(const board::BoardEvent &event);
+    void playGame();
+    // false when the thread is to leave instead of playing again
+    bool park();
+
     std::weak_ptr<pthread_barrier_t> mStartBarrier, mEndBarrier;
     std::shared_ptr<board::IChessBoard> mBoard;
+    const chessman::ChessmanType mType;
     std::shared_ptr<chessman::IChessMan> mChessMan;
 
     std::mutex mMutex;
     std::condition_variable mWait;
     ReasonWeakUp mReasonWeakUp;
     std::list<std::unique_ptr<Event>> mEvents;
+    const std::size_t mCountStep;
     std::size_t mCounterStep;
+    const bool mReusable;
+    bool mReleased;
+    bool mGameOver; // the thread passed the end barrier and waits for the next game
+    bool mExit;
 
     std::unique_ptr<IState> mState;
     std::shared_ptr<ParticipantGame> pThis;
@@ -88,4 +111,5 @@ public:
     virtual std::unique_ptr<IState> doWork(std::unique_ptr<Event>) = 0;
     virtual std::chrono::milliseconds waitPeriod() const = 0;
     virtual bool stop() const = 0;
+    virtual const char *name() const = 0;
 };
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Coordinate.h"
+#include "IChessMan.h"
+
+/*
+ * A board split by rows among partitions, each a ChessBoardImpl of its own behind a BoardServer,
+ * usually in a process of its own. Partition k of n serves the rows [k * size / n, (k + 1) * size / n);
+ * its board still allocates the cells of all rows.
+ *
+ * A move to a cell of another partition is a two-phase hand-off between the two boards. The source
+ * checks the figure and asks the target to prepare; the target reserves the free cell and answers
+ * granted, or queues the figure as a waiter of the cell and answers waiting, then granted once the
+ * cell is freed. On granted the source commits: it frees the cell and notifies moved, or, when the
+ * figure left its cell meanwhile, aborts and the target frees the reservation again. A cancel goes
+ * to the target and back the same way. Every notification of a hand-off comes from the source, so
+ * a figure sees waitingForCell, moved and cancelMoved in the same order as on one board.
+ */
+namespace board {
+
+struct Partition
+{
+    std::uint8_t mIndex;
+    std::uint8_t mCount;
+    std::uint8_t mSizeBoard;
+
+    std::uint8_t firstRow(std::uint8_t index) const noexcept
+    {
+        return static_cast<std::uint8_t>(index * mSizeBoard / mCount);
+    }
+
+    // the partition of a cell on the board
+    std::uint8_t owner(const Coordinate &cell) const noexcept
+    {
+        return static_cast<std::uint8_t>(((cell.first + 1) * mCount - 1) / mSizeBoard);
+    }
+
+    bool owns(const Coordinate &cell) const noexcept
+    {
+        return mCount == 1 || owner(cell) == mIndex;
+    }
+};
+
+struct HandOff
+{
+    enum class Type : std::uint8_t {
+        prepare,   // source -> target
+        waiting,   // target -> source: the figure is queued for the cell
+        granted,   // target -> source: the cell is reserved for the figure
+        abort,     // source -> target: the figure left its cell, free the reservation
+        cancel,    // source -> target: take the waiter out
+        cancelled  // target -> source: mFound tells whether it was still waiting
+    };
+
+    std::uint32_t mId;
+    Type mType;
+    chessman::ChessmanType mPiece;
+    bool mFound;
+    Coordinate mFrom;   // on the source
+    Coordinate mTo;     // on the target
+
+    // prepare, abort and cancel go to the partition of mTo, the answers to the one of mFrom
+    bool toTarget() const noexcept
+    {
+        return mType == Type::prepare || mType == Type::abort || mType == Type::cancel;
+    }
+};
+
+class IHandOffPeer
+{
+public:
+    virtual ~IHandOffPeer() = default;
+    // called on the board thread; delivers the message to ChessBoardImpl::handOff of its partition
+    virtual void handOff(const HandOff &message) noexcept = 0;
+};
+
+// the sockets of the partitions of one board: "<path>.0" .. "<path>.<count - 1>"
+inline std::vector<std::string> partitionPaths(const std::string &path, std::uint8_t count)
+{
+    std::vector<std::string> paths;
+    for (std::uint8_t index = 0; index < count; ++index)
+    {
+        paths.push_back(path + "." + std::to_string(index));
+    }
+    return paths;
+}
+
+} // board
@@ -0,0 +1,117 @@
+#include <atomic>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include "GameRules.h"
+#include "IChessMan.h"
+#include "PartitionedChessBoard.h"
+
+using namespace board;
+
+// unique on the host: the process id and a counter of the clients of this process
+static std::uint32_t nextClientToken()
+{
+    static std::atomic<std::uint32_t> clients{0};
+    auto client = clients.fetch_add(1, std::memory_order_relaxed) & 0x3FFu;
+    return static_cast<std::uint32_t>(::getpid()) << 10u | client;
+}
+
+PartitionedChessBoard::PartitionedChessBoard(const std::vector<std::string> &paths)
+    : IChessBoard()
+    , mPartitions()
+    , mLayout{0, 0, 0}
+{
+    if (paths.empty() || paths.size() > static_cast<std::size_t>(GameRules::sMaxSizeBoard))
+    {
+        throw std::invalid_argument("PartitionedChessBoard: 1.." + std::to_string(GameRules::sMaxSizeBoard)
+                                    + " partitions expected, got " + std::to_string(paths.size()));
+    }
+    auto client = nextClientToken();
+    for (auto &path: paths)
+    {
+        mPartitions.push_back(std::make_unique<RemoteChessBoard>(path, wire::Subscription::ownFigures, client));
+        if (mPartitions.back()->sizeBoard() != mPartitions.front()->sizeBoard())
+        {
+            throw std::invalid_argument("PartitionedChessBoard: " + path + " serves another board size");
+        }
+    }
+    mLayout = {0, static_cast<std::uint8_t>(paths.size()), mPartitions.front()->sizeBoard()};
+    if (mLayout.mCount > mLayout.mSizeBoard)
+    {
+        throw std::invalid_argument("PartitionedChessBoard: more partitions than rows");
+    }
+}
+
+/* ************************************************************
+ * IMPL board::IChessBoard
+ * ************************************************************/
+void PartitionedChessBoard::addNotifier(std::shared_ptr<INotifier> notifier)
+{
+    for (auto &partition: mPartitions)
+    {
+        partition->addNotifier(notifier);
+    }
+}
+
+void PartitionedChessBoard::removeNotifier(std::shared_ptr<INotifier> notifier)
+{
+    for (auto &partition: mPartitions)
+    {
+        partition->removeNotifier(notifier);
+    }
+}
+
+void PartitionedChessBoard::placeFigure(const chessman::IChessMan &figure, const Coordinate &to)
+{
+    at(to).placeFigure(figure, to);
+}
+
+void PartitionedChessBoard::moveFigure(const chessman::IChessMan &figure, const Coordinate &to)
+{
+    at(figure.getCurrentCoordinate()).moveFigure(figure, to);
+}
+
+void PartitionedChessBoard::cancelMoveFigure(const chessman::IChessMan &figure, const Coordinate &to)
+{
+    at(figure.getCurrentCoordinate()).cancelMoveFigure(figure, to);
+}
+
+void PartitionedChessBoard::removeFigure(const chessman::IChessMan &figure)
+{
+    at(figure.getCurrentCoordinate()).removeFigure(figure);
+}
+
+std::uint8_t PartitionedChessBoard::sizeBoard() const noexcept
+{
+    return mLayout.mSizeBoard;
+}
+
+void PartitionedChessBoard::legalDestinations(const chessman::IChessMan &figure,
+                                              std::vector<Coordinate> &destinations) const
+{
+    at(figure.getCurrentCoordinate()).legalDestinations(figure, destinations);
+}
+
+bool PartitionedChessBoard::sampleDestination(const chessman::IChessMan &figure, std::uint32_t random,
+                                              Coordinate &to) const
+{
+    return at(figure.getCurrentCoordinate()).sampleDestination(figure, random, to);
+}
+
+const Partition &PartitionedChessBoard::layout() const noexcept
+{
+    return mLayout;
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+RemoteChessBoard &PartitionedChessBoard::at(const Coordinate &cell) const
+{
+    if (!CellIndex::fromCoordinate(cell, mLayout.mSizeBoard).valid())
+    {
+        return *mPartitions.front();
+    }
+    return *mPartitions[mLayout.owner(cell)];
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "IChessBoard.h"
+#include "Partition.h"
+#include "RemoteChessBoard.h"
+
+/*
+ * Client of a board partitioned by rows among BoardServers, see Partition.h: one RemoteChessBoard
+ * per partition, all with the same client token, so that the partition that takes a figure over
+ * knows where its events go. A placement goes to the partition of its cell, the other commands
+ * and the queries to the partition of the figure's current cell. The notifiers are called from
+ * the reader threads of all partitions.
+ *
+ * The commands of a figure may be pipelined while it stays in one partition; after a move to
+ * another partition the next command must wait for moved, the target holds the figure only once
+ * the source committed. The queries see the cells of the other partitions as free.
+ */
+class PartitionedChessBoard : public board::IChessBoard
+{
+public:
+    // connects to every partition, `paths` in the order of the partitions; throws std::system_error
+    // when one cannot be reached and std::invalid_argument when they do not make up one board
+    explicit PartitionedChessBoard(const std::vector<std::string> &paths);
+
+    void addNotifier(std::shared_ptr<board::INotifier> notifier) override;
+    void removeNotifier(std::shared_ptr<board::INotifier> notifier) override;
+
+    void placeFigure(const chessman::IChessMan &figure, const board::Coordinate &to) override;
+    void moveFigure(const chessman::IChessMan &figure, const board::Coordinate &to) override;
+    void cancelMoveFigure(const chessman::IChessMan &figure, const board::Coordinate &to) override;
+    void removeFigure(const chessman::IChessMan &figure) override;
+    std::uint8_t sizeBoard() const noexcept override;
+    void legalDestinations(const chessman::IChessMan &figure, std::vector<board::Coordinate> &destinations) const override;
+    bool sampleDestination(const chessman::IChessMan &figure, std::uint32_t random, board::Coordinate &to) const override;
+
+    const board::Partition &layout() const noexcept;
+
+private:
+    // the partition of a cell, the first one for a cell off the board, which it rejects
+    RemoteChessBoard &at(const board::Coordinate &cell) const;
+
+    std::vector<std::unique_ptr<RemoteChessBoard>> mPartitions;
+    board::Partition mLayout; // mIndex unused
+};
@@ -0,0 +1,357 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "IChessMan.h"
+#include "RemoteChessBoard.h"
+#include "Tracer.h"
+
+using namespace board;
+
+// set while the reader thread of a board runs its notifiers
+static thread_local const RemoteChessBoard *tDispatching = nullptr;
+
+struct RemoteChessBoard::Pending
+{
+    bool mDone;
+    bool mLost;
+    wire::Reply mReply;
+    std::vector<Coordinate> *mDestinations;
+};
+
+static void toWire(const Coordinate &coordinate, std::int8_t (&wire)[2])
+{
+    wire[0] = coordinate.first;
+    wire[1] = coordinate.second;
+}
+
+static Coordinate fromWire(const std::int8_t (&wire)[2])
+{
+    return {wire[0], wire[1]};
+}
+
+static bool readFully(int fd, void *data, std::size_t size)
+{
+    auto bytes = static_cast<char *>(data);
+    while (size)
+    {
+        auto received = ::recv(fd, bytes, size, 0);
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            return false;
+        }
+        bytes += received;
+        size -= static_cast<std::size_t>(received);
+    }
+    return true;
+}
+
+RemoteChessBoard::RemoteChessBoard(const std::string &path, wire::Subscription subscription, std::uint32_t client)
+    : TreadBase("RemoteBoard")
+    , mFd(-1)
+    , mSizeBoard(0)
+    , mConnected(false)
+    , mMutexWrite()
+    , mNextRequest(1)
+    , mMutexPending()
+    , mAnswered()
+    , mPending()
+    , mMutexNotifier()
+    , mListNotifiers()
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        throw std::invalid_argument("RemoteChessBoard: socket path must have 1.."
+                                    + std::to_string(sizeof(address.sun_path) - 1) + " characters");
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    mFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (mFd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "socket " + path);
+    }
+    wire::Request hello{};
+    hello.mOp = wire::Op::hello;
+    hello.mArgument = static_cast<std::uint32_t>(subscription);
+    hello.mFigureId = client;
+    wire::Reply reply{};
+    if (::connect(mFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0
+        || ::send(mFd, &hello, sizeof(hello), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(hello))
+        || !readFully(mFd, &reply, sizeof(reply)))
+    {
+        auto error = errno ? errno : ECONNRESET;
+        ::close(mFd);
+        throw std::system_error(error, std::generic_category(), "connect " + path);
+    }
+    mSizeBoard = static_cast<std::uint8_t>(reply.mValue);
+    mConnected = true;
+    TreadBase::start();
+}
+
+RemoteChessBoard::~RemoteChessBoard()
+{
+    ::shutdown(mFd, SHUT_RDWR);
+    TreadBase::join();
+    ::close(mFd);
+}
+
+/* ************************************************************
+ * IMPL board::IChessBoard
+ * ************************************************************/
+void RemoteChessBoard::addNotifier(std::shared_ptr<INotifier> notifier)
+{
+    std::lock_guard lock(mMutexNotifier);
+    mListNotifiers.push_back(std::move(notifier));
+}
+
+void RemoteChessBoard::removeNotifier(std::shared_ptr<INotifier> notifier)
+{
+    std::lock_guard lock(mMutexNotifier);
+    mListNotifiers.erase(std::remove(mListNotifiers.begin(), mListNotifiers.end(), notifier), mListNotifiers.end());
+}
+
+void RemoteChessBoard::placeFigure(const chessman::IChessMan &figure, const Coordinate &to)
+{
+    command(wire::Op::place, figure, to);
+}
+
+void RemoteChessBoard::moveFigure(const chessman::IChessMan &figure, const Coordinate &to)
+{
+    command(wire::Op::move, figure, to);
+}
+
+void RemoteChessBoard::cancelMoveFigure(const chessman::IChessMan &figure, const Coordinate &to)
+{
+    command(wire::Op::cancelMove, figure, to);
+}
+
+void RemoteChessBoard::removeFigure(const chessman::IChessMan &figure)
+{
+    command(wire::Op::remove, figure, invalidCoordinate);
+}
+
+std::uint8_t RemoteChessBoard::sizeBoard() const noexcept
+{
+    return mSizeBoard;
+}
+
+void RemoteChessBoard::legalDestinations(const chessman::IChessMan &figure, std::vector<Coordinate> &destinations) const
+{
+    wire::Request request{};
+    request.mOp = wire::Op::legalDestinations;
+    request.mFigureId = figure.getID();
+    request.mPiece = static_cast<std::uint8_t>(figure.getType());
+    toWire(figure.getCurrentCoordinate(), request.mFrom);
+    wire::Reply reply{};
+    destinations.clear();
+    query(request, reply, &destinations);
+}
+
+bool RemoteChessBoard::sampleDestination(const chessman::IChessMan &figure, std::uint32_t random, Coordinate &to) const
+{
+    wire::Request request{};
+    request.mOp = wire::Op::sampleDestination;
+    request.mFigureId = figure.getID();
+    request.mPiece = static_cast<std::uint8_t>(figure.getType());
+    request.mArgument = random;
+    toWire(figure.getCurrentCoordinate(), request.mFrom);
+    wire::Reply reply{};
+    if (!query(request, reply, nullptr) || !reply.mValue)
+    {
+        return false;
+    }
+    to = fromWire(reply.mTo);
+    return true;
+}
+
+bool RemoteChessBoard::connected() const noexcept
+{
+    return mConnected.load(std::memory_order_relaxed);
+}
+
+/* ************************************************************
+ * IMPL TreadBase
+ * ************************************************************/
+void RemoteChessBoard::loop()
+{
+    std::vector<char> buffer(64u << 10u);
+    std::size_t used = 0;
+    std::vector<BoardEvent> events;
+    while (true)
+    {
+        auto received = ::recv(mFd, buffer.data() + used, buffer.size() - used, 0);
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            break;
+        }
+        used += static_cast<std::size_t>(received);
+        std::size_t offset = 0;
+        while (used - offset >= sizeof(wire::Reply))
+        {
+            wire::Reply reply;
+            std::memcpy(&reply, buffer.data() + offset, sizeof(reply));
+            if (used - offset < sizeof(reply) + reply.mLength)
+            {
+                if (buffer.size() < sizeof(reply) + reply.mLength)
+                {
+                    buffer.resize(sizeof(reply) + reply.mLength);
+                }
+                break;
+            }
+            auto payload = buffer.data() + offset + sizeof(reply);
+            offset += sizeof(reply) + reply.mLength;
+            if (reply.mKind == wire::Kind::event)
+            {
+                events.push_back({reply.mFigureId, static_cast<BoardEvent::Type>(reply.mType),
+                                  static_cast<ReasonReject>(reply.mReason), fromWire(reply.mFrom), fromWire(reply.mTo)});
+                continue;
+            }
+            std::lock_guard lock(mMutexPending);
+            if (auto it = mPending.find(reply.mRequestId); it != mPending.end())
+            {
+                auto &pending = *it->second;
+                pending.mReply = reply;
+                if (pending.mDestinations)
+                {
+                    for (std::uint32_t i = 0; i + 1 < reply.mLength; i += 2)
+                    {
+                        pending.mDestinations->emplace_back(static_cast<std::int8_t>(payload[i]),
+                                                            static_cast<std::int8_t>(payload[i + 1]));
+                    }
+                }
+                pending.mDone = true;
+                mPending.erase(it);
+                mAnswered.notify_all();
+            }
+        }
+        std::memmove(buffer.data(), buffer.data() + offset, used - offset);
+        used -= offset;
+        if (!events.empty())
+        {
+            dispatch(events);
+            events.clear();
+        }
+    }
+    disconnected();
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+void RemoteChessBoard::command(wire::Op op, const chessman::IChessMan &figure, const Coordinate &to)
+{
+    wire::Request request{};
+    request.mOp = op;
+    request.mRequestId = mNextRequest.fetch_add(1, std::memory_order_relaxed);
+    request.mFigureId = figure.getID();
+    request.mPiece = static_cast<std::uint8_t>(figure.getType());
+    toWire(figure.getCurrentCoordinate(), request.mFrom);
+    toWire(to, request.mTo);
+    if (!send(request))
+    {   // the answer of a stopped board
+        dispatch({{figure.getID(), BoardEvent::Type::reject, ReasonReject::boardStopped, invalidCoordinate,
+                   invalidCoordinate}});
+    }
+}
+
+bool RemoteChessBoard::send(const wire::Request &request) const
+{
+    std::lock_guard lock(mMutexWrite);
+    if (!mConnected.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+    auto bytes = reinterpret_cast<const char *>(&request);
+    std::size_t sent = 0;
+    while (sent < sizeof(request))
+    {
+        auto result = ::send(mFd, bytes + sent, sizeof(request) - sent, MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            return false;
+        }
+        sent += static_cast<std::size_t>(result);
+    }
+    return true;
+}
+
+bool RemoteChessBoard::query(wire::Request &request, wire::Reply &reply, std::vector<Coordinate> *destinations) const
+{
+    if (tDispatching == this)
+    {
+        throw std::logic_error("RemoteChessBoard: a query from a notification handler would wait for itself");
+    }
+    Pending pending{false, false, {}, destinations};
+    request.mRequestId = mNextRequest.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard lock(mMutexPending);
+        if (!mConnected.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+        mPending.emplace(request.mRequestId, &pending);
+    }
+    if (!send(request))
+    {
+        std::lock_guard lock(mMutexPending);
+        mPending.erase(request.mRequestId);
+        return false;
+    }
+    std::unique_lock lock(mMutexPending);
+    mAnswered.wait(lock, [&pending]() {
+        return pending.mDone;
+    });
+    reply = pending.mReply;
+    return !pending.mLost;
+}
+
+void RemoteChessBoard::dispatch(const std::vector<BoardEvent> &events)
+{
+    Tracer::Scope scope("RemoteChessBoard::dispatch");
+    auto previous = tDispatching;
+    tDispatching = this;
+    {
+        std::lock_guard lock(mMutexNotifier);
+        for (auto &notifier: mListNotifiers)
+        {
+            notifier->onEvents(events.data(), events.size());
+        }
+    }
+    tDispatching = previous;
+}
+
+void RemoteChessBoard::disconnected()
+{
+    {
+        std::lock_guard lock(mMutexWrite);
+        mConnected.store(false, std::memory_order_relaxed);
+    }
+    std::lock_guard lock(mMutexPending);
+    for (auto &[id, pending]: mPending)
+    {
+        pending->mDone = true;
+        pending->mLost = true;
+    }
+    mPending.clear();
+    mAnswered.notify_all();
+}
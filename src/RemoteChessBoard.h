@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "BoardProtocol.h"
+#include "IChessBoard.h"
+#include "TreadBase.h"
+
+/*
+ * Client side of BoardServer: a board::IChessBoard for participants in another process. Commands
+ * are written to the socket at once and pipelined, the answers arrive as events on a reader
+ * thread, which hands every received chunk to the notifiers in one onEvents call. The queries
+ * block until their reply; they must not be made from a notification handler, which runs on the
+ * reader thread, and throw std::logic_error there. Once the connection is lost, commands are
+ * answered locally with ReasonReject::boardStopped and queries find no cells.
+ */
+class RemoteChessBoard
+        : public board::IChessBoard
+        , public TreadBase
+{
+public:
+    // connects and says hello; throws std::system_error when the server cannot be reached.
+    // The connections of one client to the partitions of a board share a non-zero `client` token
+    explicit RemoteChessBoard(const std::string &path,
+                              wire::Subscription subscription = wire::Subscription::ownFigures,
+                              std::uint32_t client = 0);
+    ~RemoteChessBoard() override;
+
+    void addNotifier(std::shared_ptr<board::INotifier> notifier) override;
+    void removeNotifier(std::shared_ptr<board::INotifier> notifier) override;
+
+    void placeFigure(const chessman::IChessMan &figure, const board::Coordinate &to) override;
+    void moveFigure(const chessman::IChessMan &figure, const board::Coordinate &to) override;
+    void cancelMoveFigure(const chessman::IChessMan &figure, const board::Coordinate &to) override;
+    void removeFigure(const chessman::IChessMan &figure) override;
+    std::uint8_t sizeBoard() const noexcept override;
+    void legalDestinations(const chessman::IChessMan &figure, std::vector<board::Coordinate> &destinations) const override;
+    bool sampleDestination(const chessman::IChessMan &figure, std::uint32_t random, board::Coordinate &to) const override;
+
+    bool connected() const noexcept;
+
+protected:
+    void loop() override;
+
+private:
+    struct Pending;
+
+    void command(wire::Op op, const chessman::IChessMan &figure, const board::Coordinate &to);
+    bool send(const wire::Request &request) const;
+    // false when the connection is lost
+    bool query(wire::Request &request, wire::Reply &reply, std::vector<board::Coordinate> *destinations) const;
+    void dispatch(const std::vector<board::BoardEvent> &events);
+    void disconnected();
+
+    int mFd;
+    std::uint8_t mSizeBoard;
+    std::atomic<bool> mConnected;
+
+    mutable std::mutex mMutexWrite;
+    mutable std::atomic<std::uint32_t> mNextRequest;
+
+    mutable std::mutex mMutexPending;
+    mutable std::condition_variable mAnswered;
+    mutable std::map<std::uint32_t, Pending *> mPending;
+
+    mutable std::recursive_mutex mMutexNotifier;
+    std::vector<std::shared_ptr<board::INotifier>> mListNotifiers;
+};
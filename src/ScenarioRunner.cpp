@@ -0,0 +1,699 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include <csignal>
+#include <pthread.h>
+#include <time.h>
+
+#include "BoardServer.h"
+#include "ChessBoardImpl.h"
+#include "GameServer.h"
+#include "MoveTable.h"
+#include "ScenarioRunner.h"
+#include "StepStrategy.h"
+
+static std::chrono::nanoseconds cpuTime()
+{
+    timespec now{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec);
+}
+
+static std::size_t parseNumber(const std::string &key, const std::string &value)
+{
+    std::size_t position = 0;
+    unsigned long long number = 0;
+    try {
+        number = std::stoull(value, &position);
+    } catch (const std::exception &) {
+        position = 0;
+    }
+    if (value.empty() || position != value.size() || value.front() == '-')
+    {
+        throw std::invalid_argument("Option " + key + " expects a non-negative number, got '" + value + "'");
+    }
+    return static_cast<std::size_t>(number);
+}
+
+static std::chrono::milliseconds parseDelay(const std::string &key, const std::string &value)
+{
+    return std::chrono::milliseconds(parseNumber(key, value));
+}
+
+static std::vector<std::size_t> parseCpus(const std::string &key, const std::string &value)
+{
+    std::vector<std::size_t> cpus;
+    std::istringstream list(value);
+    for (std::string cpu; std::getline(list, cpu, ',');)
+    {
+        cpus.push_back(parseNumber(key, cpu));
+    }
+    if (cpus.empty())
+    {
+        throw std::invalid_argument("Option " + key + " expects a list of CPUs");
+    }
+    return cpus;
+}
+
+static chessman::ChessmanType parsePiece(const std::string &name)
+{
+    using chessman::ChessmanType;
+    static const std::pair<const char *, ChessmanType> pieces[] = {
+        {"rook", ChessmanType::rook}, {"bishop", ChessmanType::bishop}, {"queen", ChessmanType::queen},
+        {"knight", ChessmanType::knight}, {"king", ChessmanType::king}
+    };
+    for (auto &[pieceName, type]: pieces)
+    {
+        if (name == pieceName)
+        {
+            return type;
+        }
+    }
+    throw std::invalid_argument("Unknown piece '" + name + "', expected rook, bishop, queen, knight or king");
+}
+
+static std::string trim(const std::string &text)
+{
+    auto begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos)
+    {
+        return {};
+    }
+    auto end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+ScenarioRunner::ScenarioRunner(Scenario scenario)
+    : mScenario(std::move(scenario))
+{
+
+}
+
+std::vector<ScenarioResult> ScenarioRunner::run(std::ostream &report)
+{
+    std::vector<ScenarioResult> results;
+    printHeader(report, !mScenario.mRates.empty());
+    for (auto sizeBoard: mScenario.mSizeBoards)
+    {
+        for (auto participants: mScenario.mParticipants)
+        {
+            if (participants >= sizeBoard * sizeBoard)
+            {   // without a free cell nobody can ever move
+                report << std::right << std::setw(12) << participants << std::setw(7) << sizeBoard
+                       << "  skipped, needs at least one free cell" << std::endl;
+                continue;
+            }
+            auto &pieces = mScenario.mGame.mRules.mPieces;
+            if (std::any_of(pieces.begin(), pieces.end(), [sizeBoard](auto type) {
+                    return static_cast<std::int32_t>(sizeBoard) < chessman::minSizeBoard(type);
+                }))
+            {
+                report << std::right << std::setw(12) << participants << std::setw(7) << sizeBoard
+                       << "  skipped, board too small for the pieces" << std::endl;
+                continue;
+            }
+            if (mScenario.mRates.empty())
+            {
+                results.push_back(mScenario.mGames ? runHostedPoint(participants, static_cast<std::int32_t>(sizeBoard))
+                                                   : runPoint(participants, static_cast<std::int32_t>(sizeBoard)));
+                printResult(report, results.back());
+            }
+            for (auto rate: mScenario.mRates)
+            {
+                results.push_back(runOpenLoopPoint(participants, static_cast<std::int32_t>(sizeBoard), rate));
+                printResult(report, results.back());
+            }
+        }
+    }
+    return results;
+}
+
+Scenario ScenarioRunner::parse(int argc, const char *const *argv)
+{
+    Scenario scenario;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument.rfind("--", 0) != 0)
+        {   // positional argument kept for compatibility: log path
+            apply(scenario, "log", argument);
+            continue;
+        }
+        argument.erase(0, 2);
+        if (argument == "help" || argument == "no-statistic" || argument == "blocking")
+        {
+            apply(scenario, argument, {});
+            continue;
+        }
+        std::string value;
+        if (auto equal = argument.find('='); equal != std::string::npos)
+        {
+            value = argument.substr(equal + 1);
+            argument.erase(equal);
+        } else if (i + 1 < argc) {
+            value = argv[++i];
+        } else {
+            throw std::invalid_argument("Option --" + argument + " expects a value");
+        }
+        if (argument == "config")
+        {
+            std::ifstream config(value);
+            if (!config)
+            {
+                throw std::invalid_argument("Cannot open config " + value);
+            }
+            parseConfig(config, scenario);
+        } else {
+            apply(scenario, argument, value);
+        }
+    }
+    return scenario;
+}
+
+void ScenarioRunner::parseConfig(std::istream &config, Scenario &scenario)
+{
+    std::string line;
+    while (std::getline(config, line))
+    {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty())
+        {
+            continue;
+        }
+        auto separator = line.find_first_of(" \t=");
+        auto key = trim(line.substr(0, separator));
+        auto value = separator == std::string::npos ? std::string() : trim(line.substr(separator + 1));
+        if (!value.empty() && value.front() == '=')
+        {
+            value = trim(value.substr(1));
+        }
+        apply(scenario, key, value);
+    }
+}
+
+std::vector<std::size_t> ScenarioRunner::parseSweep(const std::string &value)
+{
+    std::vector<std::size_t> result;
+    std::size_t begin = 0;
+    while (begin <= value.size())
+    {
+        auto end = value.find(',', begin);
+        auto item = trim(value.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+        if (auto range = item.find(".."); range != std::string::npos)
+        {   // "a..b" doubles, "a..b:s" steps by s
+            auto first = parseNumber("sweep", item.substr(0, range));
+            auto rest = item.substr(range + 2);
+            std::size_t step = 0;
+            if (auto colon = rest.find(':'); colon != std::string::npos)
+            {
+                step = parseNumber("sweep", rest.substr(colon + 1));
+                rest.erase(colon);
+                if (!step)
+                {
+                    throw std::invalid_argument("Sweep step must be positive in '" + item + "'");
+                }
+            }
+            auto last = parseNumber("sweep", rest);
+            if (!first || first > last)
+            {
+                throw std::invalid_argument("Sweep range must be 0 < first <= last in '" + item + "'");
+            }
+            for (auto point = first; point <= last; point = step ? point + step : point * 2)
+            {
+                result.push_back(point);
+            }
+        } else {
+            result.push_back(parseNumber("sweep", item));
+        }
+        if (end == std::string::npos)
+        {
+            break;
+        }
+        begin = end + 1;
+    }
+    return result;
+}
+
+void ScenarioRunner::serve(std::ostream &report)
+{
+    // the board and server threads inherit the mask, the signals are taken by sigwait only
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    auto &settings = mScenario.mGame;
+    auto sizeBoard = static_cast<std::uint8_t>(mScenario.mSizeBoards.front());
+    auto board = std::make_shared<ChessBoardImpl>(sizeBoard, settings.mRules.mBlockingSliders,
+                                                   settings.mBoardCapacity, settings.mBoardPolicy);
+    board->setAttributes(settings.mBoardThread);
+    board->setDrainPolicy(settings.mBoardDrain, settings.mBoardUrgentWeight);
+    board->startGame();
+    std::shared_ptr<EventBus> eventBus;
+    if (!settings.mEventBusName.empty())
+    {
+        eventBus = std::make_shared<EventBus>(settings.mEventBusName, settings.mEventBusCapacity);
+        board->addNotifier(eventBus);
+    }
+    auto partitions = static_cast<std::uint8_t>(mScenario.mPartitions);
+    auto server = partitions > 1
+                  ? std::make_shared<BoardServer>(board::partitionPaths(mScenario.mServe, partitions),
+                                                  static_cast<std::uint8_t>(mScenario.mPartition), board)
+                  : std::make_shared<BoardServer>(mScenario.mServe, board);
+    server->startGame();
+    report << "serving a board of " << static_cast<int>(sizeBoard) << " on " << server->path() << std::endl;
+
+    int signal = 0;
+    sigwait(&signals, &signal);
+    server->stopGame();
+    board->stopGame();
+    if (settings.mDumpStatistic)
+    {
+        board->statistic().dump(report);
+    }
+}
+
+void ScenarioRunner::usage(std::ostream &os, const char *program)
+{
+    os << "Usage: " << program << " [log-path] [options]\n"
+       << "  --participants SWEEP   participants per game, default 4\n"
+       << "  --board SWEEP          board size, " << GameRules::sMinSizeBoard << ".." << GameRules::sMaxSizeBoard
+                                    << ", default 8\n"
+       << "  --steps N              moves made by every participant, default 30\n"
+       << "  --delay-step MIN:MAX   ms between steps, default 200:300\n"
+       << "  --delay-wait MS        ms to wait for an occupied cell, default 5000\n"
+       << "  --delay-confirm MS     ms to wait for the board answer, default 100\n"
+       << "  --log PATH|none        memory-mapped log segments or no log, default stdout\n"
+       << "  --event-bus NAME[:N]   publish board events to shared memory /dev/shm/NAME, a ring of N slots\n"
+       << "                         (default " << EventBus::sDefaultCapacity << "), one segment per game\n"
+       << "  --trace PATH           Chrome trace-event JSON, also CHESSROOK_TRACE\n"
+       << "  --no-statistic         do not print the board latency table\n"
+       << "  --board-cpus LIST      pin the board thread to these CPUs, e.g. 3 or 2,3\n"
+       << "  --board-priority N     run the board thread SCHED_FIFO at priority N, needs CAP_SYS_NICE\n"
+       << "  --logger-cpus LIST     pin the Logger thread to these CPUs\n"
+       << "  --board-capacity N     place and move commands queued on the board at most, default unbounded\n"
+       << "  --board-overload KIND  full queue: block (default) the sender or reject the command as overloaded\n"
+       << "  --board-drain KIND     fifo (default), strict or weighted[:N]: cancels and removes before, or N per,\n"
+       << "                         place and move\n"
+       << "  --participant-stack KB stack size of every participant thread, default the system's\n"
+       << "  --rate SWEEP           open loop: participants drive figures at SWEEP moves per second\n"
+       << "  --arrival KIND         open-loop arrivals, constant (default) or poisson\n"
+       << "  --duration MS          open-loop schedule per point, default 1000\n"
+       << "  --hotspot KIND         uniform (default), cell[:x,y], row[:x] or zipf[:s], then @hot share;\n"
+       << "                         free picks among the free cells the figure can reach\n"
+       << "  --pieces LIST          piece types handed out in turn: rook (default), bishop, queen, knight, king\n"
+       << "  --blocking             rooks, bishops and queens may not pass over occupied cells\n"
+       << "  --rng ENGINE           mt19937, xoshiro (default) or pcg\n"
+       << "  --games N              host N concurrent games per point on a shared executor, no log\n"
+       << "  --pool THREADS         executor threads for --games, default one per core\n"
+       << "  --serve PATH           serve a board of the first --board size to RemoteChessBoard clients on\n"
+       << "                         the Unix-domain socket PATH until SIGINT or SIGTERM\n"
+       << "  --partition K/N        with --serve: serve the rows of partition K of N on PATH.K and hand\n"
+       << "                         figures over to the partitions on PATH.0 .. PATH.N-1\n"
+       << "  --config FILE          read the same keys from FILE, one 'key value' per line\n"
+       << "SWEEP is a list of values and ranges: 1..4096 doubles, 10..100:10 steps by 10\n";
+}
+
+void ScenarioRunner::printHeader(std::ostream &os, bool openLoop)
+{
+    os << std::right << std::setw(12) << "participants" << std::setw(7) << "board";
+    if (openLoop)
+    {
+        os << std::setw(9) << "rate" << std::setw(10) << "scheduled";
+    } else {
+        os << std::setw(10) << "requests";
+    }
+    os << std::setw(10) << "moves" << std::setw(12) << "moves/s" << std::setw(8) << "wait" << std::setw(8) << "reject";
+    if (openLoop)
+    {
+        os << std::setw(9) << "backlog" << std::setw(10) << "p50, ms" << std::setw(10) << "p99, ms"
+           << std::setw(10) << "p999, ms" << std::setw(10) << "max, ms" << std::setw(12) << "svc p99, ms";
+    }
+    os << std::setw(7) << "depth" << std::setw(9) << "depth99" << std::setw(13) << "wait p99, ms"
+       << std::setw(8) << "cancel" << std::setw(7) << "util" << std::setw(10) << "wall, s" << std::setw(10) << "cpu, s"
+       << std::endl;
+}
+
+void ScenarioRunner::printResult(std::ostream &os, const ScenarioResult &result)
+{
+    auto flags = os.flags();
+    auto precision = os.precision();
+    auto seconds = [](std::chrono::nanoseconds duration) {
+        return std::chrono::duration<double>(duration).count();
+    };
+    auto ms = [](std::uint64_t ns) {
+        return static_cast<double>(ns) / 1e6;
+    };
+    os << std::right << std::setw(12) << result.mParticipants << std::setw(7) << result.mSizeBoard;
+    if (result.mRate)
+    {
+        os << std::setw(9) << result.mRate << std::setw(10) << result.mScheduled;
+    } else {
+        os << std::setw(10) << result.mRequests;
+    }
+    os << std::setw(10) << result.mMoves
+       << std::fixed << std::setprecision(1) << std::setw(12) << result.movesPerSecond()
+       << std::setprecision(3) << std::setw(8) << result.waitRatio() << std::setw(8) << result.rejectRatio();
+    if (result.mRate)
+    {
+        os << std::setw(9) << result.mMaxBacklog
+           << std::setw(10) << ms(result.mLatency.mP50) << std::setw(10) << ms(result.mLatency.mP99)
+           << std::setw(10) << ms(result.mLatency.mP999) << std::setw(10) << ms(result.mLatency.mMax)
+           << std::setw(12) << ms(result.mServiceLatency.mP99);
+    }
+    os << std::setw(7) << result.mWaitDepth.mMax << std::setw(9) << result.mWaitDepth.mP99
+       << std::setw(13) << ms(result.mWaitTime.mP99) << std::setw(8) << result.cancelRatio()
+       << std::setprecision(2) << std::setw(7) << result.boardUtilisation()
+       << std::setprecision(3) << std::setw(10) << seconds(result.mWallTime) << std::setw(10) << seconds(result.mCpuTime)
+       << std::endl;
+    os.flags(flags);
+    os.precision(precision);
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+void ScenarioRunner::apply(Scenario &scenario, const std::string &key, const std::string &value)
+{
+    auto &rules = scenario.mGame.mRules;
+    if (key == "participants")
+    {
+        scenario.mParticipants = parseSweep(value);
+        for (auto participants: scenario.mParticipants)
+        {
+            if (!participants)
+            {
+                throw std::invalid_argument("A game needs at least one participant");
+            }
+        }
+    } else if (key == "board") {
+        scenario.mSizeBoards = parseSweep(value);
+        for (auto sizeBoard: scenario.mSizeBoards)
+        {
+            if (sizeBoard < static_cast<std::size_t>(GameRules::sMinSizeBoard)
+                || sizeBoard > static_cast<std::size_t>(GameRules::sMaxSizeBoard))
+            {
+                throw std::invalid_argument("Board size " + std::to_string(sizeBoard) + " is out of range");
+            }
+        }
+    } else if (key == "steps") {
+        scenario.mSteps = parseNumber(key, value);
+        if (!scenario.mSteps)
+        {
+            throw std::invalid_argument("Option steps must be positive");
+        }
+    } else if (key == "delay-step") {
+        auto colon = value.find(':');
+        rules.mDelayNextStepMin = parseDelay(key, value.substr(0, colon));
+        rules.mDelayNextStepMax = colon == std::string::npos ? rules.mDelayNextStepMin
+                                                             : parseDelay(key, value.substr(colon + 1));
+        if (rules.mDelayNextStepMin > rules.mDelayNextStepMax)
+        {
+            throw std::invalid_argument("Option delay-step expects MIN:MAX with MIN <= MAX");
+        }
+    } else if (key == "delay-wait") {
+        rules.mDelayWaitForCell = parseDelay(key, value);
+    } else if (key == "delay-confirm") {
+        rules.mDelayConfirm = parseDelay(key, value);
+    } else if (key == "log") {
+        scenario.mGame.mLogEnabled = value != "none";
+        scenario.mGame.mLogPath = value == "none" || value == "-" ? std::string() : value;
+    } else if (key == "event-bus") {
+        auto colon = value.find(':');
+        scenario.mGame.mEventBusName = value.substr(0, colon);
+        if (colon != std::string::npos)
+        {
+            auto capacity = parseNumber(key, value.substr(colon + 1));
+            if (!capacity || (capacity & (capacity - 1)))
+            {
+                throw std::invalid_argument("Option event-bus expects a power of two of slots, got '" + value + "'");
+            }
+            scenario.mGame.mEventBusCapacity = capacity;
+        }
+        if (scenario.mGame.mEventBusName.empty())
+        {
+            throw std::invalid_argument("Option event-bus expects a name");
+        }
+    } else if (key == "trace") {
+        scenario.mGame.mTracePath = value;
+    } else if (key == "no-statistic") {
+        scenario.mGame.mDumpStatistic = false;
+    } else if (key == "board-cpus") {
+        scenario.mGame.mBoardThread.mCpus = parseCpus(key, value);
+    } else if (key == "board-priority") {
+        scenario.mGame.mBoardThread.mPolicy = SCHED_FIFO;
+        scenario.mGame.mBoardThread.mPriority = static_cast<int>(parseNumber(key, value));
+    } else if (key == "logger-cpus") {
+        scenario.mGame.mLoggerThread.mCpus = parseCpus(key, value);
+    } else if (key == "board-capacity") {
+        scenario.mGame.mBoardCapacity = parseNumber(key, value);
+    } else if (key == "board-overload") {
+        if (value == "block")
+        {
+            scenario.mGame.mBoardPolicy = ChessBoardImpl::OverloadPolicy::block;
+        } else if (value == "reject") {
+            scenario.mGame.mBoardPolicy = ChessBoardImpl::OverloadPolicy::reject;
+        } else {
+            throw std::invalid_argument("Option board-overload expects block or reject, got '" + value + "'");
+        }
+    } else if (key == "board-drain") {
+        auto colon = value.find(':');
+        auto kind = value.substr(0, colon);
+        if (kind == "fifo")
+        {
+            scenario.mGame.mBoardDrain = ChessBoardImpl::DrainPolicy::fifo;
+        } else if (kind == "strict") {
+            scenario.mGame.mBoardDrain = ChessBoardImpl::DrainPolicy::strict;
+        } else if (kind == "weighted") {
+            scenario.mGame.mBoardDrain = ChessBoardImpl::DrainPolicy::weighted;
+        } else {
+            throw std::invalid_argument("Option board-drain expects fifo, strict or weighted[:N], got '" + value + "'");
+        }
+        if (colon != std::string::npos)
+        {
+            scenario.mGame.mBoardUrgentWeight = parseNumber(key, value.substr(colon + 1));
+            if (!scenario.mGame.mBoardUrgentWeight)
+            {
+                throw std::invalid_argument("Option board-drain expects a positive weight");
+            }
+        }
+    } else if (key == "participant-stack") {
+        scenario.mGame.mParticipantThread.mStackSize = parseNumber(key, value) << 10u;
+    } else if (key == "blocking") {
+        rules.mBlockingSliders = true;
+    } else if (key == "rate") {
+        scenario.mRates = parseSweep(value);
+        if (std::find(scenario.mRates.begin(), scenario.mRates.end(), 0u) != scenario.mRates.end())
+        {
+            throw std::invalid_argument("Option rate must be positive");
+        }
+    } else if (key == "arrival") {
+        if (value == "constant")
+        {
+            scenario.mArrival = ArrivalProcess::constant;
+        } else if (value == "poisson") {
+            scenario.mArrival = ArrivalProcess::poisson;
+        } else {
+            throw std::invalid_argument("Option arrival expects constant or poisson, got '" + value + "'");
+        }
+    } else if (key == "duration") {
+        scenario.mDuration = parseDelay(key, value);
+    } else if (key == "pieces") {
+        rules.mPieces.clear();
+        std::istringstream list(value);
+        for (std::string name; std::getline(list, name, ',');)
+        {
+            rules.mPieces.push_back(parsePiece(name));
+        }
+        if (rules.mPieces.empty())
+        {
+            throw std::invalid_argument("Option pieces expects a list of piece types");
+        }
+    } else if (key == "rng") {
+        if (value == "mt19937")
+        {
+            rules.mRandomEngine = RandomEngine::mt19937;
+        } else if (value == "xoshiro") {
+            rules.mRandomEngine = RandomEngine::xoshiro256;
+        } else if (value == "pcg") {
+            rules.mRandomEngine = RandomEngine::pcg32;
+        } else {
+            throw std::invalid_argument("Option rng expects mt19937, xoshiro or pcg, got '" + value + "'");
+        }
+    } else if (key == "hotspot") {
+        makeStepStrategy(value, GameRules::sMaxSizeBoard);
+        scenario.mHotspot = value;
+    } else if (key == "games") {
+        scenario.mGames = parseNumber(key, value);
+    } else if (key == "pool") {
+        scenario.mPoolThreads = parseNumber(key, value);
+    } else if (key == "serve") {
+        if (value.empty())
+        {
+            throw std::invalid_argument("Option serve expects a socket path");
+        }
+        scenario.mServe = value;
+    } else if (key == "partition") {
+        auto slash = value.find('/');
+        if (slash == std::string::npos)
+        {
+            throw std::invalid_argument("Option partition expects K/N, got '" + value + "'");
+        }
+        scenario.mPartition = parseNumber(key, value.substr(0, slash));
+        scenario.mPartitions = parseNumber(key, value.substr(slash + 1));
+        if (scenario.mPartition >= scenario.mPartitions
+            || scenario.mPartitions > static_cast<std::size_t>(GameRules::sMaxSizeBoard))
+        {
+            throw std::invalid_argument("Option partition expects K < N <= " + std::to_string(GameRules::sMaxSizeBoard)
+                                        + ", got '" + value + "'");
+        }
+    } else if (key == "help") {
+        scenario.mHelp = true;
+    } else {
+        throw std::invalid_argument("Unknown option " + key);
+    }
+}
+
+ScenarioResult ScenarioRunner::runPoint(std::size_t countParticipants, std::int32_t sizeBoard)
+{
+    auto settings = mScenario.mGame;
+    settings.mRules.mSizeBoard = sizeBoard;
+    settings.mRules.mStepStrategy = makeStepStrategy(mScenario.mHotspot, sizeBoard);
+    if (!settings.mLogPath.empty() && mScenario.mParticipants.size() * mScenario.mSizeBoards.size() > 1)
+    {   // every point gets its own segments
+        settings.mLogPath += ".p" + std::to_string(countParticipants) + ".b" + std::to_string(sizeBoard);
+    }
+
+    Game game(countParticipants, mScenario.mSteps, std::move(settings));
+    auto wallStart = std::chrono::steady_clock::now();
+    auto cpuStart = cpuTime();
+    game.startGame();
+    game.waitEnd();
+
+    ScenarioResult result{};
+    result.mWallTime = std::chrono::steady_clock::now() - wallStart;
+    result.mCpuTime = cpuTime() - cpuStart;
+    result.mParticipants = countParticipants;
+    result.mGames = 1;
+    result.mSizeBoard = sizeBoard;
+    fillFromBoard(result, game.board()->statistic());
+    return result;
+}
+
+ScenarioResult ScenarioRunner::runHostedPoint(std::size_t countParticipants, std::int32_t sizeBoard)
+{
+    GameServerSettings settings;
+    settings.mRules = mScenario.mGame.mRules;
+    settings.mRules.mSizeBoard = sizeBoard;
+    settings.mRules.mStepStrategy = makeStepStrategy(mScenario.mHotspot, sizeBoard);
+    settings.mThreads = mScenario.mPoolThreads;
+    settings.mMaxGames = mScenario.mGames;
+    settings.mMaxParticipants = mScenario.mGames * countParticipants;
+
+    ScenarioResult result{};
+    auto wallStart = std::chrono::steady_clock::now();
+    auto cpuStart = cpuTime();
+    GameServer server(std::move(settings));
+    for (std::size_t i = 0; i < mScenario.mGames; ++i)
+    {
+        server.startGame(countParticipants, mScenario.mSteps);
+    }
+    server.waitIdle();
+    result.mWallTime = std::chrono::steady_clock::now() - wallStart;
+    result.mCpuTime = cpuTime() - cpuStart;
+    result.mParticipants = countParticipants;
+    result.mGames = mScenario.mGames;
+    result.mSizeBoard = sizeBoard;
+    fillFromBoard(result, server.statistic());
+    return result;
+}
+
+ScenarioResult ScenarioRunner::runOpenLoopPoint(std::size_t countFigures, std::int32_t sizeBoard, std::size_t rate)
+{
+    auto rules = mScenario.mGame.mRules;
+    rules.mSizeBoard = sizeBoard;
+    rules.mStepStrategy = makeStepStrategy(mScenario.mHotspot, sizeBoard);
+    GameRules::configure(rules);
+
+    OpenLoopSettings settings;
+    settings.mArrival = mScenario.mArrival;
+    settings.mRate = static_cast<double>(rate);
+    settings.mFigures = countFigures;
+    settings.mDuration = mScenario.mDuration;
+
+    auto board = std::make_shared<ChessBoardImpl>(GameRules::sizeBoard(), GameRules::settings().mBlockingSliders,
+                                                  mScenario.mGame.mBoardCapacity, mScenario.mGame.mBoardPolicy);
+    board->setDrainPolicy(mScenario.mGame.mBoardDrain, mScenario.mGame.mBoardUrgentWeight);
+    board->startGame();
+    auto generator = std::make_shared<LoadGenerator>(board, settings);
+    auto cpuStart = cpuTime();
+    generator->startGame();
+    generator->waitEnd();
+    auto cpuEnd = cpuTime();
+    board->stopGame();
+
+    auto counters = generator->counters();
+    ScenarioResult result{};
+    result.mWallTime = counters.mElapsed;
+    result.mCpuTime = cpuEnd - cpuStart;
+    result.mParticipants = countFigures;
+    result.mGames = 1;
+    result.mSizeBoard = sizeBoard;
+    fillFromBoard(result, board->statistic());
+    // the board also counted placing and removing the figures, keep the scheduled moves only
+    result.mMoves = counters.mMoved;
+    result.mRate = rate;
+    result.mScheduled = counters.mScheduled;
+    result.mMaxBacklog = counters.mMaxBacklog;
+    result.mLatency = generator->latency().snapshot();
+    result.mServiceLatency = generator->serviceLatency().snapshot();
+    return result;
+}
+
+void ScenarioRunner::fillFromBoard(ScenarioResult &result, const BoardStatistic &statistic)
+{
+    for (std::size_t i = 0; i < BoardStatistic::sCountOperations; ++i)
+    {
+        result.mRequests += statistic.serviceTime(static_cast<BoardStatistic::Operation>(i)).count();
+    }
+    result.mMoves = statistic.outcomeTime(BoardStatistic::Outcome::moved).count();
+    result.mWaits = statistic.outcomeTime(BoardStatistic::Outcome::waitingForCell).count();
+    result.mRejects = statistic.outcomeTime(BoardStatistic::Outcome::reject).count();
+    result.mCancels = statistic.outcomeTime(BoardStatistic::Outcome::cancelMoved).count();
+    result.mBoardBusy = statistic.busyTime();
+    result.mWaitDepth = statistic.waitDepth().snapshot();
+    result.mWaitTime = statistic.waitGranted().snapshot();
+}
+
+/* ************************************************************
+ * IMPL ScenarioResult
+ * ************************************************************/
+double ScenarioResult::movesPerSecond() const noexcept
+{
+    auto seconds = std::chrono::duration<double>(mWallTime).count();
+    return seconds > 0 ? static_cast<double>(mMoves) / seconds : 0.0;
+}
+
+double ScenarioResult::waitRatio() const noexcept
+{
+    return mRequests ? static_cast<double>(mWaits) / static_cast<double>(mRequests) : 0.0;
+}
+
+double ScenarioResult::rejectRatio() const noexcept
+{
+    return mRequests ? static_cast<double>(mRejects) / static_cast<double>(mRequests) : 0.0;
+}
+
+double ScenarioResult::cancelRatio() const noexcept
+{
+    return mWaits ? static_cast<double>(mCancels) / static_cast<double>(mWaits) : 0.0;
+}
+
+double ScenarioResult::boardUtilisation() const noexcept
+{
+    return mWallTime.count() ? static_cast<double>(mBoardBusy.count()) / static_cast<double>(mWallTime.count()) : 0.0;
+}
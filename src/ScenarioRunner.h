@@ -0,0 +1,129 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "BoardStatistic.h"
+#include "Game.h"
+#include "LatencyHistogram.h"
+#include "LoadGenerator.h"
+
+struct Scenario
+{
+    std::vector<std::size_t> mParticipants{4};
+    std::vector<std::size_t> mSizeBoards{8};
+    std::size_t mSteps = 30;
+    // mRules.mSizeBoard is overwritten for each point of the sweep
+    GameSettings mGame;
+    bool mHelp = false;
+
+    // open loop instead of participants when not empty: the participants drive figures at these rates
+    std::vector<std::size_t> mRates;
+    // see makeStepStrategy, built for every board size of the sweep
+    std::string mHotspot = "uniform";
+    ArrivalProcess mArrival = ArrivalProcess::constant;
+    std::chrono::milliseconds mDuration = std::chrono::milliseconds(1000);
+
+    // hosted instead of Game when positive: that many concurrent games per point on a GameServer
+    std::size_t mGames = 0;
+    // executor threads of the GameServer, 0: one per core
+    std::size_t mPoolThreads = 0;
+
+    // serve one board of the first size on this Unix-domain socket instead of running the sweep
+    std::string mServe;
+    // serve only partition mPartition of mPartitions on "<mServe>.<mPartition>", see Partition.h
+    std::size_t mPartition = 0;
+    std::size_t mPartitions = 1;
+};
+
+struct ScenarioResult
+{
+    std::size_t mParticipants; // per game
+    std::size_t mGames;
+    std::int32_t mSizeBoard;
+    std::uint64_t mRequests;
+    std::uint64_t mMoves;
+    std::uint64_t mWaits;
+    std::uint64_t mRejects;
+    std::uint64_t mCancels;
+    std::chrono::nanoseconds mWallTime;
+    std::chrono::nanoseconds mCpuTime;
+    std::chrono::nanoseconds mBoardBusy;
+    LatencyHistogram::Snapshot mWaitDepth;
+    LatencyHistogram::Snapshot mWaitTime; // until the cell was granted
+
+    // open loop only, latency from the intended send time and from the actual one
+    std::size_t mRate;
+    std::uint64_t mScheduled;
+    std::size_t mMaxBacklog;
+    LatencyHistogram::Snapshot mLatency;
+    LatencyHistogram::Snapshot mServiceLatency;
+
+    double movesPerSecond() const noexcept;
+    double waitRatio() const noexcept;
+    double rejectRatio() const noexcept;
+    // cancelled waits (WaitForCellStep timeouts) per wait
+    double cancelRatio() const noexcept;
+    // board thread busy time per wall time
+    double boardUtilisation() const noexcept;
+};
+
+/*
+ * Runs Game once per point of a participants x board size sweep and reports throughput.
+ * A scenario comes from command line options or from a config file with the same keys,
+ * one "key value" (or "key = value") per line, '#' starts a comment:
+ *
+ *   participants 1..4096      # doubling range, or a list "1,2,8", or "10..100:10"
+ *   board 8,16,32
+ *   steps 100
+ *   delay-step 0:0            # min:max ms between steps
+ *   delay-wait 5000
+ *   delay-confirm 0
+ *   log none                  # stdout when omitted, memory-mapped segments for a path
+ *   event-bus chessrook:4096  # board events in shared memory for ChessRookTail and other readers
+ *   rate 1000..64000          # open loop: commands per second driven by LoadGenerator
+ *   arrival poisson           # or constant
+ *   duration 2000             # ms of open-loop schedule per point
+ *   hotspot zipf:1.2          # or uniform, free, cell:x,y, row:x
+ *   board-cpus 3              # pin the board thread, logger-cpus likewise
+ *   participant-stack 64      # KiB of stack per participant thread
+ *   board-capacity 256        # bounded board queue, board-overload block or reject when full
+ *   board-drain weighted:4    # or fifo, strict: cancels and removes overtake places and moves
+ *   games 1000                # hosted: concurrent games per point on a shared executor
+ *   pool 4                    # executor threads for games, one per core when omitted
+ *   serve /tmp/chessrook.sock # a board for RemoteChessBoard clients until SIGINT or SIGTERM
+ *   partition 1/4             # with serve: rows of partition 1 of 4 on /tmp/chessrook.sock.1
+ */
+class ScenarioRunner
+{
+public:
+    explicit ScenarioRunner(Scenario scenario);
+
+    // runs every point, printing one report row per point as soon as it is done;
+    // points with no free cell left on the board are reported as skipped
+    std::vector<ScenarioResult> run(std::ostream &report);
+    // serves a board on mServe until SIGINT or SIGTERM, then dumps its statistic when enabled
+    void serve(std::ostream &report);
+
+    // both throw std::invalid_argument on unknown keys and malformed values
+    static Scenario parse(int argc, const char *const *argv);
+    static void parseConfig(std::istream &config, Scenario &scenario);
+    static std::vector<std::size_t> parseSweep(const std::string &value);
+
+    static void usage(std::ostream &os, const char *program);
+    static void printHeader(std::ostream &os, bool openLoop = false);
+    static void printResult(std::ostream &os, const ScenarioResult &result);
+
+private:
+    static void apply(Scenario &scenario, const std::string &key, const std::string &value);
+    ScenarioResult runPoint(std::size_t countParticipants, std::int32_t sizeBoard);
+    ScenarioResult runOpenLoopPoint(std::size_t countFigures, std::int32_t sizeBoard, std::size_t rate);
+    ScenarioResult runHostedPoint(std::size_t countParticipants, std::int32_t sizeBoard);
+    static void fillFromBoard(ScenarioResult &result, const BoardStatistic &statistic);
+
+    Scenario mScenario;
+};
@@ -0,0 +1,165 @@
+#include <array>
+#include <vector>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include "SlidingAttacks.h"
+
+namespace chessman {
+
+using Direction = std::array<std::int32_t, 2>;
+
+static constexpr std::array<Direction, 4> sRookDirections{{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+static constexpr std::array<Direction, 4> sBishopDirections{{{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+
+static std::uint64_t walk(std::int32_t square, std::uint64_t occupancy, const std::array<Direction, 4> &directions)
+{
+    std::uint64_t attacks = 0;
+    for (auto &[dx, dy]: directions)
+    {
+        auto x = square / sBitboardSide + dx;
+        auto y = square % sBitboardSide + dy;
+        for (; x >= 0 && y >= 0 && x < sBitboardSide && y < sBitboardSide; x += dx, y += dy)
+        {
+            auto bit = squareBit(x * sBitboardSide + y);
+            attacks |= bit;
+            if (occupancy & bit)
+            {
+                break;
+            }
+        }
+    }
+    return attacks;
+}
+
+// the squares whose occupancy matters: the rays without their last square
+static std::uint64_t relevantMask(std::int32_t square, const std::array<Direction, 4> &directions)
+{
+    std::uint64_t mask = 0;
+    for (auto &[dx, dy]: directions)
+    {
+        auto x = square / sBitboardSide + dx;
+        auto y = square % sBitboardSide + dy;
+        for (; x + dx >= 0 && y + dy >= 0 && x + dx < sBitboardSide && y + dy < sBitboardSide; x += dx, y += dy)
+        {
+            mask |= squareBit(x * sBitboardSide + y);
+        }
+    }
+    return mask;
+}
+
+// found offline by a random search for sparse multipliers, the tests check them against the ray walk
+static constexpr std::array<std::uint64_t, 64> sRookMagics{{
+        0x2080001040002a80ull, 0x4440021000200040ull, 0x0100102000410009ull, 0x4080100080080004ull,
+        0x0500030010080004ull, 0x0500081400210002ull, 0x0080010002000080ull, 0x220000402d048402ull,
+        0x4400800080384000ull, 0x4020404010002000ull, 0x0041802000801000ull, 0x0e01002010000d00ull,
+        0x1001001008000500ull, 0x8000808004000200ull, 0x2004800100800200ull, 0x004100184a009100ull,
+        0x0000848001400420ull, 0x9120250040008100ull, 0x0800808020001000ull, 0x8000210009001002ull,
+        0x4800808008000400ull, 0x00000801041040a0ull, 0x0000040090080102ull, 0x0021120020440081ull,
+        0x0bc0004480008030ull, 0x0000200080400080ull, 0x8210008080200010ull, 0x5804210900100101ull,
+        0x6000080080800400ull, 0x8002000e00041810ull, 0x4010104400010288ull, 0x0806140200004091ull,
+        0x0080002000c00042ull, 0x4080201004400041ull, 0x0041001243002004ull, 0x9000100084800800ull,
+        0x4202002006001009ull, 0x0802000400800280ull, 0x00002a0814001009ull, 0x0b28004082000401ull,
+        0x00c1008000410021ull, 0x0800400104890020ull, 0x4200110020010040ull, 0x0210040008004040ull,
+        0x102c000800808004ull, 0x1082008004008002ull, 0xa000021008040001ull, 0x0010040080420011ull,
+        0x0000402900800500ull, 0x4000200040008080ull, 0x1142004080182200ull, 0x0000809000780180ull,
+        0x0018020400088080ull, 0x0000020004008080ull, 0x0000900209181c00ull, 0x0900800100004080ull,
+        0x0080408008122301ull, 0x8080e08940001103ull, 0x00014248b0200301ull, 0x0040200410010009ull,
+        0x00020010200408f2ull, 0x2021000208040003ull, 0x0410061009081484ull, 0x0084072041041082ull,
+}};
+static constexpr std::array<std::uint64_t, 64> sBishopMagics{{
+        0xc0440408a4040080ull, 0x0222a20802048180ull, 0x5008180110202040ull, 0x4084404481424002ull,
+        0x8124050444000400ull, 0x0202011188000800ull, 0x000a080108080101ull, 0x00010100900402c4ull,
+        0xc928848418082100ull, 0x0000080818028a25ull, 0x0081041c44014088ull, 0x1404490407044000ull,
+        0x8109542420488000ull, 0x0400011108404200ull, 0x0048660090241011ull, 0x0800004404390800ull,
+        0x0060044002920200ull, 0x2808000208680084ull, 0x0030002218220022ull, 0x2218000882004146ull,
+        0x0402008401212080ull, 0x822080011000a000ull, 0x0102000088410802ull, 0xc002043094410812ull,
+        0x0020045549280860ull, 0x0044022404901c00ull, 0x00012200901c04c0ull, 0x0040040104410020ull,
+        0x709010110d004000ull, 0x02040a2001101002ull, 0x0100a08202023010ull, 0xc012002012440a11ull,
+        0x0010282465211400ull, 0x00a2212100041801ull, 0x0010622c01880800ull, 0x8004020081080080ull,
+        0x0004100280040048ull, 0x0002040041080800ull, 0x9019114200040e08ull, 0x4000820a10108084ull,
+        0x0408080808800400ull, 0x0000842420808200ull, 0x4000101090001800ull, 0xc020004200810810ull,
+        0x2000202009025080ull, 0x0001101000400080ull, 0x4062284204801400ull, 0x0104182201204452ull,
+        0x8420441004100020ull, 0x1080884808040010ull, 0x0000060101210280ull, 0x2018008220a80002ull,
+        0x6000114095050400ull, 0x0000041002020804ull, 0x0830344818004460ull, 0x80188200a60a0800ull,
+        0x0002008084100210ull, 0x7080021206021280ull, 0x0281011110809000ull, 0x0000840002104402ull,
+        0x01016082400b8600ull, 0x0009102204410200ull, 0x0040101002082844ull, 0x0444041886060202ull,
+}};
+
+struct Magic
+{
+    std::uint64_t mMask;
+    std::uint64_t mMagic;
+    std::uint32_t mShift;
+    std::uint32_t mOffset;
+
+    std::uint32_t index(std::uint64_t occupancy) const noexcept
+    {
+#if defined(__BMI2__)
+        return mOffset + static_cast<std::uint32_t>(_pext_u64(occupancy, mMask));
+#else
+        return mOffset + static_cast<std::uint32_t>(((occupancy & mMask) * mMagic) >> mShift);
+#endif
+    }
+};
+
+class AttackTable
+{
+public:
+    AttackTable(const std::array<Direction, 4> &directions, const std::array<std::uint64_t, 64> &magics)
+        : mMagics()
+        , mAttacks()
+    {
+        for (std::int32_t square = 0; square < sBitboardSide * sBitboardSide; ++square)
+        {
+            auto &magic = mMagics[square];
+            magic.mMask = relevantMask(square, directions);
+            magic.mMagic = magics[square];
+            auto bits = static_cast<std::uint32_t>(__builtin_popcountll(magic.mMask));
+            magic.mShift = 64 - bits;
+            magic.mOffset = static_cast<std::uint32_t>(mAttacks.size());
+            mAttacks.resize(mAttacks.size() + (std::size_t(1) << bits));
+
+            std::uint64_t subset = 0;
+            do {   // every subset of the mask, carry-rippler
+                mAttacks[magic.index(subset)] = walk(square, subset, directions);
+                subset = (subset - magic.mMask) & magic.mMask;
+            } while (subset);
+        }
+    }
+
+    std::uint64_t attacks(std::int32_t square, std::uint64_t occupancy) const noexcept
+    {
+        return mAttacks[mMagics[square].index(occupancy)];
+    }
+
+private:
+    std::array<Magic, sBitboardSide * sBitboardSide> mMagics;
+    std::vector<std::uint64_t> mAttacks;
+};
+
+std::uint64_t rookAttacks(std::int32_t square, std::uint64_t occupancy) noexcept
+{
+    static const AttackTable table(sRookDirections, sRookMagics);
+    return table.attacks(square, occupancy);
+}
+
+std::uint64_t bishopAttacks(std::int32_t square, std::uint64_t occupancy) noexcept
+{
+    static const AttackTable table(sBishopDirections, sBishopMagics);
+    return table.attacks(square, occupancy);
+}
+
+std::uint64_t slowRookAttacks(std::int32_t square, std::uint64_t occupancy) noexcept
+{
+    return walk(square, occupancy, sRookDirections);
+}
+
+std::uint64_t slowBishopAttacks(std::int32_t square, std::uint64_t occupancy) noexcept
+{
+    return walk(square, occupancy, sBishopDirections);
+}
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Coordinate.h"
+
+/*
+ * Sliding attacks on an 8x8 bitboard, square = x * 8 + y. A set occupancy bit blocks the ray
+ * behind it, the blocker itself is attacked. The index into the attack table is the relevant
+ * occupancy gathered with PEXT when the build targets BMI2, otherwise with a magic multiply and
+ * shift. The magics are precomputed, the tables are filled on first use.
+ */
+namespace chessman {
+
+inline constexpr std::int32_t sBitboardSide = 8;
+
+constexpr std::int32_t toSquare(const board::Coordinate &coordinate) noexcept
+{
+    return coordinate.first * sBitboardSide + coordinate.second;
+}
+
+constexpr std::uint64_t squareBit(std::int32_t square) noexcept
+{
+    return std::uint64_t(1) << square;
+}
+
+std::uint64_t rookAttacks(std::int32_t square, std::uint64_t occupancy) noexcept;
+std::uint64_t bishopAttacks(std::int32_t square, std::uint64_t occupancy) noexcept;
+
+// ray walk, the reference the tables are built from
+std::uint64_t slowRookAttacks(std::int32_t square, std::uint64_t occupancy) noexcept;
+std::uint64_t slowBishopAttacks(std::int32_t square, std::uint64_t occupancy) noexcept;
+
+}
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "GameRules.h"
+#include "StepStrategy.h"
+
+using namespace board;
+
+static Coordinate::first_type uniformCell(std::int32_t sizeBoard)
+{
+    return static_cast<Coordinate::first_type>(GameRules::generateBounded(static_cast<std::uint32_t>(sizeBoard)));
+}
+
+FreeCellStep::FreeCellStep(std::int32_t sizeBoard)
+    : mSizeBoard(sizeBoard)
+{
+
+}
+
+board::Coordinate FreeCellStep::firstStep()
+{
+    return {uniformCell(mSizeBoard), uniformCell(mSizeBoard)};
+}
+
+board::Coordinate FreeCellStep::nextStep(const chessman::IChessMan &chessMan)
+{
+    return GameRules::generateUniformStep(chessMan.getType(), chessMan.getCurrentCoordinate());
+}
+
+board::Coordinate FreeCellStep::nextStepOnBoard(const chessman::IChessMan &chessMan, const board::IChessBoard &chessBoard)
+{
+    Coordinate to;
+    if (chessBoard.sampleDestination(chessMan, GameRules::generateBits(), to))
+    {
+        return to;
+    }
+    return nextStep(chessMan);
+}
+
+HotspotStep::HotspotStep(Kind kind, std::int32_t sizeBoard, board::Coordinate cell, double exponent, double hot)
+    : mKind(kind)
+    , mSizeBoard(sizeBoard)
+    , mCell(cell)
+    , mHot(hot)
+    , mCumulative()
+{
+    if (!(hot >= 0.0 && hot <= 1.0))
+    {
+        throw std::invalid_argument("Hotspot share must be in [0, 1]");
+    }
+    if (cell.first < 0 || cell.second < 0 || cell.first >= sizeBoard || cell.second >= sizeBoard)
+    {
+        throw std::invalid_argument("Hotspot cell is outside of the board");
+    }
+    if (mKind == Kind::zipf)
+    {
+        auto cells = static_cast<std::size_t>(sizeBoard) * sizeBoard;
+        mCumulative.reserve(cells);
+        double sum = 0;
+        for (std::size_t rank = 1; rank <= cells; ++rank)
+        {
+            sum += 1.0 / std::pow(static_cast<double>(rank), exponent);
+            mCumulative.push_back(sum);
+        }
+    }
+}
+
+board::Coordinate HotspotStep::firstStep()
+{
+    return {uniformCell(mSizeBoard), uniformCell(mSizeBoard)};
+}
+
+board::Coordinate HotspotStep::nextStep(const chessman::IChessMan &chessMan)
+{
+    auto type = chessMan.getType();
+    auto &current = chessMan.getCurrentCoordinate();
+    if (GameRules::generateUnit() >= mHot)
+    {
+        return GameRules::generateUniformStep(type, current);
+    }
+    auto to = target();
+    if (to == current)
+    {
+        return GameRules::generateUniformStep(type, current);
+    }
+    if (GameRules::checkStep(type, current, to))
+    {
+        return to;
+    }
+    if (type != chessman::ChessmanType::rook && type != chessman::ChessmanType::queen)
+    {   // short-range and diagonal pieces drift until the target is one move away
+        return GameRules::generateUniformStep(type, current);
+    }
+    if (GameRules::generateBounded(2))
+    {
+        return {to.first, current.second};
+    }
+    return {current.first, to.second};
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+board::Coordinate HotspotStep::target()
+{
+    switch (mKind) {
+        case Kind::cell:
+            return mCell;
+        case Kind::row:
+            return {mCell.first, uniformCell(mSizeBoard)};
+        case Kind::zipf:
+            break;
+    }
+    auto draw = GameRules::generateUnit() * mCumulative.back();
+    auto rank = static_cast<std::int32_t>(std::upper_bound(mCumulative.begin(), mCumulative.end(), draw)
+                                          - mCumulative.begin());
+    rank = std::min(rank, static_cast<std::int32_t>(mCumulative.size()) - 1);
+    return {static_cast<Coordinate::first_type>(rank / mSizeBoard), static_cast<Coordinate::second_type>(rank % mSizeBoard)};
+}
+
+static double parseShare(const std::string &text, const std::string &spec)
+{
+    std::size_t position = 0;
+    auto value = -1.0;
+    try {
+        value = std::stod(text, &position);
+    } catch (const std::exception &) {
+        position = 0;
+    }
+    if (text.empty() || position != text.size() || !(value >= 0.0))
+    {
+        throw std::invalid_argument("Malformed hotspot '" + spec + "'");
+    }
+    return value;
+}
+
+std::shared_ptr<IStepStrategy> makeStepStrategy(const std::string &spec, std::int32_t sizeBoard)
+{
+    auto at = spec.find('@');
+    auto hot = at == std::string::npos ? HotspotStep::sDefaultHot : parseShare(spec.substr(at + 1), spec);
+    auto colon = spec.find(':');
+    auto kind = spec.substr(0, std::min(colon, at));
+    auto argument = colon == std::string::npos || colon > at ? std::string() : spec.substr(colon + 1, at - colon - 1);
+    auto number = [&](const std::string &text) {
+        std::size_t position = 0;
+        int value = -1;
+        try {
+            value = std::stoi(text, &position);
+        } catch (const std::exception &) {
+            position = 0;
+        }
+        if (text.empty() || position != text.size() || value < 0)
+        {
+            throw std::invalid_argument("Malformed hotspot '" + spec + "'");
+        }
+        return static_cast<Coordinate::first_type>(std::min(value, static_cast<int>(GameRules::sMaxSizeBoard)));
+    };
+
+    if (kind == "uniform" && argument.empty() && at == std::string::npos)
+    {
+        return nullptr;
+    }
+    if (kind == "free" && argument.empty() && at == std::string::npos)
+    {
+        return std::make_shared<FreeCellStep>(sizeBoard);
+    }
+    if (kind == "cell")
+    {
+        Coordinate cell{0, 0};
+        if (!argument.empty())
+        {
+            auto comma = argument.find(',');
+            if (comma == std::string::npos)
+            {
+                throw std::invalid_argument("Hotspot cell expects cell:x,y, got '" + spec + "'");
+            }
+            cell = {number(argument.substr(0, comma)), number(argument.substr(comma + 1))};
+        }
+        return std::make_shared<HotspotStep>(HotspotStep::Kind::cell, sizeBoard, cell, 1.0, hot);
+    }
+    if (kind == "row")
+    {
+        Coordinate cell{argument.empty() ? Coordinate::first_type(0) : number(argument), 0};
+        return std::make_shared<HotspotStep>(HotspotStep::Kind::row, sizeBoard, cell, 1.0, hot);
+    }
+    if (kind == "zipf")
+    {
+        auto exponent = argument.empty() ? 1.0 : parseShare(argument, spec);
+        return std::make_shared<HotspotStep>(HotspotStep::Kind::zipf, sizeBoard, Coordinate{0, 0}, exponent, hot);
+    }
+    throw std::invalid_argument("Unknown hotspot '" + spec + "', expected uniform, free, cell, row or zipf");
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Coordinate.h"
+#include "IChessBoard.h"
+#include "IChessMan.h"
+
+/*
+ * Chooses where participants go. GameRules falls back to uniform random rook moves when no
+ * strategy is installed. Implementations are shared by all participant threads.
+ */
+class IStepStrategy
+{
+public:
+    virtual ~IStepStrategy() = default;
+
+    virtual board::Coordinate firstStep() = 0;
+    // a legal move of the figure's piece type, never the current cell
+    virtual board::Coordinate nextStep(const chessman::IChessMan &chessMan) = 0;
+    // the same for a figure on `board`, strategies that look at the occupancy override it
+    virtual board::Coordinate nextStepOnBoard(const chessman::IChessMan &chessMan, const board::IChessBoard &/* chessBoard */)
+    {
+        return nextStep(chessMan);
+    }
+};
+
+/*
+ * Uniform over the cells the figure can reach and that are free right now, sampled by the board
+ * from its occupancy snapshot. Falls back to a uniform move when no cell is free, or when
+ * the board is not known.
+ */
+class FreeCellStep : public IStepStrategy
+{
+public:
+    explicit FreeCellStep(std::int32_t sizeBoard);
+
+    board::Coordinate firstStep() override;
+    board::Coordinate nextStep(const chessman::IChessMan &chessMan) override;
+    board::Coordinate nextStepOnBoard(const chessman::IChessMan &chessMan, const board::IChessBoard &chessBoard) override;
+
+private:
+    const std::int32_t mSizeBoard;
+};
+
+/*
+ * Skewed traffic: with probability `hot` a step heads for a target cell, straight to it when it
+ * is one move away, otherwise rooks and queens go to the row or column of the target and the
+ * other pieces make a uniform move. Other steps, and
+ * steps of a figure standing on its target, are uniform. The uniform share is what lets figures
+ * leave the saturated lines of a hot cell, with hot = 1 a crowded hot cell livelocks.
+ * First steps stay uniform so that placements rarely wait.
+ *   cell[:x,y]  one hot cell, {0, 0} by default
+ *   row[:x]     any cell of row x (cells {x, *}), row 0 by default
+ *   zipf[:s]    cells ranked by index x * size + y with P(rank k) ~ 1 / k^s, s = 1 by default
+ * each optionally followed by @hot, 0.9 by default, e.g. "cell:3,3@0.5".
+ */
+class HotspotStep : public IStepStrategy
+{
+public:
+    enum class Kind;
+
+    HotspotStep(Kind kind, std::int32_t sizeBoard, board::Coordinate cell = {0, 0}, double exponent = 1.0,
+                double hot = sDefaultHot);
+
+    board::Coordinate firstStep() override;
+    board::Coordinate nextStep(const chessman::IChessMan &chessMan) override;
+
+    static constexpr double sDefaultHot = 0.9;
+
+private:
+    board::Coordinate target();
+
+    const Kind mKind;
+    const std::int32_t mSizeBoard;
+    const board::Coordinate mCell;
+    const double mHot;
+    std::vector<double> mCumulative; // zipf only
+};
+
+enum class HotspotStep::Kind
+{
+    cell, row, zipf
+};
+
+// "uniform" (nullptr), "free", "cell[:x,y]", "row[:x]" or "zipf[:s]" with an optional "@hot",
+// throws std::invalid_argument
+std::shared_ptr<IStepStrategy> makeStepStrategy(const std::string &spec, std::int32_t sizeBoard);
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "Tracer.h"
+
+static std::int64_t steadyNanoseconds()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void writeEscaped(std::ostream &os, const std::string &text)
+{
+    for (auto ch: text)
+    {
+        if (ch == '"' || ch == '\\')
+        {
+            os << '\\';
+        }
+        if (static_cast<unsigned char>(ch) >= 0x20)
+        {
+            os << ch;
+        }
+    }
+}
+
+Tracer::Tracer()
+    : mEnabled(false)
+    , mPath()
+    , mMaxEvents(sDefaultMaxEvents)
+    , mStartTicks(0)
+    , mStartNanoseconds(0)
+    , mMutex()
+    , mBuffers()
+{
+
+}
+
+Tracer &Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::enable(std::string path, std::size_t maxEventsPerThread)
+{
+    std::lock_guard lock(mMutex);
+    mPath = std::move(path);
+    mMaxEvents.store(maxEventsPerThread, std::memory_order_relaxed);
+    mStartTicks = now();
+    mStartNanoseconds = steadyNanoseconds();
+    mEnabled.store(true, std::memory_order_release);
+}
+
+bool Tracer::enabled() const noexcept
+{
+    return mEnabled.load(std::memory_order_relaxed);
+}
+
+bool Tracer::dump()
+{
+    if (!enabled())
+    {
+        return false;
+    }
+    mEnabled.store(false, std::memory_order_release);
+
+    std::lock_guard lock(mMutex);
+    auto ticks = now() - mStartTicks;
+    auto nanoseconds = steadyNanoseconds() - mStartNanoseconds;
+    auto microsecondsPerTick = ticks ? static_cast<double>(nanoseconds) / 1000.0 / static_cast<double>(ticks) : 0.0;
+    auto toMicroseconds = [&](std::uint64_t tick) {
+        return static_cast<double>(tick - mStartTicks) * microsecondsPerTick;
+    };
+
+    std::ofstream out(mPath);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    auto first = true;
+    auto separator = [&]() {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+    for (auto &buffer: mBuffers)
+    {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->mTid << ",\"args\":{\"name\":\"";
+        writeEscaped(out, buffer->mName);
+        out << "\"}}";
+        std::lock_guard events(buffer->mMutex);
+        for (auto &event: buffer->mEvents)
+        {
+            if (event.mBegin < mStartTicks)
+            {
+                continue;
+            }
+            separator();
+            out << "{\"name\":\"" << event.mName << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->mTid
+                << ",\"ts\":" << toMicroseconds(event.mBegin)
+                << ",\"dur\":" << toMicroseconds(event.mEnd) - toMicroseconds(event.mBegin) << "}";
+        }
+        if (buffer->mDropped)
+        {
+            separator();
+            out << "{\"name\":\"dropped " << buffer->mDropped << " spans\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":"
+                << buffer->mTid << ",\"ts\":" << toMicroseconds(now()) << "}";
+        }
+        buffer->mEvents.clear();
+        buffer->mDropped = 0;
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+void Tracer::setThreadName(const std::string &name)
+{
+    if (enabled())
+    {
+        auto &current = buffer();
+        std::lock_guard lock(mMutex);
+        current.mName = name + " " + std::to_string(current.mTid);
+    }
+}
+
+std::uint64_t Tracer::now() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(steadyNanoseconds());
+#endif
+}
+
+/* ************************************************************
+ * IMPL private
+ * ************************************************************/
+Tracer::ThreadBuffer &Tracer::buffer()
+{
+    static thread_local ThreadBuffer *current = nullptr;
+    if (!current)
+    {
+        auto created = std::make_unique<ThreadBuffer>();
+        created->mTid = static_cast<std::uint32_t>(::syscall(SYS_gettid));
+        created->mName = "thread " + std::to_string(created->mTid);
+        created->mDropped = 0;
+
+        std::lock_guard lock(mMutex);
+        created->mEvents.reserve(std::min<std::size_t>(mMaxEvents.load(std::memory_order_relaxed), 4096));
+        current = created.get();
+        mBuffers.push_back(std::move(created));
+    }
+    return *current;
+}
+
+void Tracer::record(const char *name, std::uint64_t begin, std::uint64_t end)
+{
+    auto &current = buffer();
+    std::lock_guard lock(current.mMutex);
+    if (current.mEvents.size() < mMaxEvents.load(std::memory_order_relaxed))
+    {
+        current.mEvents.push_back(Event{name, begin, end});
+    } else {
+        ++current.mDropped;
+    }
+}
+
+Tracer::Scope::Scope(const char *name) noexcept
+    : mName(Tracer::instance().enabled() ? name : nullptr)
+    , mBegin(mName ? Tracer::now() : 0)
+{
+
+}
+
+Tracer::Scope::~Scope()
+{
+    if (mName)
+    {
+        auto &tracer = Tracer::instance();
+        if (tracer.enabled())
+        {
+            tracer.record(mName, mBegin, Tracer::now());
+        }
+    }
+}
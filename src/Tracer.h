@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ * Optional span tracer. Spans are stamped with the TSC (steady_clock where there is none),
+ * kept in per-thread buffers and written as Chrome/Perfetto trace-event JSON by dump(). Every
+ * buffer has a lock of its own, uncontended but for dump(), so that threads not yet joined, e.g.
+ * the board flushing its last notifications after Game::stopGame, may still end spans meanwhile.
+ * While disabled a span costs one relaxed load.
+ */
+class Tracer
+{
+public:
+    class Scope;
+
+    static Tracer &instance();
+
+    void enable(std::string path, std::size_t maxEventsPerThread = sDefaultMaxEvents);
+    bool enabled() const noexcept;
+    bool dump();
+
+    // labels the track of the calling thread
+    void setThreadName(const std::string &name);
+
+    static std::uint64_t now() noexcept;
+
+    static constexpr std::size_t sDefaultMaxEvents = 1u << 20u;
+
+private:
+    struct Event;
+    struct ThreadBuffer;
+
+    Tracer();
+    ThreadBuffer &buffer();
+    void record(const char *name, std::uint64_t begin, std::uint64_t end);
+
+    std::atomic<bool> mEnabled;
+    std::string mPath;
+    std::atomic<std::size_t> mMaxEvents;
+    std::uint64_t mStartTicks;
+    std::int64_t mStartNanoseconds;
+
+    std::mutex mMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> mBuffers;
+};
+
+class Tracer::Scope
+{
+public:
+    explicit Scope(const char *name) noexcept;
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *mName;
+    std::uint64_t mBegin;
+};
+
+struct Tracer::Event
+{
+    const char *mName;
+    std::uint64_t mBegin;
+    std::uint64_t mEnd;
+};
+
+struct Tracer::ThreadBuffer
+{
+    std::uint32_t mTid;
+    std::string mName;
+    std::mutex mMutex; // mEvents and mDropped
+    std::vector<Event> mEvents;
+    std::uint64_t mDropped;
+};
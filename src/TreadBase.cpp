@@ -1,38 +1,98 @@
+#include <climits>
+#include <stdexcept>
+#include <system_error>
+#include <algorithm>
+
 #include "TreadBase.h"
+#include "Tracer.h"
 
 TreadBase::TreadBase(std::string name)
-    : mTread(nullptr)
+    : mTread()
+    , mRunning(false)
     , mName(std::move(name))
+    , mAttributes()
 {
 
 }
 
+void TreadBase::setAttributes(ThreadAttributes attributes)
+{
+    mAttributes = std::move(attributes);
+}
+
 void TreadBase::start()
 {
-    if (!mTread)
+    if (!mRunning)
     {
-        mTread = std::make_unique<std::thread>(&TreadBase::mainLoop, this);
-        pthread_setname_np(mTread->native_handle(), mName.c_str());
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        auto result = 0;
+        if (mAttributes.mStackSize)
+        {
+            result = pthread_attr_setstacksize(&attr, std::max<std::size_t>(mAttributes.mStackSize, PTHREAD_STACK_MIN));
+        }
+        if (!result && !mAttributes.mCpus.empty())
+        {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            for (auto cpu: mAttributes.mCpus)
+            {
+                if (cpu >= CPU_SETSIZE)
+                {
+                    pthread_attr_destroy(&attr);
+                    throw std::invalid_argument("CPU " + std::to_string(cpu) + " is beyond CPU_SETSIZE");
+                }
+                CPU_SET(cpu, &cpus);
+            }
+            result = pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+        }
+        if (!result && mAttributes.mPolicy != SCHED_OTHER)
+        {
+            sched_param param{};
+            param.sched_priority = mAttributes.mPriority;
+            result = pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+            result = result ? result : pthread_attr_setschedpolicy(&attr, mAttributes.mPolicy);
+            result = result ? result : pthread_attr_setschedparam(&attr, &param);
+        }
+        if (!result)
+        {
+            result = pthread_create(&mTread, &attr, &TreadBase::mainLoop, this);
+        }
+        pthread_attr_destroy(&attr);
+        if (result)
+        {
+            throw std::system_error(result, std::generic_category(), "Cannot start thread " + mName);
+        }
+        mRunning = true;
+        pthread_setname_np(mTread, mName.c_str());
     }
 }
 
 void TreadBase::cancel()
 {
-    pthread_cancel(mTread->native_handle());
+    pthread_cancel(mTread);
 }
 
 
-void TreadBase::mainLoop()
+void *TreadBase::mainLoop(void *self)
 {
-    onStart();
-    loop();
-    onStop();
+    auto &thread = *static_cast<TreadBase *>(self);
+    Tracer::instance().setThreadName(thread.mName);
+    thread.onStart();
+    thread.loop();
+    thread.onStop();
+    return nullptr;
 }
 
 void TreadBase::join()
 {
-    if (mTread) {
-        mTread->join();
-        mTread.reset();
+    if (mRunning) {
+        if (pthread_equal(mTread, pthread_self()))
+        {   // the thread dropped the last reference to its owner, nothing is left to wait for
+            pthread_detach(mTread);
+        } else {
+            pthread_join(mTread, nullptr);
+        }
+        mRunning = false;
     }
-}
\ No newline at end of file
+}
@@ -1,9 +1,21 @@
 #pragma once
-#include <thread>
+#include <pthread.h>
+#include <sched.h>
 #include <string>
+#include <vector>
 
 #include "RemoveCopyMove.h"
 
+struct ThreadAttributes
+{
+    // cores the thread may run on, any core when empty
+    std::vector<std::size_t> mCpus;
+    // bytes, the pthread default when 0, raised to PTHREAD_STACK_MIN when smaller
+    std::size_t mStackSize = 0;
+    // SCHED_FIFO and SCHED_RR usually need CAP_SYS_NICE, the priority is ignored for SCHED_OTHER
+    int mPolicy = SCHED_OTHER;
+    int mPriority = 0;
+};
 
 class TreadBase : public virtual RemoveCopyMove
 {
@@ -11,7 +23,12 @@ public:
     explicit TreadBase(std::string name);
     ~TreadBase() override = default;
 
+    // used by the next start, e.g. Game pins the board thread and keeps participant stacks small
+    void setAttributes(ThreadAttributes attributes);
+
 protected:
+    // throws std::invalid_argument for a CPU beyond CPU_SETSIZE and std::system_error when the
+    // thread cannot be created with the attributes, e.g. a real-time policy without privilege
     void start();
     void cancel();
 
@@ -21,8 +38,10 @@ protected:
 
     void join();
 private:
-    void mainLoop();
+    static void *mainLoop(void *self);
 
-    std::unique_ptr<std::thread> mTread;
+    pthread_t mTread;
+    bool mRunning;
     const std::string mName;
+    ThreadAttributes mAttributes;
 };
@@ -1,12 +1,41 @@
 #include <iostream>
-#include <memory>
-#include "Game.h"
+#include <cstdlib>
+#include <stdexcept>
+#include "ScenarioRunner.h"
 
 int main(int argc, char **argv) {
-    auto game = std::make_shared<Game>(4, 30);
+    Scenario scenario;
+    try {
+        scenario = ScenarioRunner::parse(argc, argv);
+    } catch (const std::invalid_argument &error) {
+        std::cerr << error.what() << std::endl;
+        ScenarioRunner::usage(std::cerr, argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (scenario.mHelp)
+    {
+        ScenarioRunner::usage(std::cout, argv[0]);
+        return EXIT_SUCCESS;
+    }
+    if (auto trace = std::getenv("CHESSROOK_TRACE"); trace && scenario.mGame.mTracePath.empty())
+    {
+        scenario.mGame.mTracePath = trace;
+    }
 
-    game->startGame();
-    game->waitEnd();
+    auto serving = !scenario.mServe.empty();
+    ScenarioRunner runner(std::move(scenario));
+    if (serving)
+    {
+        try {
+            runner.serve(std::cout);
+        } catch (const std::exception &error) {
+            // a socket that cannot be bound, a partition that does not fit the board
+            std::cerr << error.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    } else {
+        runner.run(std::cout);
+    }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -21,7 +21,12 @@ std::unique_ptr<ParticipantGame::IState> NextStepState::doWork(std::unique_ptr<P
     std::unique_ptr<ParticipantGame::IState> result;
     if (!ptr) {
         result = std::make_unique<WaitForConfirmStep>(mBoard, mChessMan);
-        mBoard->moveFigure(*mChessMan, GameRules::generateStep(*mChessMan));
+        if (mChessMan->getCurrentCoordinate() == board::invalidCoordinate)
+        {   // the placement was dropped by an overloaded board
+            mBoard->placeFigure(*mChessMan, GameRules::generateFirstStep());
+        } else {
+            mBoard->moveFigure(*mChessMan, GameRules::generateStep(*mChessMan, *mBoard));
+        }
     } else {
         if (ptr->mTypeEvent == ParticipantGame::Event::Type::stop)
         {
@@ -30,6 +35,11 @@ std::unique_ptr<ParticipantGame::IState> NextStepState::doWork(std::unique_ptr<P
         } else if (ptr->mTypeEvent == ParticipantGame::Event::Type::reject && ptr->mReasonReject == board::ReasonReject::boardStopped)
         {
             result = std::make_unique<StopState>();
+        } else if (ptr->mTypeEvent == ParticipantGame::Event::Type::reject
+                   && (ptr->mReasonReject == board::ReasonReject::idMismatch
+                       || ptr->mReasonReject == board::ReasonReject::waiterNotFound))
+        {   // late answer to the cancel of WaitForCellStep, the figure has moved meanwhile
+            result = std::make_unique<NextStepState>(mBoard, mChessMan);
         } else {
             throw std::logic_error("Unexpected event in NextStep class");
         }
@@ -41,3 +51,8 @@ std::unique_ptr<ParticipantGame::IState> NextStepState::doWork(std::unique_ptr<P
 bool NextStepState::stop() const {
     return false;
 }
+
+const char *NextStepState::name() const
+{
+    return "NextStepState";
+}
@@ -13,3 +13,8 @@ std::unique_ptr<ParticipantGame::IState> StopState::doWork(std::unique_ptr<Parti
 bool StopState::stop() const {
     return true;
 }
+
+const char *StopState::name() const
+{
+    return "StopState";
+}
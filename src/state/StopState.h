@@ -11,6 +11,7 @@ public:
     std::chrono::milliseconds waitPeriod() const override;
     std::unique_ptr<ParticipantGame::IState> doWork(std::unique_ptr<ParticipantGame::Event> ptr) override;
     bool stop() const override;
+    const char *name() const override;
 
 private:
 };
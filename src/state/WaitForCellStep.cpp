@@ -45,11 +45,17 @@ std::unique_ptr<ParticipantGame::IState> WaitForCellStep::doWork(std::unique_ptr
                     case board::ReasonReject::boardStopped:
                         result = std::make_unique<StopState>();
                         break;
+                    case board::ReasonReject::pathBlocked:
+                        // the cell was freed but the path filled up while waiting
+                        result = std::make_unique<WaitForConfirmStep>(mBoard, mChessMan);
+                        mBoard->moveFigure(*mChessMan, GameRules::generateStep(*mChessMan, *mBoard));
+                        break;
                     case board::ReasonReject::incorrectCoordinate:
                     case board::ReasonReject::idMismatch:
                     case board::ReasonReject::incorrectId:
                     case board::ReasonReject::duplicateId:
                     case board::ReasonReject::waiterNotFound:
+                    case board::ReasonReject::overloaded: // cancels and removes are never dropped
                     case board::ReasonReject::empty:
                         throw std::logic_error("Unexpected ReasonReject in WaitForCellStep class");
                 }
@@ -58,6 +64,9 @@ std::unique_ptr<ParticipantGame::IState> WaitForCellStep::doWork(std::unique_ptr
             case ParticipantGame::Event::Type::waitingForCell:
                 throw std::logic_error("Unexpected event in WaitForCellStep class");
         }
+    } else if (mChessMan->getCurrentCoordinate() == board::invalidCoordinate) {
+        // a pending placement has no cell to fall back to, keep waiting
+        result = std::make_unique<WaitForCellStep>(mBoard, mChessMan, mToCoordinate);
     } else {
         result = std::make_unique<WaitForConfirmStep>(mBoard, mChessMan);
         mBoard->cancelMoveFigure(*mChessMan, mToCoordinate);
@@ -70,3 +79,8 @@ bool WaitForCellStep::stop() const
 {
     return false;
 }
+
+const char *WaitForCellStep::name() const
+{
+    return "WaitForCellStep";
+}
@@ -35,7 +35,7 @@ std::unique_ptr<ParticipantGame::IState> WaitForConfirmStep::doWork(std::unique_
                 break;
             case ParticipantGame::Event::Type::cancelMoved:
                 result = std::make_unique<WaitForConfirmStep>(mBoard, mChessMan);
-                mBoard->moveFigure(*mChessMan, GameRules::generateStep(*mChessMan));
+                mBoard->moveFigure(*mChessMan, GameRules::generateStep(*mChessMan, *mBoard));
                 break;
             case ParticipantGame::Event::Type::waitingForCell:
                 result = std::make_unique<WaitForCellStep>(mBoard, mChessMan, ptr->mToCoordinate);
@@ -48,11 +48,22 @@ std::unique_ptr<ParticipantGame::IState> WaitForConfirmStep::doWork(std::unique_
                     case board::ReasonReject::boardStopped:
                         result = std::make_unique<StopState>();
                         break;
-                    case board::ReasonReject::incorrectCoordinate:
                     case board::ReasonReject::idMismatch:
+                    case board::ReasonReject::waiterNotFound:
+                        // the cancel of WaitForCellStep lost the race with the cell being freed
+                        result = std::make_unique<WaitForConfirmStep>(mBoard, mChessMan);
+                        break;
+                    case board::ReasonReject::pathBlocked:
+                        result = std::make_unique<WaitForConfirmStep>(mBoard, mChessMan);
+                        mBoard->moveFigure(*mChessMan, GameRules::generateStep(*mChessMan, *mBoard));
+                        break;
+                    case board::ReasonReject::overloaded:
+                        // the command was dropped, try again after the delay of the next step
+                        result = std::make_unique<NextStepState>(mBoard, mChessMan);
+                        break;
+                    case board::ReasonReject::incorrectCoordinate:
                     case board::ReasonReject::incorrectId:
                     case board::ReasonReject::duplicateId:
-                    case board::ReasonReject::waiterNotFound:
                     case board::ReasonReject::empty:
                         throw std::logic_error("Unexpected ReasonReject in WaitForCellStep class");
                 }
@@ -69,3 +80,8 @@ std::unique_ptr<ParticipantGame::IState> WaitForConfirmStep::doWork(std::unique_
 bool WaitForConfirmStep::stop() const {
     return false;
 }
+
+const char *WaitForConfirmStep::name() const
+{
+    return "WaitForConfirmStep";
+}
@@ -13,6 +13,7 @@ public:
     std::unique_ptr<ParticipantGame::IState> doWork(std::unique_ptr<ParticipantGame::Event> ptr) override;
 
     bool stop() const override;
+    const char *name() const override;
 
 private:
     std::shared_ptr<board::IChessBoard> mBoard;
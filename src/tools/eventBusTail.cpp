@@ -0,0 +1,100 @@
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include "EventBus.h"
+
+/*
+ * Sample consumer of the event bus of a running game (ChessRook --event-bus NAME): prints the
+ * events in the notation of the Logger until interrupted, and the events it lost when it lagged.
+ */
+
+static volatile std::sig_atomic_t gStop = 0;
+
+static const char *symbol(board::BoardEvent::Type type)
+{
+    switch (type) {
+        case board::BoardEvent::Type::placed:
+            return "-O";
+        case board::BoardEvent::Type::moved:
+            return "->";
+        case board::BoardEvent::Type::cancelMoved:
+            return "X?";
+        case board::BoardEvent::Type::removed:
+            return "-X";
+        case board::BoardEvent::Type::waitingForCell:
+            return "-?";
+        case board::BoardEvent::Type::reject:
+            return "XX";
+    }
+    return "??";
+}
+
+static std::ostream &operator<<(std::ostream &os, const board::Coordinate &coord)
+{
+    return os << static_cast<char>('A' + coord.first) << static_cast<int>(coord.second);
+}
+
+static void print(std::ostream &os, const eventbus::Record &record)
+{
+    auto &event = record.mEvent;
+    os << '#' << record.mSequence << " ID: " << event.mId << ' ';
+    if (event.mFrom != board::invalidCoordinate)
+    {
+        os << event.mFrom << ' ';
+    }
+    os << symbol(event.mType);
+    if (event.mTo != board::invalidCoordinate)
+    {
+        os << ' ' << event.mTo;
+    }
+    if (event.mType == board::BoardEvent::Type::reject)
+    {
+        os << " reason " << static_cast<int>(event.mReason);
+    }
+    os << '\n';
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || (argc > 2 && std::strcmp(argv[2], "--from-oldest") != 0))
+    {
+        std::cerr << "Usage: " << argv[0] << " NAME [--from-oldest]\n";
+        return EXIT_FAILURE;
+    }
+    std::signal(SIGINT, [](int) { gStop = 1; });
+    std::signal(SIGTERM, [](int) { gStop = 1; });
+    try {
+        EventBusReader reader(argv[1], argc > 2);
+        eventbus::Record records[256];
+        auto lost = reader.lost();
+        while (!gStop)
+        {
+            auto count = reader.poll(records, std::size(records));
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                print(std::cout, records[i]);
+            }
+            if (reader.lost() != lost)
+            {
+                std::cout << "lost " << reader.lost() - lost << " events\n";
+                lost = reader.lost();
+            }
+            if (!count)
+            {
+                std::cout.flush();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        std::cout << "read up to #" << reader.next() << ", lost " << reader.lost() << std::endl;
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "BatchSimulator.h"
+#include "GameRules.h"
+
+TEST(BatchSimulatorTest, everyGamePlaysAllItsSteps)
+{
+    GameRules::configure({});
+    BatchSettings settings;
+    settings.mGames = 3000;
+    settings.mParticipants = 6;
+    settings.mSteps = 20;
+    settings.mLanes = 64;
+    settings.mThreads = 4;
+    auto report = BatchSimulator(settings).run();
+    EXPECT_EQ(report.mGames, 3000);
+    EXPECT_EQ(report.mRounds.mCount, 3000);
+    EXPECT_EQ(report.mMoves, 3000 * 6 * 20);
+    EXPECT_EQ(report.mPathBlocked, 0);
+    EXPECT_GT(report.mWaits, 0);
+    EXPECT_LE(report.mCancels, report.mWaits);
+    // a figure moves at most once a round and needs a round to be placed
+    EXPECT_GE(report.mRounds.mMax, 21);
+    EXPECT_GE(report.mRounds.mP50, 21);
+}
+
+TEST(BatchSimulatorTest, sameSeedSameGamesOnAnyThreadCount)
+{
+    GameRules::Settings rules;
+    rules.mPieces = {chessman::ChessmanType::queen, chessman::ChessmanType::knight};
+    rules.mBlockingSliders = true;
+    GameRules::configure(rules);
+    BatchSettings settings;
+    settings.mGames = 2000;
+    settings.mParticipants = 8;
+    settings.mSteps = 10;
+    settings.mLanes = 32;
+    settings.mSeed = 42;
+    settings.mThreads = 1;
+    auto single = BatchSimulator(settings).run();
+    settings.mThreads = 4;
+    auto many = BatchSimulator(settings).run();
+    GameRules::configure({});
+
+    EXPECT_EQ(single.mMoves, 2000 * 8 * 10);
+    EXPECT_GT(single.mPathBlocked, 0);
+    EXPECT_EQ(single.mMoves, many.mMoves);
+    EXPECT_EQ(single.mWaits, many.mWaits);
+    EXPECT_EQ(single.mCancels, many.mCancels);
+    EXPECT_EQ(single.mPathBlocked, many.mPathBlocked);
+    EXPECT_EQ(single.mRounds.mMax, many.mRounds.mMax);
+}
+
+TEST(BatchSimulatorTest, rejectsBoardsWithoutBitboard)
+{
+    GameRules::Settings rules;
+    rules.mSizeBoard = 9;
+    GameRules::configure(rules);
+    EXPECT_THROW(BatchSimulator{BatchSettings{}}, std::invalid_argument);
+    GameRules::configure({});
+    BatchSettings settings;
+    settings.mParticipants = 64;
+    EXPECT_THROW(BatchSimulator{settings}, std::invalid_argument);
+}
@@ -1,9 +1,14 @@
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 #include "IChessBoard.h"
 #include "IChessMan.h"
 #include "ChessBoardImpl.h"
+#include "ChessManImpl.h"
 
 using namespace testing;
 using namespace board;
@@ -217,6 +222,7 @@ TEST_F(ChessBoardTest, placeFigure_ToBusyCell)
             }));
     mBoard->stopGame();
     waitForFinish();
+    waitForFinish(); // both rejects, TearDown removes the notifier
 }
 
 TEST_F(ChessBoardTest, moveFigure_IncorrectId)
@@ -589,3 +595,411 @@ TEST_F(ChessBoardTest, cancelMoveFigure_waiterNotFound)
     mBoard->cancelMoveFigure(*mockIChessMan, {5, 5});
     waitForFinish();
 }
+
+TEST(CellIndexTest, convertsCoordinatesInsideTheBoardOnly)
+{
+    static_assert(CellIndex::fromCoordinate({2, 3}, 8).value() == 19);
+    static_assert(CellIndex::fromCoordinate({2, 3}, 8).toCoordinate(8) == Coordinate(2, 3));
+    static_assert(!CellIndex().valid());
+    static_assert(CellIndex().toCoordinate(8) == invalidCoordinate);
+
+    for (auto coordinate: {Coordinate(8, 0), Coordinate(0, 8), Coordinate(-1, 0), Coordinate(0, -1), invalidCoordinate})
+    {
+        EXPECT_FALSE(CellIndex::fromCoordinate(coordinate, 8).valid());
+    }
+    EXPECT_EQ(CellIndex::fromCoordinate({126, 126}, 127).value(), 127u * 127u - 1u);
+    EXPECT_EQ(CellIndex::fromCoordinate({126, 126}, 127).toCoordinate(127), Coordinate(126, 126));
+}
+
+TEST(ChessBoardContentionTest, waitQueueRecordsDepthAndOutcome)
+{
+    auto board = std::make_shared<ChessBoardImpl>(8);
+    auto notifier = std::make_shared<NiceMock<MockNotifier>>();
+    board->startGame();
+    board->addNotifier(notifier);
+
+    ChessManImpl first(1, chessman::ChessmanType::queen), second(2, chessman::ChessmanType::queen);
+    std::promise<void> waiting, done;
+    {
+        InSequence sequence;
+        EXPECT_CALL(*notifier, placed(1, Coordinate(5, 5)));
+        EXPECT_CALL(*notifier, placed(2, Coordinate(0, 0)));
+        EXPECT_CALL(*notifier, waitingForCell(2, Coordinate(0, 0), Coordinate(5, 5)));
+        EXPECT_CALL(*notifier, waitingForCell(1, Coordinate(5, 5), Coordinate(0, 0)))
+                .WillOnce(Invoke([&](std::uint32_t, const Coordinate &, const Coordinate &) {
+                    waiting.set_value();
+                }));
+        EXPECT_CALL(*notifier, cancelMoved(2, Coordinate(0, 0), Coordinate(5, 5)));
+        EXPECT_CALL(*notifier, removed(2, Coordinate(0, 0)));
+        EXPECT_CALL(*notifier, moved(1, Coordinate(5, 5), Coordinate(0, 0)))
+                .WillOnce(Invoke([&](std::uint32_t, const Coordinate &, const Coordinate &) {
+                    done.set_value();
+                }));
+    }
+    board->placeFigure(first, {5, 5});
+    board->placeFigure(second, {0, 0});
+    first.setCurrentCoordinate({5, 5});
+    second.setCurrentCoordinate({0, 0});
+    board->moveFigure(second, {5, 5});
+    board->moveFigure(first, {0, 0});
+    // each move waits because its target cell is occupied; cancel only once both are waiting
+    ASSERT_EQ(waiting.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    board->cancelMoveFigure(second, {5, 5});
+    board->removeFigure(second);
+    EXPECT_EQ(done.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+
+    // one waiter per cell, the cancelled one leaves, the other gets the cell
+    EXPECT_EQ(board->statistic().waitDepth().count(), 2u);
+    EXPECT_EQ(board->statistic().waitDepth().snapshot().mMax, 1u);
+    EXPECT_EQ(board->statistic().waitCancelled().count(), 1u);
+    EXPECT_EQ(board->statistic().waitGranted().count(), 1u);
+
+    board->removeNotifier(notifier);
+    board->stopGame();
+}
+
+TEST(ChessBoardBlockingTest, slidersStopAtOccupiedCells)
+{
+    auto board = std::make_shared<ChessBoardImpl>(8, true);
+    auto notifier = std::make_shared<NiceMock<MockNotifier>>();
+    board->startGame();
+    board->addNotifier(notifier);
+
+    ChessManImpl rook(1, chessman::ChessmanType::rook), blocker(2, chessman::ChessmanType::rook),
+                 bishop(3, chessman::ChessmanType::bishop);
+    std::promise<void> done;
+    {
+        InSequence sequence;
+        EXPECT_CALL(*notifier, placed(1, Coordinate(0, 0)));
+        EXPECT_CALL(*notifier, placed(2, Coordinate(0, 3)));
+        EXPECT_CALL(*notifier, placed(3, Coordinate(2, 2)));
+        EXPECT_CALL(*notifier, reject(1, ReasonReject::pathBlocked));
+        EXPECT_CALL(*notifier, reject(1, ReasonReject::incorrectCoordinate));
+        EXPECT_CALL(*notifier, moved(1, Coordinate(0, 0), Coordinate(0, 2)));
+        EXPECT_CALL(*notifier, moved(3, Coordinate(2, 2), Coordinate(6, 6)))
+                .WillOnce(Invoke([&](std::uint32_t, const Coordinate &, const Coordinate &) {
+                    done.set_value();
+                }));
+    }
+    board->placeFigure(rook, {0, 0});
+    board->placeFigure(blocker, {0, 3});
+    board->placeFigure(bishop, {2, 2});
+    rook.setCurrentCoordinate({0, 0});
+    bishop.setCurrentCoordinate({2, 2});
+    board->moveFigure(rook, {0, 5});   // over the blocker
+    board->moveFigure(rook, {1, 1});   // not a rook move
+    board->moveFigure(rook, {0, 2});
+    board->moveFigure(bishop, {6, 6});
+    EXPECT_EQ(done.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+
+    // from {0, 2}: {0, 0} and {0, 1} behind, the blocker ahead, the whole column below
+    std::vector<Coordinate> destinations;
+    rook.setCurrentCoordinate({0, 2});
+    board->legalDestinations(rook, destinations);
+    EXPECT_EQ(destinations.size(), 9u);
+    EXPECT_EQ(std::count(destinations.begin(), destinations.end(), Coordinate(0, 3)), 0);
+
+    board->removeNotifier(notifier);
+    board->stopGame();
+}
+
+TEST(ChessBoardResetTest, resetEmptiesCellsWaitersAndIds)
+{
+    for (std::uint8_t size: {8, 16})
+    {
+        auto board = std::make_shared<ChessBoardImpl>(size);
+        auto notifier = std::make_shared<NiceMock<MockNotifier>>();
+        board->startGame();
+        board->addNotifier(notifier);
+
+        ChessManImpl first(1, chessman::ChessmanType::rook), second(2, chessman::ChessmanType::rook),
+                     third(3, chessman::ChessmanType::rook);
+        std::promise<void> waiting;
+        EXPECT_CALL(*notifier, waitingForCell(3, invalidCoordinate, Coordinate(0, 0)))
+                .WillOnce(Invoke([&](std::uint32_t, const Coordinate &, const Coordinate &) {
+                    waiting.set_value();
+                }));
+        board->placeFigure(first, {0, 0});
+        board->placeFigure(second, {1, 1});
+        board->placeFigure(third, {0, 0});
+        ASSERT_EQ(waiting.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+
+        board->reset();
+        std::vector<Coordinate> destinations;
+        first.setCurrentCoordinate({0, 5});
+        board->legalDestinations(first, destinations);
+        EXPECT_EQ(destinations.size(), 2u * (size - 1u));
+
+        // the same id again, the cell of the old waiter is free and nobody takes it over
+        std::promise<void> placed;
+        EXPECT_CALL(*notifier, placed(1, Coordinate(1, 1)))
+                .WillOnce(Invoke([&](std::uint32_t, const Coordinate &) {
+                    placed.set_value();
+                }));
+        EXPECT_CALL(*notifier, placed(3, _)).Times(0);
+        board->placeFigure(first, {1, 1});
+        EXPECT_EQ(placed.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+
+        board->removeNotifier(notifier);
+        board->stopGame();
+        EXPECT_THROW(board->reset(), std::logic_error);
+    }
+}
+
+TEST(ChessBoardOverloadTest, fullQueueRejectsPlaceAndMoveOnly)
+{
+    auto board = std::make_shared<ChessBoardImpl>(8, false, 2, ChessBoardImpl::OverloadPolicy::reject);
+    auto notifier = std::make_shared<NiceMock<MockNotifier>>();
+    board->startGame();
+    board->addNotifier(notifier);
+
+    // the board thread is held in the first notification, the next commands stay queued
+    std::promise<void> busy, release;
+    auto released = release.get_future().share();
+    EXPECT_CALL(*notifier, placed(1, _)).WillOnce(Invoke([&](std::uint32_t, const Coordinate &) {
+        busy.set_value();
+        released.wait();
+    }));
+    ChessManImpl first(1, chessman::ChessmanType::rook), second(2, chessman::ChessmanType::rook),
+                 third(3, chessman::ChessmanType::rook), fourth(4, chessman::ChessmanType::rook);
+    board->placeFigure(first, {0, 0});
+    ASSERT_EQ(busy.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    board->placeFigure(second, {1, 1});
+    board->placeFigure(third, {2, 2});
+
+    EXPECT_FALSE(board->tryPlaceFigure(fourth, {3, 3}));
+    EXPECT_CALL(*notifier, reject(4, ReasonReject::overloaded)).Times(Exactly(2));
+    board->placeFigure(fourth, {3, 3});
+    board->moveFigure(fourth, {3, 4});
+    Mock::VerifyAndClearExpectations(notifier.get());
+    first.setCurrentCoordinate({0, 0});
+    board->removeFigure(first);
+    EXPECT_EQ(board->queueHighWater(), 3u);
+
+    std::promise<void> removed;
+    EXPECT_CALL(*notifier, removed(1, Coordinate(0, 0))).WillOnce(Invoke([&](std::uint32_t, const Coordinate &) {
+        removed.set_value();
+    }));
+    release.set_value();
+    EXPECT_EQ(removed.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(board->statistic().rejectTime(ReasonReject::overloaded).snapshot().mCount, 2u);
+    EXPECT_EQ(board->statistic().queueDepth().snapshot().mMax, 3u);
+
+    board->removeNotifier(notifier);
+    board->stopGame();
+}
+
+TEST(ChessBoardOverloadTest, fullQueueBlocksTheProducer)
+{
+    auto board = std::make_shared<ChessBoardImpl>(8, false, 1, ChessBoardImpl::OverloadPolicy::block);
+    auto notifier = std::make_shared<NiceMock<MockNotifier>>();
+    board->startGame();
+    board->addNotifier(notifier);
+
+    std::promise<void> busy, release, placed;
+    auto released = release.get_future().share();
+    EXPECT_CALL(*notifier, placed(1, _)).WillOnce(Invoke([&](std::uint32_t, const Coordinate &) {
+        busy.set_value();
+        released.wait();
+    }));
+    EXPECT_CALL(*notifier, placed(2, Coordinate(1, 1)));
+    EXPECT_CALL(*notifier, placed(3, Coordinate(2, 2))).WillOnce(Invoke([&](std::uint32_t, const Coordinate &) {
+        placed.set_value();
+    }));
+    EXPECT_CALL(*notifier, reject(_, _)).Times(0);
+    ChessManImpl first(1, chessman::ChessmanType::rook), second(2, chessman::ChessmanType::rook),
+                 third(3, chessman::ChessmanType::rook);
+    board->placeFigure(first, {0, 0});
+    ASSERT_EQ(busy.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    board->placeFigure(second, {1, 1});
+
+    auto producer = std::async(std::launch::async, [&]() {
+        board->placeFigure(third, {2, 2});
+    });
+    EXPECT_EQ(producer.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+    release.set_value();
+    EXPECT_EQ(producer.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(placed.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(board->queueHighWater(), 1u);
+
+    board->removeNotifier(notifier);
+    board->stopGame();
+}
+
+TEST(ChessBoardDrainTest, cancelsAndRemovesOvertakePlacesAndMoves)
+{
+    using Policy = ChessBoardImpl::DrainPolicy;
+    struct Case { Policy mPolicy; std::vector<std::uint32_t> mOrder; };
+    // queued behind the held place of figure 1: places of 2, 3, 4, then removes of 5, 6, 7 that
+    // are rejected for figures not on the board
+    for (auto &[policy, order]: {Case{Policy::fifo, {2, 3, 4, 5, 6, 7}},
+                                 Case{Policy::strict, {5, 6, 7, 2, 3, 4}},
+                                 Case{Policy::weighted, {5, 6, 2, 7, 3, 4}}})
+    {
+        auto board = std::make_shared<ChessBoardImpl>(8);
+        board->setDrainPolicy(policy, 2);
+        auto notifier = std::make_shared<NiceMock<MockNotifier>>();
+        board->startGame();
+        board->addNotifier(notifier);
+
+        std::promise<void> busy, release, done;
+        auto released = release.get_future().share();
+        std::vector<std::uint32_t> answered;
+        auto answer = [&](std::uint32_t id) {
+            answered.push_back(id);
+            if (answered.size() == order.size())
+            {
+                done.set_value();
+            }
+        };
+        ON_CALL(*notifier, placed(_, _)).WillByDefault(Invoke([&](std::uint32_t id, const Coordinate &) {
+            if (id == 1)
+            {
+                busy.set_value();
+                released.wait();
+            } else {
+                answer(id);
+            }
+        }));
+        ON_CALL(*notifier, reject(_, _)).WillByDefault(Invoke([&](std::uint32_t id, ReasonReject) {
+            answer(id);
+        }));
+        std::vector<std::unique_ptr<ChessManImpl>> figures;
+        for (std::uint32_t id = 1; id <= 7; ++id)
+        {
+            figures.push_back(std::make_unique<ChessManImpl>(id, chessman::ChessmanType::rook));
+        }
+        board->placeFigure(*figures[0], {0, 0});
+        ASSERT_EQ(busy.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+        for (std::uint32_t i = 1; i < 4; ++i)
+        {
+            board->placeFigure(*figures[i], {static_cast<Coordinate::first_type>(i), 0});
+        }
+        for (std::uint32_t i = 4; i < 7; ++i)
+        {
+            figures[i]->setCurrentCoordinate({7, 7});
+            board->removeFigure(*figures[i]);
+        }
+        release.set_value();
+        ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+        board->removeNotifier(notifier);
+        board->stopGame();
+        EXPECT_EQ(answered, order);
+    }
+}
+
+TEST(ChessBoardCoalesceTest, cancelAndRemoveDropQueuedMoves)
+{
+    auto board = std::make_shared<ChessBoardImpl>(8);
+    auto notifier = std::make_shared<NiceMock<MockNotifier>>();
+    board->startGame();
+    board->addNotifier(notifier);
+
+    ChessManImpl first(1, chessman::ChessmanType::rook), second(2, chessman::ChessmanType::rook),
+                 third(3, chessman::ChessmanType::rook);
+    std::promise<void> placed, busy, release, cancelled, removed;
+    auto released = release.get_future().share();
+    EXPECT_CALL(*notifier, placed(2, Coordinate(1, 1)));
+    EXPECT_CALL(*notifier, placed(3, Coordinate(2, 2))).WillOnce(Invoke([&](std::uint32_t, const Coordinate &) {
+        placed.set_value();
+    }));
+    EXPECT_CALL(*notifier, placed(1, _)).WillOnce(Invoke([&](std::uint32_t, const Coordinate &) {
+        busy.set_value();
+        released.wait();
+    }));
+    EXPECT_CALL(*notifier, moved(_, _, _)).Times(0);
+    EXPECT_CALL(*notifier, waitingForCell(_, _, _)).Times(0);
+    EXPECT_CALL(*notifier, cancelMoved(2, Coordinate(1, 1), Coordinate(1, 2)))
+            .WillOnce(Invoke([&](std::uint32_t, const Coordinate &, const Coordinate &) {
+                cancelled.set_value();
+            }));
+    EXPECT_CALL(*notifier, removed(3, Coordinate(2, 2))).WillOnce(Invoke([&](std::uint32_t, const Coordinate &) {
+        removed.set_value();
+    }));
+
+    board->placeFigure(second, {1, 1});
+    board->placeFigure(third, {2, 2});
+    ASSERT_EQ(placed.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    second.setCurrentCoordinate({1, 1});
+    third.setCurrentCoordinate({2, 2});
+    board->placeFigure(first, {0, 0});
+    ASSERT_EQ(busy.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+
+    board->moveFigure(second, {1, 2});
+    board->cancelMoveFigure(second, {1, 2});
+    board->moveFigure(third, {2, 3});
+    board->moveFigure(third, {2, 4});
+    board->removeFigure(third);
+    release.set_value();
+    EXPECT_EQ(cancelled.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(removed.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_EQ(board->statistic().coalesced(), 3u);
+
+    board->removeNotifier(notifier);
+    board->stopGame();
+}
+
+TEST(ChessBoardBatchTest, drainedBatchArrivesInOneCall)
+{
+    class BatchNotifier: public INotifier {
+    public:
+        void placed(std::uint32_t, const Coordinate &) noexcept override {}
+        void moved(std::uint32_t, const Coordinate &, const Coordinate &) noexcept override {}
+        void cancelMoved(std::uint32_t, const Coordinate &, const Coordinate &) noexcept override {}
+        void removed(std::uint32_t, const Coordinate &) noexcept override {}
+        void waitingForCell(std::uint32_t, const Coordinate &, const Coordinate &) noexcept override {}
+        void reject(std::uint32_t, ReasonReject) noexcept override {}
+
+        void onEvents(const BoardEvent *events, std::size_t count) noexcept override
+        {
+            mBatches.emplace_back(events, events + count);
+            if (mBatches.size() == 1)
+            {
+                mBusy.set_value();
+                mReleased.wait();
+            } else {
+                mDone.set_value();
+            }
+        }
+
+        std::vector<std::vector<BoardEvent>> mBatches;
+        std::promise<void> mBusy, mRelease, mDone;
+        std::shared_future<void> mReleased = mRelease.get_future().share();
+    };
+
+    auto board = std::make_shared<ChessBoardImpl>(8);
+    auto notifier = std::make_shared<BatchNotifier>();
+    auto single = std::make_shared<NiceMock<MockNotifier>>();
+    board->startGame();
+    board->addNotifier(notifier);
+    board->addNotifier(single);
+    EXPECT_CALL(*single, placed(_, _)).Times(4);
+    EXPECT_CALL(*single, reject(2, ReasonReject::duplicateId));
+
+    ChessManImpl first(1, chessman::ChessmanType::rook), second(2, chessman::ChessmanType::rook),
+                 third(3, chessman::ChessmanType::rook), fourth(4, chessman::ChessmanType::rook);
+    board->placeFigure(first, {0, 0});
+    ASSERT_EQ(notifier->mBusy.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    board->placeFigure(second, {1, 0});
+    board->placeFigure(third, {2, 0});
+    board->placeFigure(fourth, {3, 0});
+    board->placeFigure(second, {4, 0});
+    notifier->mRelease.set_value();
+    ASSERT_EQ(notifier->mDone.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    board->removeNotifier(notifier);
+    board->removeNotifier(single);
+    board->stopGame();
+
+    ASSERT_EQ(notifier->mBatches.size(), 2u);
+    ASSERT_EQ(notifier->mBatches[1].size(), 4u);
+    std::vector<std::uint32_t> ids;
+    for (auto &event: notifier->mBatches[1])
+    {
+        ids.push_back(event.mId);
+    }
+    EXPECT_EQ(ids, (std::vector<std::uint32_t>{2, 3, 4, 2}));
+    EXPECT_EQ(notifier->mBatches[1][2].mType, BoardEvent::Type::placed);
+    EXPECT_EQ(notifier->mBatches[1][2].mTo, Coordinate(3, 0));
+    EXPECT_EQ(notifier->mBatches[1][3].mType, BoardEvent::Type::reject);
+    EXPECT_EQ(notifier->mBatches[1][3].mReason, ReasonReject::duplicateId);
+}
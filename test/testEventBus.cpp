@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "EventBus.h"
+
+using namespace board;
+
+class EventBusTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        mName = "chess_bus_" + std::to_string(::getpid());
+    }
+
+    std::string mName;
+};
+
+TEST_F(EventBusTest, readerGetsEventsInOrder)
+{
+    EventBus bus(mName, 16);
+    EventBusReader reader(mName);
+    INotifier &notifier = bus;
+    notifier.placed(1, {0, 0});
+    BoardEvent batch[] = {
+        {2, BoardEvent::Type::moved, ReasonReject::empty, {1, 2}, {1, 5}},
+        {3, BoardEvent::Type::reject, ReasonReject::pathBlocked, invalidCoordinate, invalidCoordinate},
+    };
+    notifier.onEvents(batch, 2);
+
+    eventbus::Record records[8];
+    ASSERT_EQ(reader.poll(records, 8), 3u);
+    EXPECT_EQ(reader.poll(records + 3, 5), 0u);
+    EXPECT_EQ(records[0].mSequence, 0u);
+    EXPECT_EQ(records[0].mEvent.mType, BoardEvent::Type::placed);
+    EXPECT_EQ(records[0].mEvent.mTo, Coordinate(0, 0));
+    EXPECT_EQ(records[0].mEvent.mFrom, invalidCoordinate);
+    EXPECT_EQ(records[1].mEvent.mId, 2u);
+    EXPECT_EQ(records[1].mEvent.mFrom, Coordinate(1, 2));
+    EXPECT_EQ(records[1].mEvent.mTo, Coordinate(1, 5));
+    EXPECT_EQ(records[2].mEvent.mReason, ReasonReject::pathBlocked);
+    EXPECT_LE(records[1].mPublished, records[2].mPublished);
+    EXPECT_EQ(reader.next(), 3u);
+    EXPECT_EQ(reader.lost(), 0u);
+    EXPECT_EQ(bus.published(), 3u);
+}
+
+TEST_F(EventBusTest, laggingReaderSkipsOverwrittenEvents)
+{
+    EventBus bus(mName, 8);
+    EventBusReader reader(mName);
+    for (std::uint32_t id = 0; id < 20; ++id)
+    {
+        bus.placed(id, {0, 0});
+    }
+    EventBusReader late(mName, true);
+
+    eventbus::Record records[32];
+    ASSERT_EQ(reader.poll(records, 32), 8u);
+    EXPECT_EQ(records[0].mSequence, 12u);
+    EXPECT_EQ(records[7].mEvent.mId, 19u);
+    EXPECT_EQ(reader.lost(), 12u);
+    EXPECT_EQ(late.poll(records, 32), 8u);
+    EXPECT_EQ(late.lost(), 0u);
+}
+
+TEST_F(EventBusTest, concurrentReaderSeesConsistentEvents)
+{
+    static constexpr std::uint32_t count = 200000;
+    EventBus bus(mName, 256);
+    EventBusReader reader(mName);
+    std::thread writer([&bus]() {
+        for (std::uint32_t id = 0; id < count; ++id)
+        {
+            bus.moved(id, {static_cast<std::int8_t>(id & 7u), 0}, {static_cast<std::int8_t>(id & 7u), 1});
+        }
+    });
+    eventbus::Record records[64];
+    std::uint64_t received = 0;
+    std::uint64_t last = 0;
+    auto consistent = true;
+    while (reader.next() < count)
+    {
+        auto polled = reader.poll(records, 64);
+        for (std::size_t i = 0; i < polled; ++i)
+        {
+            auto &record = records[i];
+            consistent = consistent && record.mEvent.mId == record.mSequence
+                         && record.mEvent.mFrom.first == static_cast<std::int8_t>(record.mSequence & 7u)
+                         && record.mEvent.mTo.second == 1 && (!received || record.mSequence > last);
+            last = record.mSequence;
+            ++received;
+        }
+    }
+    writer.join();
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(received + reader.lost(), count);
+}
+
+TEST_F(EventBusTest, newBusLeavesTheOldSegmentToItsReaders)
+{
+    auto bus = std::make_unique<EventBus>(mName, 8);
+    EventBusReader old(mName, true);
+    bus->placed(1, {0, 0});
+    bus->placed(2, {0, 1});
+
+    // the old segment stays intact for its reader, a new reader gets the new one
+    EventBus replacement(mName, 16);
+    EventBusReader fresh(mName, true);
+    eventbus::Record records[8];
+    ASSERT_EQ(old.poll(records, 8), 2u);
+    EXPECT_EQ(records[1].mEvent.mId, 2u);
+    EXPECT_EQ(old.capacity(), 8u);
+    replacement.placed(3, {1, 1});
+    EXPECT_EQ(old.poll(records, 8), 0u);
+    ASSERT_EQ(fresh.poll(records, 8), 1u);
+    EXPECT_EQ(records[0].mEvent.mId, 3u);
+    EXPECT_EQ(fresh.capacity(), 16u);
+
+    // the name belongs to the replacement now, the old bus leaves it linked
+    bus.reset();
+    EXPECT_NO_THROW(EventBusReader{mName});
+}
+
+TEST_F(EventBusTest, rejectsBadCapacityAndMissingSegment)
+{
+    EXPECT_THROW(EventBus(mName, 100), std::invalid_argument);
+    EXPECT_THROW(EventBusReader(mName + "_missing"), std::system_error);
+}
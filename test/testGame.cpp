@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "ChessBoardImpl.h"
+#include "Game.h"
+
+static GameSettings reusableSettings()
+{
+    GameSettings settings;
+    settings.mRules.mDelayNextStepMin = std::chrono::milliseconds(0);
+    settings.mRules.mDelayNextStepMax = std::chrono::milliseconds(1);
+    settings.mRules.mDelayWaitForCell = std::chrono::milliseconds(20);
+    settings.mLogEnabled = false;
+    settings.mDumpStatistic = false;
+    settings.mReusable = true;
+    return settings;
+}
+
+TEST(GameTest, reusableGamePlaysBackToBackOnTheSameBoard)
+{
+    Game game(6, 10, reusableSettings());
+    std::shared_ptr<const ChessBoardImpl> board;
+    for (int round = 1; round <= 5; ++round)
+    {
+        game.startGame();
+        game.waitEnd();
+        if (!board)
+        {
+            board = game.board();
+        }
+        EXPECT_EQ(game.board(), board);
+        // the statistic keeps counting over the games
+        EXPECT_EQ(board->statistic().outcomeTime(BoardStatistic::Outcome::moved).count(), round * 6u * 10u);
+        EXPECT_EQ(board->statistic().outcomeTime(BoardStatistic::Outcome::removed).count(), round * 6u);
+    }
+    game.stopGame();
+    GameRules::configure({});
+}
+
+TEST(GameTest, reusableGameStopsParkedOrRunning)
+{
+    {
+        Game game(4, 5, reusableSettings());
+        game.startGame();
+        game.waitEnd();
+        // parked participants leave without another end barrier
+    }
+    {
+        auto settings = reusableSettings();
+        settings.mRules.mDelayNextStepMin = std::chrono::milliseconds(2);
+        settings.mRules.mDelayNextStepMax = std::chrono::milliseconds(4);
+        Game game(4, 20, settings);
+        game.startGame();
+        game.waitEnd();
+        game.startGame();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        game.stopGame();
+        EXPECT_LT(game.board()->statistic().outcomeTime(BoardStatistic::Outcome::moved).count(), 2u * 4u * 20u);
+    }
+    GameRules::configure({});
+}
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <map>
+#include <set>
+
 #include "ChessManImpl.h"
+#include "FastRandom.h"
 #include "GameRules.h"
 
 
@@ -17,6 +21,9 @@ TEST(GameRulesTest, checkStepRook) {
 
 TEST(GameRulesTest, generateStepStepRook)
 {
+    GameRules::Settings settings;
+    settings.mSizeBoard = 16; // {10, 7} is on the board
+    GameRules::Scope scope(settings);
     auto mChess = std::make_shared<ChessManImpl>(30, chessman::ChessmanType::rook);
     mChess->setCurrentCoordinate({10, 7});
 
@@ -25,3 +32,155 @@ TEST(GameRulesTest, generateStepStepRook)
         EXPECT_TRUE(GameRules::checkStep(mChess, coordinate));
     }
 }
+
+TEST(GameRulesTest, uniformStepCoversLineForEveryEngine)
+{
+    for (auto engine: {RandomEngine::mt19937, RandomEngine::xoshiro256, RandomEngine::pcg32})
+    {
+        GameRules::Settings settings;
+        settings.mRandomEngine = engine;
+        GameRules::configure(settings);
+
+        std::map<board::Coordinate, std::size_t> visits;
+        for (size_t i = 0; i < 14000; i++) {
+            ++visits[GameRules::generateUniformStep(chessman::ChessmanType::rook, {3, 5})];
+        }
+        // 7 cells of row 3 and 7 cells of column 5, never {3, 5} itself
+        EXPECT_EQ(visits.size(), 14u);
+        EXPECT_EQ(visits.count(board::Coordinate(3, 5)), 0u);
+        for (auto &[coordinate, count]: visits)
+        {
+            EXPECT_TRUE(coordinate.first == 3 || coordinate.second == 5);
+            EXPECT_GT(count, 800u);
+            EXPECT_LT(count, 1200u);
+        }
+    }
+    GameRules::configure({});
+}
+
+TEST(GameRulesTest, firstStepAndDelayStayInRange)
+{
+    GameRules::Settings settings;
+    settings.mSizeBoard = 3;
+    settings.mDelayNextStepMin = std::chrono::milliseconds(10);
+    settings.mDelayNextStepMax = std::chrono::milliseconds(12);
+    settings.mRandomEngine = RandomEngine::pcg32;
+    GameRules::configure(settings);
+
+    std::set<board::Coordinate> cells;
+    std::set<std::chrono::milliseconds::rep> delays;
+    for (size_t i = 0; i < 1000; i++) {
+        cells.insert(GameRules::generateFirstStep());
+        delays.insert(GameRules::generateDelayWaitNextStep().count());
+    }
+    EXPECT_EQ(cells.size(), 9u);
+    EXPECT_EQ(*cells.rbegin(), board::Coordinate(2, 2));
+    EXPECT_EQ(delays, (std::set<std::chrono::milliseconds::rep>{10, 11, 12}));
+    GameRules::configure({});
+}
+
+TEST(GameRulesTest, boundedRandomIsUnbiased)
+{
+    Xoshiro256 engine(42);
+    std::vector<std::size_t> counts(6);
+    for (size_t i = 0; i < 60000; i++) {
+        ++counts[boundedRandom(engine, 6)];
+    }
+    for (auto count: counts) {
+        EXPECT_GT(count, 9500u);
+        EXPECT_LT(count, 10500u);
+    }
+    EXPECT_EQ(boundedRandom(engine, 1), 0u);
+
+    Pcg32 pcg(7);
+    for (size_t i = 0; i < 1000; i++) {
+        auto unit = unitRandom(pcg);
+        EXPECT_GE(unit, 0.0);
+        EXPECT_LT(unit, 1.0);
+    }
+}
+
+TEST(GameRulesTest, checkStepPieces)
+{
+    using chessman::ChessmanType;
+    board::Coordinate from{3, 3};
+    EXPECT_TRUE(GameRules::checkStep(ChessmanType::bishop, from, {0, 6}));
+    EXPECT_FALSE(GameRules::checkStep(ChessmanType::bishop, from, {3, 6}));
+    EXPECT_TRUE(GameRules::checkStep(ChessmanType::queen, from, {7, 7}));
+    EXPECT_TRUE(GameRules::checkStep(ChessmanType::queen, from, {3, 0}));
+    EXPECT_FALSE(GameRules::checkStep(ChessmanType::queen, from, {4, 5}));
+    EXPECT_TRUE(GameRules::checkStep(ChessmanType::knight, from, {4, 5}));
+    EXPECT_TRUE(GameRules::checkStep(ChessmanType::knight, from, {1, 2}));
+    EXPECT_FALSE(GameRules::checkStep(ChessmanType::knight, from, {5, 5}));
+    EXPECT_TRUE(GameRules::checkStep(ChessmanType::king, from, {2, 4}));
+    EXPECT_FALSE(GameRules::checkStep(ChessmanType::king, from, {3, 5}));
+    EXPECT_FALSE(GameRules::checkStep(ChessmanType::king, from, from));
+}
+
+TEST(GameRulesTest, checkStepStaysOnTheBoard)
+{
+    using chessman::ChessmanType;
+    GameRules::Settings settings;
+    settings.mSizeBoard = 8;
+    GameRules::Scope scope(settings);
+
+    EXPECT_TRUE(GameRules::checkStep(ChessmanType::knight, {6, 6}, {7, 4}));
+    EXPECT_FALSE(GameRules::checkStep(ChessmanType::knight, {6, 6}, {8, 7}));
+    EXPECT_FALSE(GameRules::checkStep(ChessmanType::knight, {6, 6}, {7, 8}));
+    EXPECT_TRUE(GameRules::checkStep(ChessmanType::king, {7, 7}, {6, 6}));
+    EXPECT_FALSE(GameRules::checkStep(ChessmanType::king, {7, 7}, {8, 8}));
+    EXPECT_FALSE(GameRules::checkStep(ChessmanType::rook, {7, 0}, {8, 0}));
+}
+
+TEST(GameRulesTest, uniformStepReachesEveryLegalTarget)
+{
+    using chessman::ChessmanType;
+    for (std::int32_t size: {4, 5, 8})
+    {
+        GameRules::Settings settings;
+        settings.mSizeBoard = size;
+        GameRules::configure(settings);
+        for (auto type: {ChessmanType::rook, ChessmanType::bishop, ChessmanType::queen, ChessmanType::knight, ChessmanType::king})
+        {
+            for (std::int8_t x = 0; x < size; ++x)
+            {
+                for (std::int8_t y = 0; y < size; ++y)
+                {
+                    board::Coordinate from{x, y};
+                    std::set<board::Coordinate> legal;
+                    for (std::int8_t tx = 0; tx < size; ++tx)
+                    {
+                        for (std::int8_t ty = 0; ty < size; ++ty)
+                        {
+                            if (GameRules::checkStep(type, from, {tx, ty}))
+                            {
+                                legal.insert({tx, ty});
+                            }
+                        }
+                    }
+                    std::set<board::Coordinate> reached;
+                    for (size_t i = 0; i < 40 * legal.size(); i++) {
+                        auto to = GameRules::generateUniformStep(type, from);
+                        ASSERT_TRUE(legal.count(to)) << static_cast<int>(type) << " from " << int(x) << "," << int(y);
+                        reached.insert(to);
+                    }
+                    EXPECT_EQ(reached, legal);
+                }
+            }
+        }
+    }
+    GameRules::configure({});
+}
+
+TEST(GameRulesTest, configureRejectsPiecesWithoutMoves)
+{
+    GameRules::Settings settings;
+    settings.mSizeBoard = 3;
+    settings.mPieces = {chessman::ChessmanType::king, chessman::ChessmanType::knight};
+    EXPECT_THROW(GameRules::configure(settings), std::invalid_argument);
+    settings.mPieces.clear();
+    EXPECT_THROW(GameRules::configure(settings), std::invalid_argument);
+    settings.mPieces = {chessman::ChessmanType::king};
+    EXPECT_NO_THROW(GameRules::configure(settings));
+    GameRules::configure({});
+}
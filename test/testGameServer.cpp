@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <vector>
+
+#include "Executor.h"
+#include "GameServer.h"
+
+using namespace std::chrono_literals;
+
+TEST(ExecutorTest, timersFireInDeadlineOrder)
+{
+    Executor executor(2);
+    std::mutex mutex;
+    std::vector<int> fired;
+    std::promise<void> done;
+    for (auto delay: {30, 10, 20})
+    {
+        executor.postAfter(std::chrono::milliseconds(delay), [&, delay]() {
+            std::lock_guard lock(mutex);
+            fired.push_back(delay);
+            if (fired.size() == 3)
+            {
+                done.set_value();
+            }
+        });
+    }
+    ASSERT_EQ(done.get_future().wait_for(1s), std::future_status::ready);
+    EXPECT_EQ(fired, (std::vector<int>{10, 20, 30}));
+}
+
+TEST(ExecutorTest, cancelledTimersDoNotFireOrPileUp)
+{
+    Executor executor(1);
+    std::atomic<int> fired{0};
+    auto timer = executor.postAfter(10ms, [&]() {
+        fired += 100;
+    });
+    // a participant re-arming its timeout on every event
+    for (int i = 0; i < 1000; ++i)
+    {
+        executor.cancel(timer);
+        timer = executor.postAfter(1h, [&]() {
+            ++fired;
+        });
+    }
+    EXPECT_LE(executor.pendingTimers(), 3u);
+    std::promise<void> done;
+    executor.cancel(timer);
+    executor.postAfter(20ms, [&]() {
+        done.set_value();
+    });
+    ASSERT_EQ(done.get_future().wait_for(1s), std::future_status::ready);
+    EXPECT_EQ(fired, 0);
+}
+
+TEST(ExecutorTest, strandRunsTasksOneAtATimeInOrder)
+{
+    Executor executor(4);
+    auto strand = std::make_shared<Strand>(executor);
+    std::atomic<int> inside{0};
+    std::vector<int> order; // unsynchronised on purpose, the strand serialises the tasks
+    std::promise<void> done;
+    static constexpr int sTasks = 1000;
+    for (int i = 0; i < sTasks; ++i)
+    {
+        strand->post([&, i]() {
+            EXPECT_EQ(inside.fetch_add(1), 0);
+            order.push_back(i);
+            inside.fetch_sub(1);
+            if (i == sTasks - 1)
+            {
+                done.set_value();
+            }
+        });
+    }
+    ASSERT_EQ(done.get_future().wait_for(2s), std::future_status::ready);
+    ASSERT_EQ(order.size(), static_cast<std::size_t>(sTasks));
+    for (int i = 0; i < sTasks; ++i)
+    {
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+static GameServerSettings fastSettings()
+{
+    GameServerSettings settings;
+    settings.mThreads = 2;
+    settings.mRules.mDelayNextStepMin = 0ms;
+    settings.mRules.mDelayNextStepMax = 0ms;
+    settings.mRules.mDelayWaitForCell = 2ms;
+    settings.mRules.mDelayConfirm = 1000ms;
+    return settings;
+}
+
+TEST(GameServerTest, hostsManyGamesOnFewThreads)
+{
+    static constexpr std::size_t sGames = 50, sParticipants = 4, sSteps = 10;
+    {
+        GameServer server(fastSettings());
+        for (std::size_t i = 0; i < sGames; ++i)
+        {
+            EXPECT_NE(server.startGame(sParticipants, sSteps), 0u);
+        }
+        server.waitIdle();
+        EXPECT_EQ(server.runningGames(), 0u);
+
+        auto finished = server.takeFinished();
+        ASSERT_EQ(finished.size(), sGames);
+        for (auto &stats: finished)
+        {
+            EXPECT_FALSE(stats.mFailed);
+            EXPECT_EQ(stats.mMoves, sParticipants * sSteps);
+            EXPECT_GT(stats.mBusyTime.count(), 0);
+        }
+        EXPECT_EQ(server.statistic().outcomeTime(BoardStatistic::Outcome::moved).count(), sGames * sParticipants * sSteps);
+        EXPECT_TRUE(server.takeFinished().empty());
+    }
+    GameRules::configure({});
+}
+
+TEST(GameServerTest, admissionControlRefusesGamesOverTheLimit)
+{
+    auto settings = fastSettings();
+    settings.mRules.mDelayNextStepMin = 10s;   // the games stay running
+    settings.mRules.mDelayNextStepMax = 10s;
+    settings.mMaxGames = 2;
+    settings.mMaxParticipants = 5;
+    {
+        GameServer server(settings);
+        EXPECT_NE(server.startGame(2, 100), 0u);
+        EXPECT_EQ(server.startGame(4, 100), 0u);   // too many participants
+        EXPECT_NE(server.startGame(3, 100), 0u);
+        EXPECT_EQ(server.startGame(1, 100), 0u);   // too many games
+        EXPECT_EQ(server.refusedGames(), 2u);
+        EXPECT_EQ(server.runningGames(), 2u);
+        EXPECT_THROW(server.startGame(64, 1), std::invalid_argument);
+
+        server.stopAll();
+        server.waitIdle();
+        EXPECT_EQ(server.takeFinished().size(), 2u);
+    }
+    GameRules::configure({});
+}
+
+TEST(GameServerTest, serversKeepTheirOwnRules)
+{
+    auto small = fastSettings();
+    small.mRules.mSizeBoard = 3;
+    small.mRules.mPieces = {chessman::ChessmanType::king};
+    auto large = fastSettings();
+    large.mRules.mSizeBoard = 16;
+    {
+        GameServer smallServer(small);
+        GameServer largeServer(large);
+        EXPECT_EQ(GameRules::settings().mSizeBoard, 8);
+        EXPECT_THROW(smallServer.startGame(9, 1), std::invalid_argument);
+        // more figures than an 8x8 board holds, placed by the rules of their own server
+        EXPECT_NE(largeServer.startGame(100, 5), 0u);
+        EXPECT_NE(smallServer.startGame(4, 5), 0u);
+        largeServer.waitIdle();
+        smallServer.waitIdle();
+
+        auto finished = largeServer.takeFinished();
+        ASSERT_EQ(finished.size(), 1u);
+        EXPECT_FALSE(finished.front().mFailed);
+        EXPECT_EQ(finished.front().mMoves, 100u * 5u);
+        finished = smallServer.takeFinished();
+        ASSERT_EQ(finished.size(), 1u);
+        EXPECT_FALSE(finished.front().mFailed);
+        EXPECT_EQ(finished.front().mMoves, 4u * 5u);
+    }
+    EXPECT_EQ(GameRules::settings().mSizeBoard, 8);
+}
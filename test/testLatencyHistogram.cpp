@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include "LatencyHistogram.h"
+
+// the documented bound: a percentile overstates by less than the width of its bucket
+static constexpr double sTolerance = 1.0 / 64;
+
+TEST(LatencyHistogramTest, empty)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.percentile(0.5), 0);
+    EXPECT_EQ(histogram.snapshot().mMax, 0);
+}
+
+TEST(LatencyHistogramTest, exactSmallValues)
+{
+    LatencyHistogram histogram;
+    for (std::uint64_t value = 1; value <= 100; ++value)
+    {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.count(), 100);
+    EXPECT_EQ(histogram.percentile(0.5), 50);
+    EXPECT_EQ(histogram.percentile(0.99), 99);
+    EXPECT_EQ(histogram.percentile(1.0), 100);
+    EXPECT_EQ(histogram.snapshot().mMean, 50);
+}
+
+TEST(LatencyHistogramTest, relativeError)
+{
+    LatencyHistogram histogram;
+    for (std::uint64_t value = 1000; value <= 1000000; value += 1000)
+    {
+        histogram.record(value);
+    }
+    auto snapshot = histogram.snapshot();
+    EXPECT_NEAR(static_cast<double>(snapshot.mP50), 500000.0, 500000.0 * sTolerance);
+    EXPECT_NEAR(static_cast<double>(snapshot.mP99), 990000.0, 990000.0 * sTolerance);
+    EXPECT_NEAR(static_cast<double>(snapshot.mP999), 999000.0, 999000.0 * sTolerance);
+    EXPECT_EQ(snapshot.mMax, 1000000);
+}
+
+TEST(LatencyHistogramTest, clampAndReset)
+{
+    using namespace std::chrono;
+    LatencyHistogram histogram;
+    histogram.record(hours(24));
+    histogram.record(nanoseconds(-5));
+    EXPECT_EQ(histogram.count(), 2);
+    EXPECT_EQ(histogram.percentile(0.0), 0);
+    EXPECT_GT(histogram.percentile(1.0), 0);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.percentile(1.0), 0);
+}
+
+TEST(LatencyHistogramTest, merge)
+{
+    LatencyHistogram first, second;
+    for (std::uint64_t value = 1; value <= 100; ++value)
+    {
+        (value % 2 ? first : second).record(value * 1000);
+    }
+    first.merge(second);
+    auto snapshot = first.snapshot();
+    EXPECT_EQ(snapshot.mCount, 100);
+    EXPECT_EQ(first.sum(), 5050 * 1000);
+    EXPECT_EQ(snapshot.mMax, 100000);
+    EXPECT_NEAR(static_cast<double>(snapshot.mP50), 50000.0, 50000.0 * sTolerance);
+    EXPECT_EQ(second.count(), 50);
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "ChessBoardImpl.h"
+#include "IChessMan.h"
+#include "LoadGenerator.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// answers every command synchronously after a fixed service time
+class SlowBoard : public board::IChessBoard
+{
+public:
+    explicit SlowBoard(std::chrono::microseconds serviceTime)
+        : mServiceTime(serviceTime)
+    {
+
+    }
+
+    void addNotifier(std::shared_ptr<board::INotifier> notifier) override { mNotifier = std::move(notifier); }
+    void removeNotifier(std::shared_ptr<board::INotifier>) override { mNotifier.reset(); }
+
+    void placeFigure(const chessman::IChessMan &figure, const board::Coordinate &to) override
+    {
+        mNotifier->placed(figure.getID(), to);
+    }
+
+    void moveFigure(const chessman::IChessMan &figure, const board::Coordinate &to) override
+    {
+        std::this_thread::sleep_for(mServiceTime);
+        mNotifier->moved(figure.getID(), figure.getCurrentCoordinate(), to);
+    }
+
+    void cancelMoveFigure(const chessman::IChessMan &figure, const board::Coordinate &to) override
+    {
+        mNotifier->cancelMoved(figure.getID(), figure.getCurrentCoordinate(), to);
+    }
+
+    void removeFigure(const chessman::IChessMan &figure) override
+    {
+        mNotifier->removed(figure.getID(), figure.getCurrentCoordinate());
+    }
+
+    std::uint8_t sizeBoard() const noexcept override { return 8; }
+    void legalDestinations(const chessman::IChessMan &, std::vector<board::Coordinate> &destinations) const override
+    {
+        destinations.clear();
+    }
+    bool sampleDestination(const chessman::IChessMan &, std::uint32_t, board::Coordinate &) const override
+    {
+        return false;
+    }
+
+protected:
+    const std::chrono::microseconds mServiceTime;
+    std::shared_ptr<board::INotifier> mNotifier;
+};
+
+// queues every placement as a waiter of an occupied cell, it is never placed
+class OccupiedBoard : public SlowBoard
+{
+public:
+    OccupiedBoard()
+        : SlowBoard(std::chrono::microseconds(0))
+    {
+
+    }
+
+    void placeFigure(const chessman::IChessMan &figure, const board::Coordinate &to) override
+    {
+        mNotifier->waitingForCell(figure.getID(), board::invalidCoordinate, to);
+    }
+};
+
+}
+
+TEST(LoadGeneratorTest, latencyFromIntendedTime)
+{
+    OpenLoopSettings settings;
+    settings.mRate = 1000;
+    settings.mFigures = 1;
+    settings.mDuration = 100ms;
+    auto generator = std::make_shared<LoadGenerator>(std::make_shared<SlowBoard>(2ms), settings);
+    generator->startGame();
+    generator->waitEnd();
+
+    auto counters = generator->counters();
+    EXPECT_GE(counters.mScheduled, 95u);
+    EXPECT_LE(counters.mScheduled, 101u);
+    EXPECT_EQ(counters.mIssued, counters.mScheduled);
+    EXPECT_EQ(counters.mCompleted, counters.mScheduled);
+    EXPECT_EQ(generator->latency().count(), counters.mCompleted);
+    EXPECT_GT(counters.mMaxBacklog, 10u);
+
+    // twice the capacity: the last arrivals queue for ~100ms while each move takes 2ms
+    EXPECT_GT(generator->latency().snapshot().mMax, std::chrono::nanoseconds(40ms).count());
+    EXPECT_LT(generator->serviceLatency().percentile(0.5), std::chrono::nanoseconds(20ms).count());
+}
+
+TEST(LoadGeneratorTest, poissonOnBoard)
+{
+    auto board = std::make_shared<ChessBoardImpl>(8);
+    board->startGame();
+
+    OpenLoopSettings settings;
+    settings.mArrival = ArrivalProcess::poisson;
+    settings.mRate = 2000;
+    settings.mFigures = 16;
+    settings.mDuration = 100ms;
+    auto generator = std::make_shared<LoadGenerator>(board, settings);
+    generator->startGame();
+    generator->waitEnd();
+    board->stopGame();
+
+    auto counters = generator->counters();
+    EXPECT_GT(counters.mScheduled, 100u);
+    EXPECT_EQ(counters.mIssued, counters.mScheduled);
+    EXPECT_EQ(counters.mCompleted, counters.mIssued);
+    EXPECT_EQ(counters.mMoved + counters.mCancelled + counters.mRejected, counters.mCompleted);
+    EXPECT_EQ(counters.mRejected, 0u);
+    EXPECT_EQ(board->statistic().outcomeTime(BoardStatistic::Outcome::removed).count(), settings.mFigures);
+}
+
+TEST(LoadGeneratorTest, overloadedPlacementsAreRetried)
+{
+    auto board = std::make_shared<ChessBoardImpl>(8, false, 1, ChessBoardImpl::OverloadPolicy::reject);
+    board->startGame();
+
+    OpenLoopSettings settings;
+    settings.mRate = 1000;
+    settings.mFigures = 32;
+    settings.mDuration = 100ms;
+    auto generator = std::make_shared<LoadGenerator>(board, settings);
+    auto started = std::chrono::steady_clock::now();
+    generator->startGame();
+    generator->waitEnd();
+    board->stopGame();
+
+    EXPECT_LT(std::chrono::steady_clock::now() - started, 2s);
+    auto counters = generator->counters();
+    EXPECT_EQ(counters.mPlaced, settings.mFigures);
+    EXPECT_GT(counters.mScheduled, 50u);
+    EXPECT_EQ(counters.mCompleted, counters.mIssued);
+    EXPECT_EQ(board->statistic().outcomeTime(BoardStatistic::Outcome::removed).count()
+              + board->statistic().outcomeTime(BoardStatistic::Outcome::placed).count(), 2 * settings.mFigures);
+}
+
+TEST(LoadGeneratorTest, unansweredPlacementsTimeOut)
+{
+    OpenLoopSettings settings;
+    settings.mFigures = 2;
+    settings.mDuration = 100ms;
+    settings.mDrainTimeout = 50ms;
+    auto generator = std::make_shared<LoadGenerator>(std::make_shared<OccupiedBoard>(), settings);
+    auto started = std::chrono::steady_clock::now();
+    generator->startGame();
+    generator->waitEnd();
+
+    EXPECT_LT(std::chrono::steady_clock::now() - started, 2s);
+    auto counters = generator->counters();
+    EXPECT_EQ(counters.mPlaced, 0u);
+    EXPECT_EQ(counters.mScheduled, 0u);
+    EXPECT_EQ(counters.mIssued, 0u);
+}
+
+TEST(LoadGeneratorTest, invalidSettings)
+{
+    auto board = std::make_shared<SlowBoard>(0ms);
+    OpenLoopSettings settings;
+    settings.mRate = 0;
+    EXPECT_THROW(LoadGenerator(board, settings), std::invalid_argument);
+    settings.mRate = 10;
+    settings.mFigures = 64;
+    EXPECT_THROW(LoadGenerator(board, settings), std::invalid_argument);
+}
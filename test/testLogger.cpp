@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+#include "Logger.h"
+
+using namespace board;
+
+static std::size_t countRecords(const std::string &out)
+{
+    std::size_t result = 0;
+    for (auto pos = out.find("ID:"); pos != std::string::npos; pos = out.find("ID:", pos + 1))
+    {
+        ++result;
+    }
+    return result;
+}
+
+TEST(LoggerTest, unboundedKeepsEverything)
+{
+    std::stringstream out;
+    auto logger = std::make_shared<Logger>(out);
+    INotifier &notifier = *logger;
+    for (std::uint32_t id = 1; id <= 10; ++id)
+    {
+        notifier.placed(id, {0, 0});
+    }
+    logger->startGame();
+    logger->stopGame();
+
+    EXPECT_EQ(countRecords(out.str()), 10);
+    EXPECT_EQ(logger->statistic().mDropped, 0);
+    EXPECT_EQ(logger->statistic().mDelayed, 0);
+}
+
+TEST(LoggerTest, dropNewest)
+{
+    std::stringstream out;
+    auto logger = std::make_shared<Logger>(out, 2, Logger::OverloadPolicy::dropNewest);
+    INotifier &notifier = *logger;
+    for (std::uint32_t id = 1; id <= 5; ++id)
+    {
+        notifier.placed(id, {0, 0});
+    }
+    EXPECT_EQ(logger->statistic().mDropped, 3);
+
+    logger->startGame();
+    logger->stopGame();
+    EXPECT_EQ(countRecords(out.str()), 2);
+    EXPECT_NE(out.str().find("ID: 1 "), std::string::npos);
+    EXPECT_NE(out.str().find("ID: 2 "), std::string::npos);
+}
+
+TEST(LoggerTest, dropOldest)
+{
+    std::stringstream out;
+    auto logger = std::make_shared<Logger>(out, 2, Logger::OverloadPolicy::dropOldest);
+    INotifier &notifier = *logger;
+    for (std::uint32_t id = 1; id <= 5; ++id)
+    {
+        notifier.placed(id, {0, 0});
+    }
+    EXPECT_EQ(logger->statistic().mDropped, 3);
+
+    logger->startGame();
+    logger->stopGame();
+    EXPECT_EQ(countRecords(out.str()), 2);
+    EXPECT_NE(out.str().find("ID: 4 "), std::string::npos);
+    EXPECT_NE(out.str().find("ID: 5 "), std::string::npos);
+}
+
+TEST(LoggerTest, sample)
+{
+    std::stringstream out;
+    auto logger = std::make_shared<Logger>(out, 1, Logger::OverloadPolicy::sample, 3);
+    INotifier &notifier = *logger;
+    for (std::uint32_t id = 1; id <= 7; ++id)
+    {
+        notifier.placed(id, {0, 0});
+    }
+    // 1 is queued, 2..7 overflow: every third of them (4 and 7) replaces the queued one
+    EXPECT_EQ(logger->statistic().mDropped, 6);
+
+    logger->startGame();
+    logger->stopGame();
+    EXPECT_EQ(countRecords(out.str()), 1);
+    EXPECT_NE(out.str().find("ID: 7 "), std::string::npos);
+}
+
+TEST(LoggerTest, blockDelaysProducer)
+{
+    using namespace std::chrono;
+    std::stringstream out;
+    auto logger = std::make_shared<Logger>(out, 1, Logger::OverloadPolicy::block);
+    INotifier &notifier = *logger;
+
+    notifier.placed(1, {0, 0});
+    std::thread starter([&]() {
+        std::this_thread::sleep_for(50ms);
+        logger->startGame();
+    });
+    notifier.placed(2, {0, 0});
+    starter.join();
+    logger->stopGame();
+
+    EXPECT_EQ(countRecords(out.str()), 2);
+    EXPECT_EQ(logger->statistic().mDropped, 0);
+    EXPECT_EQ(logger->statistic().mDelayed, 1);
+}
+
+TEST(LoggerTest, batchLargerThanBlockingQueue)
+{
+    std::stringstream out;
+    auto logger = std::make_shared<Logger>(out, 2, Logger::OverloadPolicy::block);
+    INotifier &notifier = *logger;
+    std::vector<BoardEvent> events;
+    for (std::uint32_t id = 1; id <= 5; ++id)
+    {
+        events.push_back({id, BoardEvent::Type::moved, ReasonReject::empty, {0, 0}, {0, 1}});
+    }
+    events.push_back({6, BoardEvent::Type::reject, ReasonReject::pathBlocked, invalidCoordinate, invalidCoordinate});
+    logger->startGame();
+    // the printer is woken before the batch waits for space, or the batch would wait forever
+    notifier.onEvents(events.data(), events.size());
+    logger->stopGame();
+
+    EXPECT_EQ(countRecords(out.str()), 6);
+    EXPECT_EQ(logger->statistic().mDropped, 0);
+    EXPECT_NE(out.str().find("ID: 5 A0 -> A1"), std::string::npos);
+    EXPECT_NE(out.str().find("ID: 6 XX pathBlocked"), std::string::npos);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "MappedFileSink.h"
+
+class MappedFileSinkTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char pattern[] = "/tmp/chess_sink_XXXXXX";
+        mDirectory = ::mkdtemp(pattern);
+        mPrefix = mDirectory + "/log";
+    }
+
+    void TearDown() override
+    {
+        for (std::size_t i = 1; i < 100; ++i)
+        {
+            ::unlink(segment(i).c_str());
+        }
+        ::rmdir(mDirectory.c_str());
+    }
+
+    std::string segment(std::size_t index) const
+    {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), ".%06zu.log", index);
+        return mPrefix + suffix;
+    }
+
+    std::vector<std::string> readSegments() const
+    {
+        std::vector<std::string> result;
+        for (std::size_t i = 1;; ++i)
+        {
+            std::ifstream in(segment(i));
+            if (!in)
+            {
+                break;
+            }
+            std::stringstream content;
+            content << in.rdbuf();
+            result.push_back(content.str());
+        }
+        return result;
+    }
+
+    std::string mDirectory;
+    std::string mPrefix;
+};
+
+TEST_F(MappedFileSinkTest, rotateBySize)
+{
+    std::string expected;
+    {
+        MappedFileSink sink(mPrefix, 64);
+        for (int i = 0; i < 20; ++i)
+        {
+            sink << "ID: " << i << " record" << std::endl;
+            expected += "ID: " + std::to_string(i) + " record\n";
+        }
+        EXPECT_TRUE(sink.good());
+    }
+
+    auto segments = readSegments();
+    ASSERT_GT(segments.size(), 1);
+    std::string joined;
+    for (auto &content: segments)
+    {
+        EXPECT_LE(content.size(), 64);
+        ASSERT_FALSE(content.empty());
+        EXPECT_EQ(content.back(), '\n');
+        joined += content;
+    }
+    EXPECT_EQ(joined, expected);
+}
+
+TEST_F(MappedFileSinkTest, rotateByTime)
+{
+    using namespace std::chrono;
+    {
+        MappedFileSink sink(mPrefix, 4096, 10ms);
+        sink << "first" << std::endl;
+        std::this_thread::sleep_for(20ms);
+        // the segment is closed by the first flush after the period has elapsed
+        sink << "second" << std::endl;
+        sink << "third" << std::endl;
+    }
+
+    auto segments = readSegments();
+    ASSERT_EQ(segments.size(), 2);
+    EXPECT_EQ(segments[0], "first\nsecond\n");
+    EXPECT_EQ(segments[1], "third\n");
+}
+
+TEST_F(MappedFileSinkTest, keepLastSegments)
+{
+    {
+        MappedFileSink sink(mPrefix, 16, MappedFileBuf::sNoRotatePeriod, 2);
+        for (int i = 0; i < 10; ++i)
+        {
+            sink << "record " << i << std::endl;
+        }
+    }
+
+    EXPECT_NE(::access(segment(1).c_str(), F_OK), 0);
+    std::ifstream last(segment(10));
+    std::string line;
+    std::getline(last, line);
+    EXPECT_EQ(line, "record 9");
+}
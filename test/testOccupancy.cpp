@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <thread>
+
+#include "FastRandom.h"
+#include "MoveTable.h"
+#include "Occupancy.h"
+#include "SlidingAttacks.h"
+
+using chessman::ChessmanType;
+
+TEST(OccupancyTest, magicAttacksMatchRayWalk)
+{
+    Xoshiro256 random(3);
+    for (std::int32_t square = 0; square < 64; ++square)
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            auto occupancy = random() & random();
+            EXPECT_EQ(chessman::rookAttacks(square, occupancy), chessman::slowRookAttacks(square, occupancy));
+            EXPECT_EQ(chessman::bishopAttacks(square, occupancy), chessman::slowBishopAttacks(square, occupancy));
+        }
+    }
+    // an empty a1 rook sees its whole row and column
+    EXPECT_EQ(__builtin_popcountll(chessman::rookAttacks(0, 0)), 14);
+}
+
+TEST(OccupancyTest, pathClearOnBitboardAndLines)
+{
+    for (std::int32_t size: {8, 20})
+    {
+        Occupancy occupancy(size);
+        EXPECT_EQ(occupancy.isBitboard(), size <= 8);
+        occupancy.set({2, 2});
+        occupancy.set({2, 5});
+        EXPECT_TRUE(occupancy.test({2, 5}));
+        EXPECT_FALSE(occupancy.test({5, 2}));
+
+        // row 2: the figure on {2, 5} blocks the way further along, the cell itself stays reachable
+        EXPECT_TRUE(occupancy.pathClear(ChessmanType::rook, {2, 2}, {2, 5}));
+        EXPECT_FALSE(occupancy.pathClear(ChessmanType::rook, {2, 2}, {2, 7}));
+        EXPECT_FALSE(occupancy.pathClear(ChessmanType::queen, {2, 7}, {2, 0}));
+        EXPECT_TRUE(occupancy.pathClear(ChessmanType::rook, {2, 2}, {7, 2}));
+
+        occupancy.set({4, 4});
+        EXPECT_FALSE(occupancy.pathClear(ChessmanType::bishop, {2, 2}, {6, 6}));
+        EXPECT_TRUE(occupancy.pathClear(ChessmanType::bishop, {2, 2}, {4, 4}));
+        occupancy.set({3, 5});
+        EXPECT_FALSE(occupancy.pathClear(ChessmanType::queen, {4, 4}, {1, 7}));
+        EXPECT_TRUE(occupancy.pathClear(ChessmanType::knight, {2, 2}, {3, 4}));
+        EXPECT_TRUE(occupancy.pathClear(ChessmanType::king, {2, 2}, {3, 3}));
+
+        occupancy.reset({4, 4});
+        EXPECT_TRUE(occupancy.pathClear(ChessmanType::bishop, {2, 2}, {6, 6}));
+    }
+}
+
+TEST(OccupancyTest, destinationsMatchPathChecks)
+{
+    Xoshiro256 random(7);
+    for (std::int32_t size: {5, 8, 20})
+    {
+        Occupancy occupancy(size);
+        for (std::int32_t i = 0; i < size * size / 3; ++i)
+        {
+            occupancy.set({static_cast<std::int8_t>(boundedRandom(random, size)), static_cast<std::int8_t>(boundedRandom(random, size))});
+        }
+        for (auto type: {ChessmanType::rook, ChessmanType::bishop, ChessmanType::queen, ChessmanType::knight, ChessmanType::king})
+        {
+            for (auto blocking: {false, true})
+            {
+                board::Coordinate from{static_cast<std::int8_t>(boundedRandom(random, size)), static_cast<std::int8_t>(boundedRandom(random, size))};
+                std::vector<board::Coordinate> expected, actual;
+                for (std::int8_t x = 0; x < size; ++x)
+                {
+                    for (std::int8_t y = 0; y < size; ++y)
+                    {
+                        board::Coordinate to{x, y};
+                        if (chessman::canMove(type, x - from.first, y - from.second) && !occupancy.test(to)
+                            && (!blocking || occupancy.pathClear(type, from, to)))
+                        {
+                            expected.push_back(to);
+                        }
+                    }
+                }
+                occupancy.destinations(type, from, blocking, actual);
+                std::sort(actual.begin(), actual.end());
+                EXPECT_EQ(actual, expected) << "size " << size << " piece " << static_cast<int>(type);
+            }
+        }
+    }
+}
+
+TEST(OccupancyTest, sampleDestinationCoversFreeCells)
+{
+    Xoshiro256 random(11);
+    for (std::int32_t size: {5, 8, 20})
+    {
+        Occupancy occupancy(size);
+        for (std::int32_t i = 0; i < size * size / 3; ++i)
+        {
+            occupancy.set({static_cast<std::int8_t>(boundedRandom(random, size)), static_cast<std::int8_t>(boundedRandom(random, size))});
+        }
+        board::Coordinate from{2, 2};
+        occupancy.reset(from);
+        std::vector<board::Coordinate> expected;
+        occupancy.destinations(ChessmanType::queen, from, true, expected);
+        ASSERT_FALSE(expected.empty());
+
+        std::set<board::Coordinate> sampled;
+        for (int i = 0; i < 2000; ++i)
+        {
+            board::Coordinate to;
+            ASSERT_TRUE(occupancy.sampleDestination(ChessmanType::queen, from, true, static_cast<std::uint32_t>(random()), to));
+            sampled.insert(to);
+        }
+        EXPECT_EQ(sampled, std::set<board::Coordinate>(expected.begin(), expected.end())) << "size " << size;
+    }
+
+    // a king in a corner walled in by three figures has nowhere to go
+    Occupancy occupancy(8);
+    occupancy.set({0, 1});
+    occupancy.set({1, 0});
+    occupancy.set({1, 1});
+    board::Coordinate to;
+    EXPECT_FALSE(occupancy.sampleDestination(ChessmanType::king, {0, 0}, true, 0, to));
+}
+
+TEST(OccupancyTest, readersSeeEveryMoveWhole)
+{
+    for (std::int32_t size: {8, 20})
+    {
+        // a figure going back and forth between {0, 5} and {5, 0}, both on the lines of a rook on {0, 0}
+        Occupancy occupancy(size);
+        occupancy.set({0, 5});
+        std::atomic<bool> stop{false};
+        std::thread board([&]() {
+            for (int i = 0; i < 20000; ++i)
+            {
+                i % 2 ? occupancy.move({5, 0}, {0, 5}) : occupancy.move({0, 5}, {5, 0});
+            }
+            stop = true;
+        });
+        std::vector<board::Coordinate> destinations;
+        std::size_t reads = 0, torn = 0;
+        while (!stop || !reads)
+        {
+            occupancy.destinations(ChessmanType::rook, {0, 0}, false, destinations);
+            torn += destinations.size() != static_cast<std::size_t>(2 * (size - 1) - 1);
+            ++reads;
+        }
+        board.join();
+        EXPECT_EQ(torn, 0u) << "size " << size << ", " << reads << " reads";
+    }
+}
@@ -0,0 +1,507 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "BoardServer.h"
+#include "ChessManImpl.h"
+#include "PartitionedChessBoard.h"
+#include "RemoteChessBoard.h"
+
+using namespace board;
+
+namespace {
+
+class RecordingNotifier : public INotifier
+{
+public:
+    void placed(std::uint32_t, const Coordinate &) noexcept override {}
+    void moved(std::uint32_t, const Coordinate &, const Coordinate &) noexcept override {}
+    void cancelMoved(std::uint32_t, const Coordinate &, const Coordinate &) noexcept override {}
+    void removed(std::uint32_t, const Coordinate &) noexcept override {}
+    void waitingForCell(std::uint32_t, const Coordinate &, const Coordinate &) noexcept override {}
+    void reject(std::uint32_t, ReasonReject) noexcept override {}
+
+    void onEvents(const BoardEvent *events, std::size_t count) noexcept override
+    {
+        std::lock_guard lock(mMutex);
+        mEvents.insert(mEvents.end(), events, events + count);
+        ++mBatches;
+        mChanged.notify_all();
+    }
+
+    // true once `count` events of the figure arrived, false after a second
+    bool waitFor(std::uint32_t id, std::size_t count)
+    {
+        std::unique_lock lock(mMutex);
+        return mChanged.wait_for(lock, std::chrono::seconds(1), [&]() {
+            return eventsOf(id).size() >= count;
+        });
+    }
+
+    std::vector<BoardEvent> eventsOf(std::uint32_t id) const
+    {
+        std::vector<BoardEvent> result;
+        for (auto &event: mEvents)
+        {
+            if (event.mId == id)
+            {
+                result.push_back(event);
+            }
+        }
+        return result;
+    }
+
+    std::vector<BoardEvent> snapshot(std::uint32_t id)
+    {
+        std::lock_guard lock(mMutex);
+        return eventsOf(id);
+    }
+
+    std::size_t batches()
+    {
+        std::lock_guard lock(mMutex);
+        return mBatches;
+    }
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mChanged;
+    std::vector<BoardEvent> mEvents;
+    std::size_t mBatches = 0;
+};
+
+class NullPeer : public IHandOffPeer
+{
+public:
+    void handOff(const HandOff &) noexcept override {}
+};
+
+// sends the frames on a connection of its own, true when the server closes it within a second
+bool closedAfter(const std::string &path, const std::vector<wire::Request> &requests)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    auto fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    timeval timeout{1, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    ::send(fd, requests.data(), requests.size() * sizeof(wire::Request), MSG_NOSIGNAL);
+    char buffer[256];
+    ssize_t received;
+    while ((received = ::recv(fd, buffer, sizeof(buffer), 0)) > 0)
+    {
+
+    }
+    ::close(fd);
+    return received == 0;
+}
+
+wire::Request hello(wire::Subscription subscription, std::uint32_t token = 0)
+{
+    wire::Request request{};
+    request.mOp = wire::Op::hello;
+    request.mArgument = static_cast<std::uint32_t>(subscription);
+    request.mFigureId = token;
+    return request;
+}
+
+wire::Request handOffRequest(std::uint8_t type, const Coordinate &to)
+{
+    wire::Request request{};
+    request.mOp = wire::Op::handOff;
+    request.mFigureId = 7;
+    request.mHandOff = type;
+    request.mFrom[0] = 1;
+    request.mFrom[1] = 1;
+    request.mTo[0] = to.first;
+    request.mTo[1] = to.second;
+    return request;
+}
+
+std::vector<BoardEvent::Type> types(const std::vector<BoardEvent> &events)
+{
+    std::vector<BoardEvent::Type> result;
+    for (auto &event: events)
+    {
+        result.push_back(event.mType);
+    }
+    return result;
+}
+
+}
+
+class RemoteBoardTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        mPath = "/tmp/chess_board_" + std::to_string(::getpid()) + ".sock";
+        mBoard = std::make_shared<ChessBoardImpl>(8);
+        mBoard->startGame();
+        mServer = std::make_shared<BoardServer>(mPath, mBoard);
+        mServer->startGame();
+    }
+
+    void TearDown() override
+    {
+        mServer->stopGame();
+        mBoard->stopGame();
+    }
+
+    std::shared_ptr<RemoteChessBoard> connect(wire::Subscription subscription = wire::Subscription::ownFigures)
+    {
+        auto remote = std::make_shared<RemoteChessBoard>(mPath, subscription);
+        auto notifier = std::make_shared<RecordingNotifier>();
+        remote->addNotifier(notifier);
+        mNotifiers.push_back(notifier);
+        return remote;
+    }
+
+    std::string mPath;
+    std::shared_ptr<ChessBoardImpl> mBoard;
+    std::shared_ptr<BoardServer> mServer;
+    std::vector<std::shared_ptr<RecordingNotifier>> mNotifiers;
+};
+
+TEST_F(RemoteBoardTest, commandsAndQueries)
+{
+    auto remote = connect();
+    auto &notifier = *mNotifiers.back();
+    EXPECT_EQ(remote->sizeBoard(), 8);
+    ChessManImpl first(1, chessman::ChessmanType::rook), second(2, chessman::ChessmanType::rook);
+
+    remote->placeFigure(first, {0, 0});
+    remote->placeFigure(second, {0, 0});
+    ASSERT_TRUE(notifier.waitFor(1, 1));
+    ASSERT_TRUE(notifier.waitFor(2, 1));
+    EXPECT_EQ(notifier.snapshot(1)[0].mType, BoardEvent::Type::placed);
+    EXPECT_EQ(notifier.snapshot(2)[0].mType, BoardEvent::Type::waitingForCell);
+    first.setCurrentCoordinate({0, 0});
+
+    std::vector<Coordinate> destinations;
+    remote->legalDestinations(first, destinations);
+    EXPECT_EQ(destinations.size(), 14u);
+    Coordinate to = invalidCoordinate;
+    EXPECT_TRUE(remote->sampleDestination(first, 0, to));
+    EXPECT_NE(to, Coordinate(0, 0));
+
+    remote->removeFigure(first);
+    ASSERT_TRUE(notifier.waitFor(1, 2));
+    ASSERT_TRUE(notifier.waitFor(2, 2));
+    EXPECT_EQ(notifier.snapshot(1)[1].mType, BoardEvent::Type::removed);
+    auto granted = notifier.snapshot(2)[1];
+    EXPECT_EQ(granted.mType, BoardEvent::Type::placed);
+    EXPECT_EQ(granted.mTo, Coordinate(0, 0));
+}
+
+TEST_F(RemoteBoardTest, eventsGoToOwnerAndSubscribers)
+{
+    auto own = connect();
+    auto other = connect();
+    auto all = connect(wire::Subscription::allEvents);
+    ChessManImpl first(1, chessman::ChessmanType::rook), second(2, chessman::ChessmanType::rook);
+    own->placeFigure(first, {1, 1});
+    other->placeFigure(second, {2, 2});
+
+    ASSERT_TRUE(mNotifiers[2]->waitFor(1, 1));
+    ASSERT_TRUE(mNotifiers[2]->waitFor(2, 1));
+    ASSERT_TRUE(mNotifiers[0]->waitFor(1, 1));
+    ASSERT_TRUE(mNotifiers[1]->waitFor(2, 1));
+    EXPECT_TRUE(mNotifiers[0]->snapshot(2).empty());
+    EXPECT_TRUE(mNotifiers[1]->snapshot(1).empty());
+}
+
+TEST_F(RemoteBoardTest, closedConnectionLeavesTheBoard)
+{
+    auto leaving = connect();
+    ChessManImpl first(1, chessman::ChessmanType::rook), second(2, chessman::ChessmanType::rook);
+    leaving->placeFigure(first, {3, 3});
+    ASSERT_TRUE(mNotifiers.back()->waitFor(1, 1));
+    leaving.reset();
+
+    auto staying = connect();
+    staying->placeFigure(second, {3, 3});
+    ASSERT_TRUE(mNotifiers.back()->waitFor(2, 1));
+    auto events = mNotifiers.back()->snapshot(2);
+    if (events.front().mType == BoardEvent::Type::waitingForCell)
+    {   // the place overtook the removal of the first figure
+        ASSERT_TRUE(mNotifiers.back()->waitFor(2, 2));
+        events = mNotifiers.back()->snapshot(2);
+    }
+    EXPECT_EQ(events.back().mType, BoardEvent::Type::placed);
+}
+
+TEST_F(RemoteBoardTest, pipelinedMovesArriveInOrder)
+{
+    static constexpr std::size_t count = 20000;
+    auto remote = connect();
+    auto &notifier = *mNotifiers.back();
+    ChessManImpl figure(1, chessman::ChessmanType::rook);
+    remote->placeFigure(figure, {0, 0});
+    figure.setCurrentCoordinate({0, 0});
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        Coordinate to{0, static_cast<std::int8_t>((i + 1) % 8)};
+        remote->moveFigure(figure, to);
+        figure.setCurrentCoordinate(to);
+    }
+    ASSERT_TRUE(notifier.waitFor(1, count + 1));
+    auto events = notifier.snapshot(1);
+    auto ordered = true;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        ordered = ordered && events[i + 1].mType == BoardEvent::Type::moved
+                  && events[i + 1].mTo == Coordinate(0, static_cast<std::int8_t>((i + 1) % 8));
+    }
+    EXPECT_TRUE(ordered);
+    EXPECT_LT(notifier.batches(), count);
+}
+
+TEST_F(RemoteBoardTest, lostServerAnswersBoardStopped)
+{
+    auto remote = connect();
+    auto &notifier = *mNotifiers.back();
+    mServer->stopGame();
+    ChessManImpl figure(1, chessman::ChessmanType::rook);
+    for (int i = 0; i < 100 && remote->connected(); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_FALSE(remote->connected());
+    remote->placeFigure(figure, {0, 0});
+    ASSERT_TRUE(notifier.waitFor(1, 1));
+    EXPECT_EQ(notifier.snapshot(1)[0].mReason, ReasonReject::boardStopped);
+    Coordinate to;
+    EXPECT_FALSE(remote->sampleDestination(figure, 0, to));
+    EXPECT_THROW(RemoteChessBoard(mPath + ".missing"), std::system_error);
+}
+
+TEST(PartitionTest, rowsAndValidation)
+{
+    Partition layout{0, 3, 8};
+    EXPECT_EQ(layout.firstRow(1), 2);
+    EXPECT_EQ(layout.firstRow(2), 5);
+    EXPECT_EQ(layout.owner({1, 7}), 0);
+    EXPECT_EQ(layout.owner({4, 0}), 1);
+    EXPECT_EQ(layout.owner({5, 0}), 2);
+    EXPECT_EQ(layout.owner({7, 7}), 2);
+    EXPECT_EQ(partitionPaths("/tmp/rooks", 2), (std::vector<std::string>{"/tmp/rooks.0", "/tmp/rooks.1"}));
+
+    auto peer = std::make_shared<NullPeer>();
+    EXPECT_THROW(ChessBoardImpl(8, true).setPartition({0, 2, 8}, peer), std::invalid_argument);
+    EXPECT_THROW(ChessBoardImpl(8).setPartition({2, 2, 8}, peer), std::invalid_argument);
+    EXPECT_THROW(ChessBoardImpl(8).setPartition({0, 9, 8}, peer), std::invalid_argument);
+    EXPECT_THROW(ChessBoardImpl(8).setPartition({0, 2, 8}, nullptr), std::invalid_argument);
+    EXPECT_THROW(BoardServer(partitionPaths("/tmp/rooks", 9), 0, std::make_shared<ChessBoardImpl>(8)),
+                 std::invalid_argument);
+}
+
+// a board of 8 rows in two partitions served in this process, rows 0..3 and 4..7
+class PartitionedBoardTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        auto paths = partitionPaths("/tmp/chess_partition_" + std::to_string(::getpid()), 2);
+        for (std::uint8_t partition = 0; partition < 2; ++partition)
+        {
+            mBoards.push_back(std::make_shared<ChessBoardImpl>(8));
+            mServers.push_back(std::make_shared<BoardServer>(paths, partition, mBoards.back()));
+        }
+        for (std::size_t partition = 0; partition < 2; ++partition)
+        {
+            mBoards[partition]->startGame();
+            mServers[partition]->startGame();
+        }
+        mBoard = std::make_unique<PartitionedChessBoard>(paths);
+        mNotifier = std::make_shared<RecordingNotifier>();
+        mBoard->addNotifier(mNotifier);
+    }
+
+    void TearDown() override
+    {
+        mBoard.reset();
+        for (auto &server: mServers)
+        {
+            server->stopGame();
+        }
+        for (auto &board: mBoards)
+        {
+            board->stopGame();
+        }
+    }
+
+    std::vector<std::shared_ptr<ChessBoardImpl>> mBoards;
+    std::vector<std::shared_ptr<BoardServer>> mServers;
+    std::unique_ptr<PartitionedChessBoard> mBoard;
+    std::shared_ptr<RecordingNotifier> mNotifier;
+};
+
+TEST_F(PartitionedBoardTest, crossingMoveToFreeCell)
+{
+    ChessManImpl figure(1, chessman::ChessmanType::rook);
+    mBoard->placeFigure(figure, {1, 1});
+    figure.setCurrentCoordinate({1, 1});
+    mBoard->moveFigure(figure, {6, 1});
+    ASSERT_TRUE(mNotifier->waitFor(1, 2));
+    figure.setCurrentCoordinate({6, 1});
+    mBoard->moveFigure(figure, {6, 2});
+    ASSERT_TRUE(mNotifier->waitFor(1, 3));
+    figure.setCurrentCoordinate({6, 2});
+
+    auto events = mNotifier->snapshot(1);
+    EXPECT_EQ(types(events), (std::vector<BoardEvent::Type>{BoardEvent::Type::placed, BoardEvent::Type::moved,
+                                                            BoardEvent::Type::moved}));
+    EXPECT_EQ(events[1].mFrom, Coordinate(1, 1));
+    EXPECT_EQ(events[1].mTo, Coordinate(6, 1));
+    std::vector<Coordinate> destinations;
+    mBoard->legalDestinations(figure, destinations);
+    EXPECT_EQ(destinations.size(), 14u);
+
+    mBoard->removeFigure(figure);
+    ASSERT_TRUE(mNotifier->waitFor(1, 4));
+    EXPECT_EQ(mNotifier->snapshot(1)[3].mType, BoardEvent::Type::removed);
+
+    // the hand-off messages are not operations of their own
+    auto recorded = [this](BoardStatistic::Operation operation) {
+        return mBoards[0]->statistic().serviceTime(operation).count()
+               + mBoards[1]->statistic().serviceTime(operation).count();
+    };
+    EXPECT_EQ(recorded(BoardStatistic::Operation::place), 1u);
+    EXPECT_EQ(recorded(BoardStatistic::Operation::move), 2u);
+    EXPECT_EQ(recorded(BoardStatistic::Operation::cancelMove), 0u);
+    EXPECT_EQ(recorded(BoardStatistic::Operation::remove), 1u);
+}
+
+TEST_F(PartitionedBoardTest, crossingMoveWaitsForTheCell)
+{
+    ChessManImpl mover(1, chessman::ChessmanType::rook), holder(2, chessman::ChessmanType::rook),
+                 follower(3, chessman::ChessmanType::rook);
+    mBoard->placeFigure(holder, {6, 1});
+    mBoard->placeFigure(mover, {1, 1});
+    ASSERT_TRUE(mNotifier->waitFor(2, 1));
+    ASSERT_TRUE(mNotifier->waitFor(1, 1));
+    holder.setCurrentCoordinate({6, 1});
+    mover.setCurrentCoordinate({1, 1});
+    mBoard->placeFigure(follower, {1, 1});
+    mBoard->moveFigure(mover, {6, 1});
+    ASSERT_TRUE(mNotifier->waitFor(1, 2));
+    ASSERT_TRUE(mNotifier->waitFor(3, 1));
+
+    // the holder leaves, the mover takes its cell and hands its own to the follower
+    mBoard->removeFigure(holder);
+    ASSERT_TRUE(mNotifier->waitFor(1, 3));
+    ASSERT_TRUE(mNotifier->waitFor(3, 2));
+    auto moves = mNotifier->snapshot(1);
+    EXPECT_EQ(types(moves), (std::vector<BoardEvent::Type>{BoardEvent::Type::placed, BoardEvent::Type::waitingForCell,
+                                                           BoardEvent::Type::moved}));
+    EXPECT_EQ(moves[1].mTo, Coordinate(6, 1));
+    EXPECT_EQ(moves[2].mTo, Coordinate(6, 1));
+    EXPECT_EQ(types(mNotifier->snapshot(3)),
+              (std::vector<BoardEvent::Type>{BoardEvent::Type::waitingForCell, BoardEvent::Type::placed}));
+}
+
+TEST_F(PartitionedBoardTest, cancelledOrRemovedWaiterGetsNoCell)
+{
+    ChessManImpl cancelling(1, chessman::ChessmanType::rook), removed(2, chessman::ChessmanType::rook),
+                 holder(3, chessman::ChessmanType::rook), newcomer(4, chessman::ChessmanType::rook);
+    mBoard->placeFigure(holder, {6, 1});
+    mBoard->placeFigure(cancelling, {1, 1});
+    mBoard->placeFigure(removed, {2, 2});
+    ASSERT_TRUE(mNotifier->waitFor(1, 1));
+    ASSERT_TRUE(mNotifier->waitFor(2, 1));
+    ASSERT_TRUE(mNotifier->waitFor(3, 1));
+    holder.setCurrentCoordinate({6, 1});
+    cancelling.setCurrentCoordinate({1, 1});
+    removed.setCurrentCoordinate({2, 2});
+    mBoard->moveFigure(cancelling, {6, 1});
+    mBoard->moveFigure(removed, {6, 1});
+    ASSERT_TRUE(mNotifier->waitFor(1, 2));
+    ASSERT_TRUE(mNotifier->waitFor(2, 2));
+
+    mBoard->cancelMoveFigure(cancelling, {6, 1});
+    mBoard->removeFigure(removed);
+    ASSERT_TRUE(mNotifier->waitFor(1, 3));
+    ASSERT_TRUE(mNotifier->waitFor(2, 3));
+    EXPECT_EQ(mNotifier->snapshot(1)[2].mType, BoardEvent::Type::cancelMoved);
+    EXPECT_EQ(mNotifier->snapshot(2)[2].mType, BoardEvent::Type::removed);
+
+    // the cell goes to the removed figure's waiter entry first, its source aborts the hand-off
+    mBoard->removeFigure(holder);
+    mBoard->placeFigure(newcomer, {6, 1});
+    ASSERT_TRUE(mNotifier->waitFor(4, 1));
+    if (mNotifier->snapshot(4)[0].mType == BoardEvent::Type::waitingForCell)
+    {
+        ASSERT_TRUE(mNotifier->waitFor(4, 2));
+    }
+    EXPECT_EQ(mNotifier->snapshot(4).back().mType, BoardEvent::Type::placed);
+    EXPECT_EQ(mNotifier->snapshot(1).size(), 3u);
+    EXPECT_EQ(mNotifier->snapshot(2).size(), 3u);
+}
+
+TEST_F(PartitionedBoardTest, malformedOrForeignHandOffsCloseTheConnection)
+{
+    auto prepare = static_cast<std::uint8_t>(HandOff::Type::prepare);
+    auto path = mServers[1]->path();
+    // a client may not hand off, a forged prepare must not reserve the cell
+    EXPECT_TRUE(closedAfter(path, {hello(wire::Subscription::ownFigures), handOffRequest(prepare, {6, 1})}));
+    EXPECT_TRUE(closedAfter(path, {handOffRequest(prepare, {6, 1})}));
+    // links name another partition of the board
+    EXPECT_TRUE(closedAfter(path, {hello(wire::Subscription::partitionLink, 1)}));
+    EXPECT_TRUE(closedAfter(path, {hello(wire::Subscription::partitionLink, 2)}));
+    EXPECT_TRUE(closedAfter(path, {hello(static_cast<wire::Subscription>(3))}));
+    // a link with a hand-off type beyond cancelled
+    EXPECT_TRUE(closedAfter(path, {hello(wire::Subscription::partitionLink, 0),
+                                   handOffRequest(static_cast<std::uint8_t>(HandOff::Type::cancelled) + 1, {6, 1})}));
+    EXPECT_TRUE(closedAfter(path, {hello(wire::Subscription::partitionLink, 0), handOffRequest(255, {6, 1})}));
+
+    ChessManImpl figure(1, chessman::ChessmanType::rook);
+    mBoard->placeFigure(figure, {6, 1});
+    ASSERT_TRUE(mNotifier->waitFor(1, 1));
+    EXPECT_EQ(mNotifier->snapshot(1)[0].mType, BoardEvent::Type::placed);
+}
+
+TEST_F(RemoteBoardTest, handOffsNeedAPartitionedServer)
+{
+    EXPECT_TRUE(closedAfter(mPath, {hello(wire::Subscription::partitionLink, 1)}));
+    EXPECT_TRUE(closedAfter(mPath, {hello(wire::Subscription::ownFigures),
+                                    handOffRequest(static_cast<std::uint8_t>(HandOff::Type::prepare), {5, 5})}));
+    EXPECT_FALSE(closedAfter(mPath, {hello(wire::Subscription::ownFigures)}));
+}
+
+TEST_F(RemoteBoardTest, unknownPieceClosesTheConnection)
+{
+    for (auto op: {wire::Op::place, wire::Op::move, wire::Op::legalDestinations, wire::Op::sampleDestination})
+    {
+        wire::Request request{};
+        request.mOp = op;
+        request.mFigureId = 1;
+        request.mPiece = static_cast<std::uint8_t>(chessman::ChessmanType::king) + 1;
+        request.mTo[0] = 2;
+        request.mTo[1] = 2;
+        EXPECT_TRUE(closedAfter(mPath, {hello(wire::Subscription::ownFigures), request}));
+        request.mPiece = 200;
+        EXPECT_TRUE(closedAfter(mPath, {hello(wire::Subscription::ownFigures), request}));
+    }
+
+    auto remote = connect();
+    ChessManImpl figure(1, chessman::ChessmanType::king);
+    remote->placeFigure(figure, {2, 2});
+    ASSERT_TRUE(mNotifiers.back()->waitFor(1, 1));
+    EXPECT_EQ(mNotifiers.back()->snapshot(1)[0].mType, BoardEvent::Type::placed);
+}
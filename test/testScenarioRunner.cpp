@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "ScenarioRunner.h"
+
+TEST(ScenarioRunnerTest, parseSweep)
+{
+    EXPECT_EQ(ScenarioRunner::parseSweep("1..16"), (std::vector<std::size_t>{1, 2, 4, 8, 16}));
+    EXPECT_EQ(ScenarioRunner::parseSweep("10..30:10,64"), (std::vector<std::size_t>{10, 20, 30, 64}));
+    EXPECT_EQ(ScenarioRunner::parseSweep("3"), (std::vector<std::size_t>{3}));
+    EXPECT_THROW(ScenarioRunner::parseSweep("8..4"), std::invalid_argument);
+    EXPECT_THROW(ScenarioRunner::parseSweep("1..x"), std::invalid_argument);
+    EXPECT_THROW(ScenarioRunner::parseSweep("-1"), std::invalid_argument);
+}
+
+TEST(ScenarioRunnerTest, parseOptionsAndConfig)
+{
+    const char *argv[] = {"ChessRook", "--participants", "1..4", "--board=16", "--delay-step", "0:5", "--no-statistic"};
+    auto scenario = ScenarioRunner::parse(7, argv);
+    EXPECT_EQ(scenario.mParticipants, (std::vector<std::size_t>{1, 2, 4}));
+    EXPECT_EQ(scenario.mSizeBoards, (std::vector<std::size_t>{16}));
+    EXPECT_EQ(scenario.mGame.mRules.mDelayNextStepMin.count(), 0);
+    EXPECT_EQ(scenario.mGame.mRules.mDelayNextStepMax.count(), 5);
+    EXPECT_FALSE(scenario.mGame.mDumpStatistic);
+    EXPECT_TRUE(scenario.mGame.mLogEnabled);
+
+    std::istringstream config("# capacity sweep\nsteps = 7\nlog none   # quiet\n\ndelay-confirm 3\npieces knight,queen\n"
+                              "board-cpus 0,2\nparticipant-stack 64\nboard-capacity 32\nboard-overload reject\n"
+                              "board-drain weighted:3\nevent-bus rooks:1024\nserve /tmp/rooks.sock\npartition 1/4\n");
+    ScenarioRunner::parseConfig(config, scenario);
+    EXPECT_EQ(scenario.mSteps, 7u);
+    EXPECT_EQ(scenario.mGame.mRules.mPieces,
+              (std::vector<chessman::ChessmanType>{chessman::ChessmanType::knight, chessman::ChessmanType::queen}));
+    EXPECT_FALSE(scenario.mGame.mLogEnabled);
+    EXPECT_EQ(scenario.mGame.mRules.mDelayConfirm.count(), 3);
+    EXPECT_EQ(scenario.mGame.mBoardThread.mCpus, (std::vector<std::size_t>{0, 2}));
+    EXPECT_EQ(scenario.mGame.mParticipantThread.mStackSize, 64u << 10u);
+    EXPECT_EQ(scenario.mGame.mBoardCapacity, 32u);
+    EXPECT_EQ(scenario.mGame.mBoardPolicy, ChessBoardImpl::OverloadPolicy::reject);
+    EXPECT_EQ(scenario.mGame.mBoardDrain, ChessBoardImpl::DrainPolicy::weighted);
+    EXPECT_EQ(scenario.mGame.mEventBusName, "rooks");
+    EXPECT_EQ(scenario.mGame.mEventBusCapacity, 1024u);
+    EXPECT_EQ(scenario.mGame.mBoardUrgentWeight, 3u);
+    EXPECT_EQ(scenario.mServe, "/tmp/rooks.sock");
+    EXPECT_EQ(scenario.mPartition, 1u);
+    EXPECT_EQ(scenario.mPartitions, 4u);
+
+    const char *unknown[] = {"ChessRook", "--unknown", "1"};
+    EXPECT_THROW(ScenarioRunner::parse(3, unknown), std::invalid_argument);
+    const char *board[] = {"ChessRook", "--board", "1"};
+    EXPECT_THROW(ScenarioRunner::parse(3, board), std::invalid_argument);
+    const char *pieces[] = {"ChessRook", "--pieces", "rook,pawn"};
+    EXPECT_THROW(ScenarioRunner::parse(3, pieces), std::invalid_argument);
+    const char *cpus[] = {"ChessRook", "--board-cpus", "1,x"};
+    EXPECT_THROW(ScenarioRunner::parse(3, cpus), std::invalid_argument);
+    const char *overload[] = {"ChessRook", "--board-overload", "drop"};
+    EXPECT_THROW(ScenarioRunner::parse(3, overload), std::invalid_argument);
+    const char *drain[] = {"ChessRook", "--board-drain", "weighted:0"};
+    EXPECT_THROW(ScenarioRunner::parse(3, drain), std::invalid_argument);
+    const char *bus[] = {"ChessRook", "--event-bus", "rooks:1000"};
+    EXPECT_THROW(ScenarioRunner::parse(3, bus), std::invalid_argument);
+    const char *serve[] = {"ChessRook", "--serve="};
+    EXPECT_THROW(ScenarioRunner::parse(2, serve), std::invalid_argument);
+    const char *partition[] = {"ChessRook", "--partition", "4/4"};
+    EXPECT_THROW(ScenarioRunner::parse(3, partition), std::invalid_argument);
+}
+
+TEST(ScenarioRunnerTest, runSweep)
+{
+    Scenario scenario;
+    scenario.mParticipants = {1, 3};
+    scenario.mSizeBoards = {4};
+    scenario.mSteps = 5;
+    scenario.mGame.mLogEnabled = false;
+    scenario.mGame.mDumpStatistic = false;
+    scenario.mGame.mRules.mDelayNextStepMin = std::chrono::milliseconds(0);
+    scenario.mGame.mRules.mDelayNextStepMax = std::chrono::milliseconds(1);
+    scenario.mGame.mRules.mDelayConfirm = std::chrono::milliseconds(10);
+    scenario.mGame.mRules.mPieces = {chessman::ChessmanType::rook, chessman::ChessmanType::knight,
+                                     chessman::ChessmanType::bishop};
+
+    std::ostringstream report;
+    auto results = ScenarioRunner(scenario).run(report);
+    GameRules::configure({});
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].mParticipants, 1u);
+    EXPECT_EQ(results[0].mSizeBoard, 4);
+    EXPECT_EQ(results[0].mMoves, 5u);
+    EXPECT_EQ(results[1].mMoves, 15u);
+    for (auto &result: results)
+    {
+        EXPECT_GE(result.mRequests, result.mMoves);
+        EXPECT_GT(result.movesPerSecond(), 0.0);
+        EXPECT_GT(result.mCpuTime.count(), 0);
+    }
+    EXPECT_NE(report.str().find("moves/s"), std::string::npos);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <thread>
+
+#include "ChessBoardImpl.h"
+#include "ChessManImpl.h"
+#include "GameRules.h"
+#include "StepStrategy.h"
+
+static bool isRookMove(const board::Coordinate &from, const board::Coordinate &to, std::int32_t sizeBoard)
+{
+    return from != to && (from.first == to.first || from.second == to.second)
+           && to.first >= 0 && to.second >= 0 && to.first < sizeBoard && to.second < sizeBoard;
+}
+
+TEST(StepStrategyTest, hotCellIsReachedInTwoSteps)
+{
+    auto strategy = makeStepStrategy("cell:5,2@1", 8);
+    ChessManImpl figure(1, chessman::ChessmanType::rook);
+    for (std::size_t i = 0; i < 200; ++i)
+    {
+        figure.setCurrentCoordinate(strategy->firstStep());
+        for (auto step = 0; step < 2 && figure.getCurrentCoordinate() != board::Coordinate{5, 2}; ++step)
+        {
+            auto to = strategy->nextStep(figure);
+            ASSERT_TRUE(isRookMove(figure.getCurrentCoordinate(), to, 8));
+            figure.setCurrentCoordinate(to);
+        }
+        EXPECT_EQ(figure.getCurrentCoordinate(), (board::Coordinate{5, 2}));
+        // standing on the hot cell the figure has to leave it
+        EXPECT_TRUE(isRookMove({5, 2}, strategy->nextStep(figure), 8));
+    }
+}
+
+TEST(StepStrategyTest, rowAndZipfStayOnBoard)
+{
+    for (auto spec: {"row:7", "zipf", "zipf:2.5"})
+    {
+        auto strategy = makeStepStrategy(spec, 8);
+        ChessManImpl figure(1, chessman::ChessmanType::rook);
+        figure.setCurrentCoordinate(strategy->firstStep());
+        std::map<board::Coordinate, std::size_t> visits;
+        for (std::size_t i = 0; i < 5000; ++i)
+        {
+            auto to = strategy->nextStep(figure);
+            ASSERT_TRUE(isRookMove(figure.getCurrentCoordinate(), to, 8)) << spec;
+            figure.setCurrentCoordinate(to);
+            ++visits[to];
+        }
+        if (std::string(spec) == "zipf:2.5")
+        {   // rank 0 is the hottest cell by far
+            EXPECT_GT(visits[board::Coordinate(0, 0)], 1000u);
+        }
+    }
+}
+
+TEST(StepStrategyTest, specs)
+{
+    EXPECT_EQ(makeStepStrategy("uniform", 8), nullptr);
+    EXPECT_NE(makeStepStrategy("cell", 8), nullptr);
+    EXPECT_NE(makeStepStrategy("row:3", 8), nullptr);
+    EXPECT_NE(makeStepStrategy("zipf:1.5@0.5", 8), nullptr);
+    EXPECT_NE(makeStepStrategy("cell@0.5", 8), nullptr);
+    EXPECT_THROW(makeStepStrategy("row@1.5", 8), std::invalid_argument);
+    EXPECT_THROW(makeStepStrategy("cell:8,0", 8), std::invalid_argument);
+    EXPECT_THROW(makeStepStrategy("cell:1", 8), std::invalid_argument);
+    EXPECT_THROW(makeStepStrategy("zipf:-1", 8), std::invalid_argument);
+    EXPECT_THROW(makeStepStrategy("diagonal", 8), std::invalid_argument);
+    EXPECT_NE(makeStepStrategy("free", 8), nullptr);
+    EXPECT_THROW(makeStepStrategy("free@0.5", 8), std::invalid_argument);
+}
+
+TEST(StepStrategyTest, installedIntoGameRules)
+{
+    GameRules::Settings settings;
+    settings.mStepStrategy = makeStepStrategy("cell:0,0@1", settings.mSizeBoard);
+    GameRules::configure(settings);
+
+    ChessManImpl figure(1, chessman::ChessmanType::rook);
+    figure.setCurrentCoordinate({0, 6});
+    EXPECT_EQ(GameRules::generateStep(figure), (board::Coordinate{0, 0}));
+    GameRules::configure({});
+}
+
+TEST(StepStrategyTest, freeCellStepAvoidsOccupiedCells)
+{
+    auto board = std::make_shared<ChessBoardImpl>(8);
+    board->startGame();
+    ChessManImpl rook(1, chessman::ChessmanType::rook);
+    board->placeFigure(rook, {0, 0});
+    rook.setCurrentCoordinate({0, 0});
+    std::vector<std::unique_ptr<ChessManImpl>> blockers;
+    auto block = [&](board::Coordinate cell) {
+        blockers.push_back(std::make_unique<ChessManImpl>(blockers.size() + 2, chessman::ChessmanType::rook));
+        board->placeFigure(*blockers.back(), cell);
+    };
+    // the whole row and all of the column but {7, 0}
+    for (std::int8_t i = 1; i < 8; ++i)
+    {
+        block({0, i});
+        if (i < 7)
+        {
+            block({i, 0});
+        }
+    }
+    std::vector<board::Coordinate> destinations;
+    for (int i = 0; i < 100 && destinations.size() != 1; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        board->legalDestinations(rook, destinations);
+    }
+    ASSERT_EQ(destinations, (std::vector<board::Coordinate>{{7, 0}}));
+
+    FreeCellStep strategy(8);
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(strategy.nextStepOnBoard(rook, *board), (board::Coordinate{7, 0}));
+    }
+
+    // nothing free: the uniform move, the figure will wait for its cell
+    block({7, 0});
+    for (int i = 0; i < 100 && !destinations.empty(); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        board->legalDestinations(rook, destinations);
+    }
+    ASSERT_TRUE(destinations.empty());
+    EXPECT_TRUE(isRookMove({0, 0}, strategy.nextStepOnBoard(rook, *board), 8));
+    board->stopGame();
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
+
+#include "Tracer.h"
+
+TEST(TracerTest, disabledRecordsNothing)
+{
+    EXPECT_FALSE(Tracer::instance().enabled());
+    {
+        Tracer::Scope scope("ignored");
+    }
+    EXPECT_FALSE(Tracer::instance().dump());
+}
+
+TEST(TracerTest, dumpChromeJson)
+{
+    char path[] = "/tmp/chess_trace_XXXXXX";
+    ::close(::mkstemp(path));
+
+    auto &tracer = Tracer::instance();
+    tracer.enable(path);
+    std::thread worker([&]() {
+        tracer.setThreadName("worker");
+        Tracer::Scope scope("worker span");
+    });
+    worker.join();
+    {
+        Tracer::Scope scope("main span");
+    }
+    EXPECT_TRUE(tracer.dump());
+    EXPECT_FALSE(tracer.enabled());
+
+    std::ifstream in(path);
+    std::stringstream content;
+    content << in.rdbuf();
+    ::unlink(path);
+
+    auto json = content.str();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0);
+    EXPECT_NE(json.find("\"name\":\"worker span\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"main span\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"worker "), std::string::npos);
+}
+
+TEST(TracerTest, dumpWhileThreadsStillTrace)
+{
+    char path[] = "/tmp/chess_trace_XXXXXX";
+    ::close(::mkstemp(path));
+
+    auto &tracer = Tracer::instance();
+    tracer.enable(path);
+    std::atomic<bool> stop{false};
+    std::thread worker([&]() {
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            Tracer::Scope scope("late span");
+        }
+    });
+    // the worker still ends spans while they are written, like a board thread not yet joined
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_TRUE(tracer.dump());
+    stop = true;
+    worker.join();
+
+    std::ifstream in(path);
+    std::stringstream content;
+    content << in.rdbuf();
+    ::unlink(path);
+    EXPECT_NE(content.str().find("\"name\":\"late span\""), std::string::npos);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <dirent.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "ChessBoardImpl.h"
+#include "Game.h"
+#include "TreadBase.h"
+
+namespace {
+
+// records what the thread itself sees of its attributes
+class ProbeThread : public TreadBase
+{
+public:
+    ProbeThread()
+        : TreadBase("ProbeThread")
+        , mStackSize(0)
+        , mCpus()
+    {
+
+    }
+
+    ~ProbeThread() override
+    {
+        TreadBase::join();
+    }
+
+    void run()
+    {
+        TreadBase::start();
+        TreadBase::join();
+    }
+
+    std::size_t mStackSize;
+    cpu_set_t mCpus;
+
+protected:
+    void loop() override
+    {
+        pthread_attr_t attr;
+        pthread_getattr_np(pthread_self(), &attr);
+        pthread_attr_getstacksize(&attr, &mStackSize);
+        pthread_attr_destroy(&attr);
+        CPU_ZERO(&mCpus);
+        sched_getaffinity(0, sizeof(mCpus), &mCpus);
+    }
+};
+
+std::size_t countThreads()
+{
+    std::size_t count = 0;
+    if (auto dir = ::opendir("/proc/self/task"))
+    {
+        while (auto entry = ::readdir(dir))
+        {
+            count += entry->d_name[0] != '.';
+        }
+        ::closedir(dir);
+    }
+    return count;
+}
+
+}
+
+TEST(TreadBaseTest, stackSizeAndAffinity)
+{
+    ProbeThread probe;
+    ThreadAttributes attributes;
+    attributes.mStackSize = 128u << 10u;
+    attributes.mCpus = {0};
+    probe.setAttributes(attributes);
+    probe.run();
+    EXPECT_GE(probe.mStackSize, attributes.mStackSize);
+    EXPECT_LT(probe.mStackSize, 1u << 20u);
+    EXPECT_EQ(CPU_COUNT(&probe.mCpus), 1);
+    EXPECT_TRUE(CPU_ISSET(0, &probe.mCpus));
+}
+
+TEST(TreadBaseTest, refusedAttributesThrow)
+{
+    ProbeThread probe;
+    ThreadAttributes attributes;
+    attributes.mCpus = {CPU_SETSIZE};
+    probe.setAttributes(attributes);
+    EXPECT_THROW(probe.run(), std::invalid_argument);
+
+    attributes.mCpus.clear();
+    attributes.mPolicy = SCHED_FIFO;
+    attributes.mPriority = 1000; // beyond sched_get_priority_max for any policy
+    probe.setAttributes(attributes);
+    EXPECT_THROW(probe.run(), std::system_error);
+}
+
+TEST(TreadBaseTest, gameWithSmallParticipantStacks)
+{
+    GameSettings settings;
+    settings.mRules.mDelayNextStepMin = std::chrono::milliseconds(0);
+    settings.mRules.mDelayNextStepMax = std::chrono::milliseconds(1);
+    settings.mLogEnabled = false;
+    settings.mDumpStatistic = false;
+    settings.mBoardThread.mCpus = {0};
+    settings.mParticipantThread.mStackSize = 64u << 10u;
+    Game game(8, 5, settings);
+    game.startGame();
+    game.waitEnd();
+    GameRules::configure({});
+    EXPECT_EQ(game.board()->statistic().outcomeTime(BoardStatistic::Outcome::moved).count(), 8u * 5u);
+}
+
+TEST(TreadBaseTest, gameTakesDownParticipantsWhenOneCannotStart)
+{
+    GameSettings settings;
+    settings.mLogEnabled = false;
+    settings.mDumpStatistic = false;
+    settings.mParticipantThread.mStackSize = 256u << 20u;
+    Game game(4, 5, settings);
+
+    // room for the board and the first participant stack only, the second one fails
+    std::size_t pages = 0;
+    std::ifstream("/proc/self/statm") >> pages;
+    rlimit previous{};
+    ::getrlimit(RLIMIT_AS, &previous);
+    rlimit limited = previous;
+    limited.rlim_cur = pages * static_cast<rlim_t>(::sysconf(_SC_PAGESIZE)) + (384u << 20u);
+    ASSERT_EQ(::setrlimit(RLIMIT_AS, &limited), 0);
+    auto threads = countThreads();
+    EXPECT_THROW(game.startGame(), std::system_error);
+    ::setrlimit(RLIMIT_AS, &previous);
+
+    // the started participant left instead of waiting on the start barrier for the missing ones
+    for (auto i = 0; i < 100 && countThreads() > threads; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(countThreads(), threads);
+    game.stopGame();
+    GameRules::configure({});
+}